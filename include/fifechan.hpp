@@ -67,6 +67,7 @@
 
 #include <fifechan/actionevent.hpp>
 #include <fifechan/actionlistener.hpp>
+#include <fifechan/cachedfont.hpp>
 #include <fifechan/cliprectangle.hpp>
 #include <fifechan/color.hpp>
 #include <fifechan/containerevent.hpp>
@@ -74,10 +75,14 @@
 #include <fifechan/deathlistener.hpp>
 #include <fifechan/event.hpp>
 #include <fifechan/exception.hpp>
+#include <fifechan/filteredlistmodel.hpp>
 #include <fifechan/focushandler.hpp>
 #include <fifechan/focuslistener.hpp>
 #include <fifechan/font.hpp>
 #include <fifechan/genericinput.hpp>
+#include <fifechan/geometrycache.hpp>
+#include <fifechan/graphdatalistener.hpp>
+#include <fifechan/graphdatasource.hpp>
 #include <fifechan/graphics.hpp>
 #include <fifechan/gui.hpp>
 #include <fifechan/image.hpp>
@@ -90,14 +95,25 @@
 #include <fifechan/keyinput.hpp>
 #include <fifechan/keylistener.hpp>
 #include <fifechan/listmodel.hpp>
+#include <fifechan/listmodellistener.hpp>
+#include <fifechan/minmaxpyramid.hpp>
 #include <fifechan/mouseevent.hpp>
 #include <fifechan/mouseinput.hpp>
 #include <fifechan/mouselistener.hpp>
 #include <fifechan/point.hpp>
+#include <fifechan/rangeset.hpp>
+#include <fifechan/recordinggraphics.hpp>
 #include <fifechan/rectangle.hpp>
+#include <fifechan/ringbufferdatasource.hpp>
 #include <fifechan/selectionevent.hpp>
 #include <fifechan/selectionlistener.hpp>
 #include <fifechan/size.hpp>
+#include <fifechan/sortedlistmodel.hpp>
+#include <fifechan/tablecellrenderer.hpp>
+#include <fifechan/tablemodel.hpp>
+#include <fifechan/tablemodellistener.hpp>
+#include <fifechan/treemodel.hpp>
+#include <fifechan/treemodellistener.hpp>
 #include <fifechan/widget.hpp>
 #include <fifechan/widgetlistener.hpp>
 #include <fifechan/widgets/adjustingcontainer.hpp>
@@ -123,10 +139,12 @@
 #include <fifechan/widgets/spacer.hpp>
 #include <fifechan/widgets/radiobutton.hpp>
 #include <fifechan/widgets/tab.hpp>
+#include <fifechan/widgets/table.hpp>
 #include <fifechan/widgets/tabbedarea.hpp>
 #include <fifechan/widgets/textbox.hpp>
 #include <fifechan/widgets/textfield.hpp>
 #include <fifechan/widgets/togglebutton.hpp>
+#include <fifechan/widgets/treeview.hpp>
 #include <fifechan/widgets/window.hpp>
 
 #include "fifechan/platform.hpp"
@@ -0,0 +1,199 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_CACHEDFONT_HPP
+#define FCN_CACHEDFONT_HPP
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+#include "fifechan/font.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * A font which remembers the widths of strings measured with another
+     * font. Widths are requested over and over for the same strings, by
+     * Graphics::drawText for aligned text and by widgets adjusting their
+     * size, and for True Type fonts every request is a full layout pass.
+     *
+     * The widths of the most recently measured strings are kept in a
+     * hash table, bounded by a capacity. When the capacity is reached the
+     * least recently used width is dropped. All widths are dropped when
+     * the revision of the wrapped font changes, for instance because its
+     * glyph spacing was changed.
+     *
+     * A single CachedFont can be shared by all widgets, for instance by
+     * passing it to Widget::setGlobalFont.
+     *
+     * @code
+     * fcn::ImageFont font("font.png", " abcdefghijklmnopqrstuvwxyz");
+     * fcn::CachedFont cachedFont(&font);
+     * fcn::Widget::setGlobalFont(&cachedFont);
+     * @endcode
+     *
+     * @see Font::getRevision
+     */
+    class FCN_CORE_DECLSPEC CachedFont : public Font
+    {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param font The font to measure and draw strings with. The font
+         *             is not owned by the cached font.
+         * @param capacity The maximum number of widths to keep.
+         * @throws Exception if the font is NULL.
+         */
+        CachedFont(Font* font, unsigned int capacity = 1024);
+
+        /**
+         * Destructor.
+         */
+        virtual ~CachedFont();
+
+        /**
+         * Sets the font to measure and draw strings with, and drops all
+         * widths.
+         *
+         * @param font The font, not owned by the cached font.
+         * @throws Exception if the font is NULL.
+         */
+        void setFont(Font* font);
+
+        /**
+         * Gets the font strings are measured and drawn with.
+         *
+         * @return The font.
+         */
+        Font* getFont() const;
+
+        /**
+         * Sets the maximum number of widths to keep. Default is 1024.
+         *
+         * @param capacity The maximum number of widths.
+         */
+        void setCapacity(unsigned int capacity);
+
+        /**
+         * Gets the maximum number of widths to keep.
+         *
+         * @return The maximum number of widths.
+         */
+        unsigned int getCapacity() const;
+
+        /**
+         * Gets the number of widths currently kept.
+         *
+         * @return The number of widths.
+         */
+        unsigned int getSize() const;
+
+        /**
+         * Drops all widths.
+         */
+        void clear();
+
+        /**
+         * Gets the number of widths found in the cache.
+         *
+         * @return The number of hits.
+         */
+        unsigned int getHits() const;
+
+        /**
+         * Gets the number of widths which had to be measured.
+         *
+         * @return The number of misses.
+         */
+        unsigned int getMisses() const;
+
+        /**
+         * Gets the share of widths found in the cache.
+         *
+         * @return The hit rate from 0 to 1, 0 if nothing was measured yet.
+         */
+        float getHitRate() const;
+
+        /**
+         * Sets the hit and miss counters to zero.
+         */
+        void resetStatistics();
+
+
+        // Inherited from Font
+
+        virtual int getWidth(const std::string& text) const;
+
+        virtual int getHeight() const;
+
+        virtual int getStringIndexAt(const std::string& text, int x) const;
+
+        virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
+
+        virtual void drawString
+(Graphics* graphics, const std::string& text, int x, int y);
+
+        /**
+         * Changes with the revision of the wrapped font and when the
+         * wrapped font is replaced.
+         */
+        virtual unsigned int getRevision() const;
+
+    protected:
+        /**
+         * Drops the least recently used widths until at most a number of
+         * widths are kept.
+         *
+         * @param size The number of widths to keep.
+         */
+        void shrink(unsigned int size) const;
+
+        typedef std::list<std::pair<std::string, int> > EntryList;
+        typedef std::unordered_map<std::string, EntryList::iterator> EntryIndex;
+
+        Font* mFont;
+        unsigned int mCapacity;
+
+        /**
+         * The revision of the wrapped font the widths were measured with.
+         */
+        mutable unsigned int mFontRevision;
+
+        /**
+         * The widths, most recently used first.
+         */
+        mutable EntryList mEntries;
+        mutable EntryIndex mIndex;
+
+        mutable unsigned int mHits;
+        mutable unsigned int mMisses;
+    };
+}
+
+#endif // end FCN_CACHEDFONT_HPP
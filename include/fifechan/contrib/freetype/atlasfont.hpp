@@ -0,0 +1,304 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_CONTRIB_ATLASFONT_HPP
+#define FCN_CONTRIB_ATLASFONT_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "fifechan/color.hpp"
+#include "fifechan/font.hpp"
+#include "fifechan/platform.hpp"
+
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+namespace fcn
+{
+    class Graphics;
+    class Image;
+
+    namespace contrib
+    {
+        /**
+         * True Type Font implementation of Font using FreeType. Glyphs are
+         * rasterized on demand and packed into a few large atlas pages, and
+         * strings are drawn as one Graphics::drawImage call per glyph from
+         * these pages. Drawing text therefore only binds a texture per page
+         * instead of rendering and uploading a surface per string.
+         *
+         * Text is expected to be UTF-8 encoded. Strings which are not valid
+         * UTF-8 are treated as Latin-1. Kerning is applied if the font
+         * provides it.
+         *
+         * The pages are turned into images of the backend by
+         * createPageImage, which subclasses implement. As most backends do
+         * not tint images, one set of page images is kept per text color,
+         * for a limited number of recently used colors.
+         *
+         * @see OpenGLAtlasFont, SDLAtlasFont
+         */
+        class FCN_EXTENSION_DECLSPEC AtlasFont : public Font
+        {
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param filename the filename of the font.
+             * @param size the size of the font in pixels.
+             * @param pageSize the width and height of the atlas pages.
+             * @throws Exception if the font could not be loaded.
+             */
+            AtlasFont(const std::string& filename, int size, int pageSize = 256);
+
+            /**
+             * Destructor.
+             */
+            virtual ~AtlasFont();
+
+            /**
+             * Sets the spacing between rows in pixels. Default is 0 pixels.
+             * The spacing can be negative.
+             *
+             * @param spacing the spacing in pixels.
+             */
+            virtual void setRowSpacing(int spacing);
+
+            /**
+             * Gets the spacing between rows in pixels.
+             *
+             * @return the spacing.
+             */
+            virtual int getRowSpacing();
+
+            /**
+             * Sets the spacing between letters in pixels. Default is 0
+             * pixels. The spacing can be negative.
+             *
+             * @param spacing the spacing in pixels.
+             */
+            virtual void setGlyphSpacing(int spacing);
+
+            /**
+             * Gets the spacing between letters in pixels.
+             *
+             * @return the spacing.
+             */
+            virtual int getGlyphSpacing();
+
+            /**
+             * Sets the use of anti aliasing. Changing it clears the atlas.
+             *
+             * @param antiAlias true for use of antialiasing.
+             */
+            virtual void setAntiAlias(bool antiAlias);
+
+            /**
+             * Checks if anti aliasing is used.
+             *
+             * @return true if anti aliasing is used.
+             */
+            virtual bool isAntiAlias();
+
+            /**
+             * Sets the use of kerning. Default is true. Kerning is only
+             * applied if the font provides it.
+             *
+             * @param kerning true for use of kerning.
+             */
+            virtual void setKerning(bool kerning);
+
+            /**
+             * Checks if kerning is used.
+             *
+             * @return true if kerning is used.
+             */
+            virtual bool isKerning();
+
+            /**
+             * Sets the number of text colors page images are kept for.
+             * Default is 8. When a new color is drawn and the limit is
+             * reached, the images of the least recently used color are
+             * deleted.
+             *
+             * @param colors the number of colors.
+             */
+            virtual void setMaxColors(unsigned int colors);
+
+            /**
+             * Gets the number of text colors page images are kept for.
+             *
+             * @return the number of colors.
+             */
+            virtual unsigned int getMaxColors() const;
+
+            /**
+             * Gets the number of atlas pages in use.
+             *
+             * @return the number of pages.
+             */
+            int getPageCount() const;
+
+            /**
+             * Removes all glyphs from the atlas and deletes the page images.
+             */
+            virtual void clearAtlas();
+
+
+            // Inherited from Font
+
+            virtual int getWidth(const std::string& text) const;
+
+            virtual int getHeight() const;
+
+            virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
+
+            virtual void drawString(Graphics* graphics, const std::string& text, int x, int y);
+
+        protected:
+
+            /**
+             * Creates an image of the backend from the pixels of a page.
+             *
+             * @param pixels the RGBA pixels of the page, 8 bits per
+             *               component in that byte order, not premultiplied.
+             * @param width the width of the page.
+             * @param height the height of the page.
+             * @return a new image, owned by the font.
+             */
+            virtual Image* createPageImage(const unsigned char* pixels, int width, int height) = 0;
+
+            /**
+             * Holds the metrics of a glyph and its place in the atlas.
+             */
+            struct Glyph
+            {
+                unsigned int index;
+                int page;
+                int x;
+                int y;
+                int width;
+                int height;
+                int left;
+                int top;
+                int advance;
+            };
+
+            /**
+             * Holds the images of all pages for one text color.
+             */
+            struct PageImages
+            {
+                std::vector<Image*> images;
+                std::vector<unsigned int> versions;
+                unsigned int lastUsed;
+            };
+
+            /**
+             * Gets a glyph, rasterizing it into the atlas if needed.
+             *
+             * @param character the unicode code point of the glyph.
+             * @return the glyph.
+             * @throws Exception if the glyph could not be rasterized.
+             */
+            const Glyph& getGlyph(unsigned int character) const;
+
+            /**
+             * Decodes text into unicode code points.
+             *
+             * @param text the UTF-8 or Latin-1 text.
+             * @param characters receives the code points.
+             */
+            static void decode(const std::string& text, std::vector<unsigned int>& characters);
+
+            /**
+             * Gets the kerning between two glyphs.
+             *
+             * @param left the index of the left glyph.
+             * @param right the index of the right glyph.
+             * @return the kerning in pixels.
+             */
+            int getKerning(unsigned int left, unsigned int right) const;
+
+            /**
+             * Gets the page images of a color, creating or updating the
+             * images of pages which changed since they were last used.
+             *
+             * @param color the color of the text.
+             * @return the page images.
+             */
+            PageImages& getPageImages(const Color& color);
+
+            /**
+             * Deletes the images of a color.
+             *
+             * @param images the images to delete.
+             */
+            static void deletePageImages(PageImages& images);
+
+            FT_LibraryRec_* mLibrary;
+            FT_FaceRec_* mFace;
+            int mPageSize;
+            int mRowSpacing;
+            int mGlyphSpacing;
+            bool mAntiAlias;
+            bool mKerning;
+            unsigned int mMaxColors;
+            unsigned int mUseCounter;
+
+            /**
+             * The glyphs rasterized so far, by code point.
+             */
+            mutable std::map<unsigned int, Glyph> mGlyphs;
+
+            /**
+             * The coverage of every page, one byte per pixel.
+             */
+            mutable std::vector<std::vector<unsigned char> > mPages;
+
+            /**
+             * Incremented every time a glyph is added to a page.
+             */
+            mutable std::vector<unsigned int> mPageVersions;
+
+            /**
+             * The shelf glyphs are currently packed into on the last page.
+             */
+            mutable int mShelfX;
+            mutable int mShelfY;
+            mutable int mShelfHeight;
+
+            std::map<unsigned int, PageImages> mPageImages;
+
+            /**
+             * Scratch buffers reused by drawString and getPageImages.
+             */
+            std::vector<unsigned int> mCharacters;
+            std::vector<unsigned char> mPixels;
+        };
+    }
+}
+
+#endif // end FCN_CONTRIB_ATLASFONT_HPP
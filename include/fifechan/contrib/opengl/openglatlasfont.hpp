@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_CONTRIB_OPENGLATLASFONT_HPP
+#define FCN_CONTRIB_OPENGLATLASFONT_HPP
+
+#include <string>
+
+#include "fifechan/platform.hpp"
+#include "fifechan/contrib/freetype/atlasfont.hpp"
+
+namespace fcn
+{
+    namespace contrib
+    {
+        /**
+         * OpenGL implementation of AtlasFont. Every atlas page is an
+         * OpenGLImage, so a string costs one texture bind per page.
+         *
+         * NOTE: The OpenGL context must be current when the font draws.
+         */
+        class FCN_EXTENSION_DECLSPEC OpenGLAtlasFont : public AtlasFont
+        {
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param filename the filename of the font.
+             * @param size the size of the font in pixels.
+             * @param pageSize the width and height of the atlas pages.
+             * @throws Exception if the font could not be loaded.
+             */
+            OpenGLAtlasFont(const std::string& filename, int size, int pageSize = 256);
+
+        protected:
+            // Inherited from AtlasFont
+
+            virtual Image* createPageImage(const unsigned char* pixels, int width, int height);
+        };
+    }
+}
+
+#endif // end FCN_CONTRIB_OPENGLATLASFONT_HPP
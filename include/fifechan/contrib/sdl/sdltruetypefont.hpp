@@ -65,11 +65,14 @@
 #ifndef FCN_CONTRIB_SDLTRUETYPEFONT_HPP
 #define FCN_CONTRIB_SDLTRUETYPEFONT_HPP
 
+#include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <SDL_ttf.h>
 
+
 #include "fifechan/font.hpp"
 #include "fifechan/platform.hpp"
 
@@ -87,6 +90,11 @@ namespace fcn
          *       class. Also, remember to call the SDL_ttf libraries quit
          *       function.
          *
+         * Rendered text and measured widths are kept in a least recently
+         * used cache with a byte budget, so static text is only rendered
+         * once. Text which changes every frame is better cached per glyph,
+         * see setCacheMode.
+         *
          * @author Walluce Pinkham
          * @author Olof Naessn
          */
@@ -94,6 +102,25 @@ namespace fcn
         {
         public:
 
+            /**
+             * Ways of caching rendered text.
+             */
+            enum CacheMode
+            {
+                /**
+                 * Whole strings are rendered and cached. Best for static
+                 * text.
+                 */
+                CacheRuns = 0,
+
+                /**
+                 * Glyphs are rendered and cached one by one and strings are
+                 * put together from them. Best for text that changes often,
+                 * but kerning is not applied.
+                 */
+                CacheGlyphs
+            };
+
             /**
              * Constructor.
              *
@@ -151,6 +178,75 @@ namespace fcn
              */
             virtual bool isAntiAlias();
 
+            /**
+             * Sets the way rendered text is cached. Default is CacheRuns.
+             *
+             * @param mode the cache mode.
+             */
+            virtual void setCacheMode(CacheMode mode);
+
+            /**
+             * Gets the way rendered text is cached.
+             *
+             * @return the cache mode.
+             */
+            virtual CacheMode getCacheMode() const;
+
+            /**
+             * Sets the maximum number of bytes used by the cache of rendered
+             * text and measured widths. The least recently used entries are
+             * evicted when the budget is exceeded. Default is 4 MB, 0
+             * disables the cache.
+             *
+             * @param bytes the budget in bytes.
+             */
+            virtual void setCacheBudget(unsigned int bytes);
+
+            /**
+             * Gets the maximum number of bytes used by the cache.
+             *
+             * @return the budget in bytes.
+             */
+            virtual unsigned int getCacheBudget() const;
+
+            /**
+             * Gets the number of bytes currently used by the cache.
+             *
+             * @return the number of bytes used.
+             */
+            virtual unsigned int getCacheSize() const;
+
+            /**
+             * Removes all entries from the cache.
+             */
+            virtual void clearCache();
+
+            /**
+             * Gets the number of lookups found in the cache.
+             *
+             * @return the number of cache hits.
+             */
+            unsigned int getCacheHits() const;
+
+            /**
+             * Gets the number of lookups not found in the cache.
+             *
+             * @return the number of cache misses.
+             */
+            unsigned int getCacheMisses() const;
+
+            /**
+             * Gets the number of entries evicted to stay within the budget.
+             *
+             * @return the number of evictions.
+             */
+            unsigned int getCacheEvictions() const;
+
+            /**
+             * Sets the cache hit, miss and eviction counters to zero.
+             */
+            void resetCacheCounters();
+
 
             // Inherited from Font
 
@@ -158,9 +254,88 @@ namespace fcn
 
             virtual int getHeight() const;
 
+            virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
+
             virtual void drawString(Graphics* graphics, const std::string& text, int x, int y);
 
+
         protected:
+            /**
+             * Kinds of cache entries.
+             */
+            enum CacheKind
+            {
+                RunSurface = 0,
+                RunWidth,
+                GlyphSurface,
+                GlyphAdvance
+            };
+
+            /**
+             * Key of a cache entry.
+             */
+            struct CacheKey
+            {
+                CacheKind kind;
+                std::string text;
+                Uint32 color;
+                bool antiAlias;
+
+                bool operator<(const CacheKey& other) const;
+            };
+
+            /**
+             * A cache entry. Width entries have no surface.
+             */
+            struct CacheEntry
+            {
+                CacheKey key;
+                SDL_Surface* surface;
+                int x;
+                int width;
+                unsigned int size;
+            };
+
+            typedef std::list<CacheEntry> CacheList;
+            typedef std::map<CacheKey, CacheList::iterator> CacheIndex;
+
+            /**
+             * Looks up an entry and marks it as most recently used.
+             *
+             * @param key the key of the entry.
+             * @return the entry, NULL if it is not cached.
+             */
+            CacheEntry* findCacheEntry(const CacheKey& key) const;
+
+            /**
+             * Adds an entry to the cache, evicting the least recently used
+             * entries to stay within the budget. The cache owns the surface
+             * of the entry.
+             *
+             * @param key the key of the entry.
+             * @param surface the rendered surface, may be NULL.
+             * @param x the x offset of the surface.
+             * @param width the width of the entry.
+             * @return the entry, NULL if it does not fit in the budget.
+             */
+            CacheEntry* addCacheEntry(const CacheKey& key, SDL_Surface* surface, int x, int width) const;
+
+            /**
+             * Evicts the least recently used entries until the cache uses
+             * at most the given number of bytes.
+             *
+             * @param bytes the number of bytes the cache may use.
+             */
+            void shrinkCache(unsigned int bytes) const;
+
+            /**
+             * Gets the horizontal advance of a glyph.
+             *
+             * @param glyph the glyph.
+             * @return the advance of the glyph in pixels.
+             */
+            int getGlyphAdvance(unsigned char glyph) const;
+
             TTF_Font *mFont;
 
             int mHeight;
@@ -169,6 +344,19 @@ namespace fcn
 
             std::string mFilename;
             bool mAntiAlias;
+
+            CacheMode mCacheMode;
+            unsigned int mCacheBudget;
+            mutable unsigned int mCacheSize;
+            mutable unsigned int mCacheHits;
+            mutable unsigned int mCacheMisses;
+            mutable unsigned int mCacheEvictions;
+
+            /**
+             * Cache entries, most recently used first.
+             */
+            mutable CacheList mCacheList;
+            mutable CacheIndex mCacheIndex;
         };
     }
 }
@@ -110,6 +110,8 @@ namespace fcn
         virtual int getHeight() const;
 
         virtual int getStringIndexAt(const std::string& text, int x) const;
+
+        virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
     };
 }
 
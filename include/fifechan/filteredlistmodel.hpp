@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_FILTEREDLISTMODEL_HPP
+#define FCN_FILTEREDLISTMODEL_HPP
+
+#include <string>
+#include <vector>
+
+#include "fifechan/listmodel.hpp"
+#include "fifechan/listmodellistener.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * A list model showing the elements of another list model which match
+     * a filter, for instance to filter a ListBox while the user types. The
+     * model keeps the indices of the matching elements of the source model
+     * and tells its listeners which elements appeared and disappeared, so
+     * the source model doesn't have to be rebuilt.
+     *
+     * When the filter is extended, that is the new filter contains the old
+     * one, only the elements matching the old filter are tested again.
+     * Changes of the source model are applied to the affected range only,
+     * so the source model should tell its listeners about its changes.
+     *
+     * By default an element matches if it contains the filter, ignoring
+     * the case of ASCII letters.
+     */
+    class FCN_CORE_DECLSPEC FilteredListModel :
+        public ListModel,
+        public ListModelListener
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param sourceModel The list model to filter.
+         */
+        FilteredListModel(ListModel* sourceModel = NULL);
+
+        /**
+         * Destructor.
+         */
+        virtual ~FilteredListModel();
+
+        /**
+         * Sets the list model to filter.
+         *
+         * @param sourceModel The list model to filter.
+         * @see getSourceModel
+         */
+        void setSourceModel(ListModel* sourceModel);
+
+        /**
+         * Gets the list model being filtered.
+         *
+         * @return The list model being filtered.
+         * @see setSourceModel
+         */
+        ListModel* getSourceModel() const;
+
+        /**
+         * Sets the filter. An empty filter matches all elements.
+         *
+         * @param filter The filter.
+         * @see getFilter
+         */
+        void setFilter(const std::string& filter);
+
+        /**
+         * Gets the filter.
+         *
+         * @return The filter.
+         * @see setFilter
+         */
+        const std::string& getFilter() const;
+
+        /**
+         * Gets the index an element has in the source model.
+         *
+         * @param i An index in this model.
+         * @return The index of the element in the source model.
+         */
+        int getSourceIndex(int i) const;
+
+        /**
+         * Checks if an element matches a filter. Can be overridden to
+         * filter differently, but an element that doesn't match a filter
+         * must not match any filter containing it.
+         *
+         * @param element The element.
+         * @param filter The filter, never empty.
+         * @return True if the element matches the filter, false otherwise.
+         */
+        virtual bool matches(const std::string& element, const std::string& filter) const;
+
+
+        // Inherited from ListModel
+
+        virtual int getNumberOfElements();
+
+        virtual std::string getElementAt(int i);
+
+        virtual const std::string* getElementPointer(int i);
+
+
+        // Inherited from ListModelListener
+
+        virtual void elementsInserted(ListModel* model, int first, int count);
+
+        virtual void elementsRemoved(ListModel* model, int first, int count);
+
+        virtual void elementsChanged(ListModel* model, int first, int count);
+
+        virtual void listModelDeleted(ListModel* model);
+
+    protected:
+        /**
+         * Checks if an element of the source model matches the filter.
+         *
+         * @param index The index of the element in the source model.
+         * @return True if the element matches the filter, false otherwise.
+         */
+        bool matchesSourceElement(int index);
+
+        /**
+         * Replaces a range of the source indices and tells the listeners
+         * which elements were removed and inserted. The new indices are
+         * merged into a new vector in one pass. While the listeners are
+         * told about a run of removed or inserted elements, the model
+         * reads the merged indices followed by the old indices not merged
+         * yet, so it matches every notification. Both ranges must be
+         * sorted.
+         *
+         * @param position The position of the range in this model.
+         * @param count The number of indices to replace.
+         * @param indices The new indices.
+         */
+        void replaceIndices(int position, int count, const std::vector<int>& indices);
+
+        /**
+         * The list model being filtered.
+         */
+        ListModel* mSourceModel;
+
+        /**
+         * The filter.
+         */
+        std::string mFilter;
+
+        /**
+         * The indices of the matching elements in the source model, in
+         * increasing order.
+         */
+        std::vector<int> mIndices;
+
+        /**
+         * The indices merged so far while replaceIndices runs, empty
+         * otherwise.
+         */
+        std::vector<int> mMergedIndices;
+
+        /**
+         * The first index in mIndices not merged yet while replaceIndices
+         * runs, zero otherwise.
+         */
+        unsigned int mMergeTail;
+
+        /**
+         * Holds elements fetched from the source model.
+         */
+        std::string mElement;
+    };
+}
+
+#endif // end FCN_FILTEREDLISTMODEL_HPP
@@ -66,6 +66,7 @@
 #define FCN_FONT_HPP
 
 #include <string>
+#include <vector>
 #include "fifechan/platform.hpp"
 
 namespace fcn
@@ -81,6 +82,11 @@ namespace fcn
     {
     public:
 
+        /**
+         * Constructor.
+         */
+        Font() : mRevision(0) { }
+
         /**
          * Destructor.
          */
@@ -113,6 +119,24 @@ namespace fcn
          */
         virtual int getStringIndexAt(const std::string& text, int x) const;
 
+        /**
+         * Gets the widths of all prefixes of a string in one go. After the
+         * call widths holds text.size() + 1 entries, where entry i is the
+         * width of the first i bytes of the string. Bytes inside a multi
+         * byte character get the width of the prefix ending before the
+         * character, so the entries never decrease for fonts with positive
+         * advances and can be binary searched.
+         *
+         * The default implementation calls getWidth for every prefix.
+         * Fonts which lay out strings glyph by glyph should override it
+         * with a single pass over the string.
+         *
+         * @param text The string to get the prefix widths of.
+         * @param widths The vector to store the widths in.
+         * @see Text
+         */
+        virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
+
         /**
          * Draws a string.
          *
@@ -126,6 +150,28 @@ namespace fcn
          */
         virtual void drawString(Graphics* graphics, const std::string& text,
                                 int x, int y) = 0;
+
+        /**
+         * Gets the revision of the font metrics. The revision changes
+         * whenever a setting which affects the width of strings changes,
+         * such as the glyph spacing, so that cached widths can be dropped.
+         *
+         * @return The revision of the font metrics.
+         * @see CachedFont
+         */
+        virtual unsigned int getRevision() const { return mRevision; }
+
+    protected:
+        /**
+         * Marks the widths of strings as changed. Implementations call it
+         * whenever a setting which affects the width of strings changes.
+         */
+        void invalidateMetrics() { ++mRevision; }
+
+        /**
+         * Holds the revision of the font metrics.
+         */
+        unsigned int mRevision;
     };
 }
 
@@ -0,0 +1,353 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_GEOMETRYCACHE_HPP
+#define FCN_GEOMETRYCACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "fifechan/platform.hpp"
+#include "fifechan/point.hpp"
+
+namespace fcn
+{
+    /**
+     * Remembers the tessellation of circles, circle segments and Bezier
+     * curves, so that backends do not have to walk the same circle or
+     * evaluate the same curve on every frame. Widgets such as PieGraph
+     * and rounded decorations draw the same shapes over and over, only at
+     * other positions, and with the geometry cached drawing them costs
+     * little more than filling the spans.
+     *
+     * All geometry is relative to the center of the circle, or to the
+     * first control point of a Bezier curve, so a shape is tessellated
+     * once and can be drawn anywhere. Raster backends use the spans,
+     * outline pixels and polygons, hardware accelerated backends the
+     * triangle strips.
+     *
+     * The most recently used shapes are kept, bounded by a capacity. When
+     * the capacity is reached the least recently used shape is dropped.
+     * A cache is not thread safe, every Graphics object should use a cache
+     * of its own.
+     *
+     * @code
+     * const fcn::GeometryCache::Geometry& geometry = mGeometryCache.getFillCircle(radius);
+     *
+     * for (unsigned int i = 0; i < geometry.spans.size(); ++i)
+     * {
+     *     const fcn::GeometryCache::Span& span = geometry.spans[i];
+     *     drawSpan(cx + span.x1, cx + span.x2, cy + span.y);
+     * }
+     * @endcode
+     */
+    class FCN_CORE_DECLSPEC GeometryCache
+    {
+    public:
+
+        /**
+         * A horizontal run of pixels, relative to the origin of the shape.
+         */
+        struct Span
+        {
+            /**
+             * The row of the span.
+             */
+            int y;
+
+            /**
+             * The first column of the span, inclusive.
+             */
+            int x1;
+
+            /**
+             * The last column of the span, inclusive.
+             */
+            int x2;
+        };
+
+        typedef std::vector<Span> SpanVector;
+
+        /**
+         * The tessellation of a shape. Only the parts that make sense for
+         * the shape are filled in, see the getters of GeometryCache.
+         */
+        struct Geometry
+        {
+            /**
+             * The pixels of an outline, each pixel exactly once, or the
+             * vertices of the polyline of a Bezier curve.
+             */
+            PointVector points;
+
+            /**
+             * The rows of a filled shape, from top to bottom.
+             */
+            SpanVector spans;
+
+            /**
+             * The outline of a filled shape as x and y pairs relative to
+             * the pixel center of the origin, for raster backends to scan
+             * convert after adding the position of the shape.
+             */
+            std::vector<float> polygon;
+
+            /**
+             * A triangle strip covering a filled shape, as x and y pairs
+             * relative to the pixel center of the origin.
+             */
+            std::vector<float> strip;
+
+            /**
+             * The end points of the radii closing a circle segment.
+             */
+            Point start;
+            Point end;
+        };
+
+        /**
+         * Constructor.
+         *
+         * @param capacity The maximum number of shapes to keep.
+         */
+        GeometryCache(unsigned int capacity = 256);
+
+        /**
+         * Destructor.
+         */
+        virtual ~GeometryCache();
+
+        /**
+         * Gets the outline of a circle, one pixel wide. Fills in points.
+         *
+         * @param radius The radius of the circle.
+         * @return The geometry, valid until the cache is used again.
+         */
+        const Geometry& getCircle(unsigned int radius);
+
+        /**
+         * Gets a filled circle covering the same pixels as the outline
+         * returned by getCircle. Fills in spans and strip.
+         *
+         * @param radius The radius of the circle.
+         * @return The geometry, valid until the cache is used again.
+         */
+        const Geometry& getFillCircle(unsigned int radius);
+
+        /**
+         * Gets the outline of a circle segment, being the pixels of the
+         * outline of the circle within the segment. Fills in points, start
+         * and end. The radii closing the segment are drawn by the caller
+         * from the origin to start and end.
+         *
+         * @param radius The radius of the circle.
+         * @param sangle The start angle of the segment in degrees.
+         * @param eangle The end angle of the segment in degrees, greater
+         *               than the start angle and less than 360 degrees
+         *               after it.
+         * @return The geometry, valid until the cache is used again.
+         */
+        const Geometry& getCircleSegment(unsigned int radius, int sangle, int eangle);
+
+        /**
+         * Gets a filled circle segment, being a polygon of the origin and
+         * points on the arc, with one point on the arc every two pixels of
+         * arc length. A pixel is covered if its center lies within the
+         * polygon. Fills in polygon and strip.
+         *
+         * Whether a pixel center lying exactly on a radius is covered
+         * depends on how the position of the segment rounds, so spans are
+         * not cached and backends scan convert the polygon themselves.
+         *
+         * @param radius The radius of the circle.
+         * @param sangle The start angle of the segment in degrees.
+         * @param eangle The end angle of the segment in degrees, greater
+         *               than the start angle and less than 360 degrees
+         *               after it.
+         * @return The geometry, valid until the cache is used again.
+         */
+        const Geometry& getFillCircleSegment(unsigned int radius, int sangle, int eangle);
+
+        /**
+         * Gets the polyline of a Bezier curve, relative to the first
+         * control point. Fills in points, at least two of them.
+         *
+         * @param points The control points of the curve, at least two.
+         * @param steps The number of samples between two control points.
+         * @return The geometry, valid until the cache is used again.
+         */
+        const Geometry& getBezier(const PointVector& points, int steps);
+
+        /**
+         * Sets the maximum number of shapes to keep. Default is 256.
+         *
+         * @param capacity The maximum number of shapes.
+         */
+        void setCapacity(unsigned int capacity);
+
+        /**
+         * Gets the maximum number of shapes to keep.
+         *
+         * @return The maximum number of shapes.
+         */
+        unsigned int getCapacity() const;
+
+        /**
+         * Gets the number of shapes currently kept.
+         *
+         * @return The number of shapes.
+         */
+        unsigned int getSize() const;
+
+        /**
+         * Drops all shapes.
+         */
+        void clear();
+
+        /**
+         * Gets the number of shapes found in the cache.
+         *
+         * @return The number of hits.
+         */
+        unsigned int getHits() const;
+
+        /**
+         * Gets the number of shapes which had to be tessellated.
+         *
+         * @return The number of misses.
+         */
+        unsigned int getMisses() const;
+
+        /**
+         * Sets the hit and miss counters to zero.
+         */
+        void resetStatistics();
+
+    protected:
+        /**
+         * Kinds of shapes.
+         */
+        enum Shape
+        {
+            Circle = 0,
+            FillCircle,
+            CircleSegment,
+            FillCircleSegment,
+            Bezier
+        };
+
+        /**
+         * Identifies a shape. The start angle of an outline segment is
+         * normalized to range 0-359, and Bezier curves are identified by
+         * their control points relative to the first one.
+         */
+        struct Key
+        {
+            Shape shape;
+            unsigned int radius;
+            int sangle;
+            int eangle;
+            int steps;
+            PointVector points;
+
+            bool operator==(const Key& key) const;
+        };
+
+        /**
+         * Hashes a key.
+         */
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        /**
+         * Looks up a shape, tessellating it on a miss.
+         *
+         * @param key The shape.
+         * @return The geometry of the shape.
+         */
+        const Geometry& lookup(const Key& key);
+
+        /**
+         * Tessellates a shape.
+         *
+         * @param key The shape.
+         * @param geometry The geometry to fill in, empty.
+         */
+        virtual void tessellate(const Key& key, Geometry& geometry) const;
+
+        /**
+         * Computes the half widths of the rows of a circle with the
+         * midpoint algorithm.
+         *
+         * @param radius The radius of the circle.
+         * @param halfWidths The half width of every row from the center
+         *                   row down, radius + 1 entries.
+         */
+        static void getHalfWidths(int radius, std::vector<int>& halfWidths);
+
+        /**
+         * Appends a triangle strip covering a convex polygon.
+         *
+         * @param xs The x coordinates of the vertices.
+         * @param ys The y coordinates of the vertices.
+         * @param strip The strip, appended to. A strip already holding
+         *              vertices is continued with degenerate triangles.
+         */
+        static void addStrip(const std::vector<float>& xs,
+                             const std::vector<float>& ys,
+                             std::vector<float>& strip);
+
+        /**
+         * Drops the least recently used shapes until at most a number of
+         * shapes are kept.
+         *
+         * @param size The number of shapes to keep.
+         */
+        void shrink(unsigned int size);
+
+        typedef std::list<std::pair<Key, Geometry> > EntryList;
+        typedef std::unordered_map<Key, EntryList::iterator, KeyHash> EntryIndex;
+
+        unsigned int mCapacity;
+
+        /**
+         * The shapes, most recently used first.
+         */
+        EntryList mEntries;
+        EntryIndex mIndex;
+
+        /**
+         * Holds the geometry of a shape when the capacity is zero.
+         */
+        Geometry mUncached;
+
+        unsigned int mHits;
+        unsigned int mMisses;
+    };
+}
+
+#endif // end FCN_GEOMETRYCACHE_HPP
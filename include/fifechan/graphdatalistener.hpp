@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_GRAPHDATALISTENER_HPP
+#define FCN_GRAPHDATALISTENER_HPP
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class GraphDataSource;
+
+    /**
+     * Interface for listening for changes of the points of a graph data
+     * source.
+     *
+     * @see GraphDataSource::addGraphDataListener,
+     *      GraphDataSource::removeGraphDataListener
+     */
+    class FCN_CORE_DECLSPEC GraphDataListener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~GraphDataListener() { }
+
+        /**
+         * Invoked when points have been appended to a data source.
+         *
+         * @param source The data source.
+         * @param count The number of appended points.
+         */
+        virtual void pointsAppended(GraphDataSource* source, int count) { }
+
+        /**
+         * Invoked when the oldest points of a data source have been
+         * removed.
+         *
+         * @param source The data source.
+         * @param count The number of removed points.
+         */
+        virtual void pointsRemoved(GraphDataSource* source, int count) { }
+
+        /**
+         * Invoked when the window of a data source has been resized.
+         *
+         * @param source The data source.
+         */
+        virtual void windowChanged(GraphDataSource* source) { }
+
+        /**
+         * Invoked when a data source is deleted. The listener should stop
+         * using the data source.
+         *
+         * @param source The data source being deleted.
+         */
+        virtual void graphDataSourceDeleted(GraphDataSource* source) { }
+
+    protected:
+        /**
+         * Constructor.
+         *
+         * You should not be able to make an instance of GraphDataListener,
+         * therefore its constructor is protected.
+         */
+        GraphDataListener() { }
+
+    };
+}
+
+#endif // end FCN_GRAPHDATALISTENER_HPP
@@ -0,0 +1,226 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_GRAPHDATASOURCE_HPP
+#define FCN_GRAPHDATASOURCE_HPP
+
+#include <list>
+
+#include "fifechan/platform.hpp"
+#include "fifechan/point.hpp"
+
+namespace fcn
+{
+    class GraphDataListener;
+
+    /**
+     * An interface for a stream of points drawn by graph widgets such as
+     * LineGraph, instead of a PointVector set on the graph. The x
+     * coordinates of the points are in pixels and must never decrease,
+     * like time in a live chart.
+     *
+     * A graph shows the points inside the window of the data source,
+     * moved so the window starts at the left edge of the graph. A window
+     * of a fixed width follows the newest point, so the graph scrolls as
+     * points are appended. Graphs keep the points they show and only fetch
+     * the pixel columns that scroll into the window or that got new
+     * points, see updateWindowPoints.
+     *
+     * Data sources which change their points should tell the listeners
+     * about it with distributePointsAppended and distributePointsRemoved.
+     *
+     * @see RingBufferDataSource
+     */
+    class FCN_CORE_DECLSPEC GraphDataSource
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        GraphDataSource();
+
+        /**
+         * Copy constructor. The listeners are not copied.
+         */
+        GraphDataSource(const GraphDataSource& other);
+
+        /**
+         * Assignment operator. The listeners are not copied.
+         */
+        GraphDataSource& operator=(const GraphDataSource& other);
+
+        /**
+         * Destructor. Tells the listeners that the data source is deleted.
+         */
+        virtual ~GraphDataSource();
+
+        /**
+         * Gets the number of points.
+         *
+         * @return The number of points.
+         */
+        virtual int getNumberOfPoints() const = 0;
+
+        /**
+         * Gets a point, the oldest point has index 0.
+         *
+         * @param index The index of the point.
+         * @return The point.
+         */
+        virtual Point getPoint(int index) const = 0;
+
+        /**
+         * Sets the width of the window. The window ends at the newest
+         * point. Default is 0.
+         *
+         * @param width The width of the window in pixels, 0 to show all
+         *              points.
+         */
+        void setWindowWidth(int width);
+
+        /**
+         * Gets the width of the window.
+         *
+         * @return The width of the window in pixels, 0 if all points are
+         *         shown.
+         */
+        int getWindowWidth() const;
+
+        /**
+         * Gets the x coordinate of the first pixel column of the window.
+         *
+         * @return The x coordinate of the first column of the window.
+         */
+        int getWindowStart() const;
+
+        /**
+         * Gets the x coordinate after the last pixel column of the window.
+         *
+         * @return The x coordinate after the last column of the window.
+         */
+        int getWindowEnd() const;
+
+        /**
+         * Appends the points of some pixel columns to a vector. Columns
+         * with more than two points are decimated to their lowest and
+         * highest point.
+         *
+         * @param startX The first column.
+         * @param endX The column after the last column.
+         * @param points The vector to append the points to.
+         */
+        void getPoints(int startX, int endX, PointVector& points) const;
+
+        /**
+         * Updates points fetched for an earlier window to the current
+         * window. Only the columns that scrolled into the window, that got
+         * new points or that lost points are fetched, unless the window
+         * moved back or jumped past the points.
+         *
+         * @param points The points of the window, in the coordinates of
+         *               the data source.
+         * @param start The first column the points were fetched for, 0
+         *              before the first call.
+         * @param end The column after the last column the points were
+         *            fetched for, 0 before the first call.
+         */
+        void updateWindowPoints(PointVector& points, int& start, int& end) const;
+
+        /**
+         * Adds a graph data listener to the data source. If you delete
+         * your listener, be sure to also remove it using
+         * removeGraphDataListener().
+         *
+         * @param graphDataListener The listener to add.
+         */
+        void addGraphDataListener(GraphDataListener* graphDataListener);
+
+        /**
+         * Removes a graph data listener from the data source.
+         *
+         * @param graphDataListener The listener to remove.
+         */
+        void removeGraphDataListener(GraphDataListener* graphDataListener);
+
+    protected:
+        /**
+         * Finds the first point at or after a pixel column.
+         *
+         * @param x The column.
+         * @return The index of the first point with an x coordinate of at
+         *         least x, or the number of points if there is none.
+         */
+        int findPoint(int x) const;
+
+        /**
+         * Gets the lowest and the highest point of a range. Looks at every
+         * point, should be overridden by data sources which can do better.
+         *
+         * @param first The index of the first point.
+         * @param count The number of points, at least one.
+         * @param min Set to the index of the point with the lowest y.
+         * @param max Set to the index of the point with the highest y.
+         */
+        virtual void getExtremes(int first, int count, int& min, int& max) const;
+
+        /**
+         * Tells the listeners that points have been appended.
+         *
+         * @param count The number of appended points.
+         */
+        void distributePointsAppended(int count);
+
+        /**
+         * Tells the listeners that the oldest points have been removed.
+         *
+         * @param count The number of removed points.
+         */
+        void distributePointsRemoved(int count);
+
+        /**
+         * Tells the listeners that the window has been resized.
+         */
+        void distributeWindowChanged();
+
+        /**
+         * The width of the window, 0 if all points are shown.
+         */
+        int mWindowWidth;
+
+        /**
+         * Typedef.
+         */
+        typedef std::list<GraphDataListener*> GraphDataListenerList;
+
+        /**
+         * The listeners of the data source.
+         */
+        GraphDataListenerList mGraphDataListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef GraphDataListenerList::iterator GraphDataListenerIterator;
+    };
+}
+
+#endif // end FCN_GRAPHDATASOURCE_HPP
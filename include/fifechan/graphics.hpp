@@ -394,7 +394,57 @@ namespace fcn
                               int y,
                               Alignment alignment = Left);
 
+        /**
+         * Creates an image which can be drawn to with pushTarget, for
+         * instance to keep what a widget has drawn between frames.
+         * Implementations which can not draw to images return NULL,
+         * which is the default.
+         *
+         * @param width The width of the image.
+         * @param height The height of the image.
+         * @return The image, owned by the caller, or NULL if drawing to
+         *         images is not supported.
+         * @see pushTarget, popTarget, copyArea
+         */
+        virtual Image* createTarget(int width, int height);
+
+        /**
+         * Redirects drawing to an image created by createTarget, until
+         * popTarget is called. The clip area stack is put aside and a
+         * clip area covering the image is pushed.
+         *
+         * @param image The image to draw to.
+         * @throws Exception if drawing to images is not supported.
+         * @see popTarget
+         */
+        virtual void pushTarget(Image* image);
+
+        /**
+         * Ends drawing to the image given to the last call of pushTarget,
+         * and restores the previous target and clip area stack.
+         *
+         * @throws Exception if no image is drawn to.
+         * @see pushTarget
+         */
+        virtual void popTarget();
+
+        /**
+         * Copies an area of the target to a position offset by dx and dy.
+         * The area is relative to the top clip area, and both the source
+         * and the destination are clipped by it. The source and the
+         * destination may overlap, so the contents of a scrolled view can
+         * be moved in place.
+         *
+         * @param area The area to copy.
+         * @param dx The offset on the x axis.
+         * @param dy The offset on the y axis.
+         * @throws Exception if copying areas is not supported, which is
+         *         the case when createTarget returns NULL.
+         */
+        virtual void copyArea(const Rectangle& area, int dx, int dy);
+
     protected:
+
         /**
          * Holds the clip area stack.
          */
@@ -66,6 +66,7 @@
 #define FCN_IMAGE_HPP
 
 #include <string>
+#include <vector>
 
 #include "fifechan/platform.hpp"
 
@@ -173,6 +174,19 @@ namespace fcn
          */
         virtual Color getPixel(int x, int y) = 0;
 
+        /**
+         * Gets the colors of all pixels in the image, row by row. Much
+         * faster than calling getPixel for every pixel, as implementations
+         * access their pixel data directly. The default implementation
+         * calls getPixel.
+         *
+         * IMPORTANT: Only guaranteed to work before the image has been
+         *            converted to display format.
+         *
+         * @param pixels Receives the width * height colors of the image.
+         */
+        virtual void readPixels(std::vector<Color>& pixels);
+
         /**
          * Puts a pixel with a certain color at coordinate (x, y).
          *
@@ -66,6 +66,7 @@
 #define FCN_IMAGEFONT_HPP
 
 #include <string>
+#include <vector>
 
 #include "fifechan/font.hpp"
 #include "fifechan/platform.hpp"
@@ -99,6 +100,19 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
      * horizontal lines making it possible to draw glyphs on more then one
      * line in the image. However, these horizontal lines must have a height of
      * one pixel!
+     *
+     * Glyph lists and text are UTF-8 encoded, so any unicode code point can
+     * have a glyph. Bytes which do not start a valid UTF-8 sequence are read
+     * as Latin-1, one glyph per byte, which keeps Latin-1 glyph lists
+     * working. Glyphs below code point 256 are held in a plain array, others
+     * in pages of 256 glyphs allocated when a glyph of the page is added, so
+     * a lookup never takes more than two array accesses.
+     *
+     * Finding the glyphs in a large image takes time, so the glyph areas
+     * can be stored in a metrics file next to the image. The file holds a
+     * hash of the image and the glyph list, and is only used while both
+     * are unchanged. Otherwise the image is scanned and the file is written
+     * again.
      */
     class FCN_CORE_DECLSPEC ImageFont: public Font
     {
@@ -111,10 +125,14 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
          *
          * @param filename The filename of the image.
          * @param glyphs The glyphs found in the image.
+         * @param metricsFilename The filename of the glyph metrics file,
+         *                        empty to always scan the image.
          * @throws Exception when glyph list is incorrect or the font file is
          *                   corrupt or if no ImageLoader exists.
          */
-        ImageFont(const std::string& filename, const std::string& glyphs);
+        ImageFont(const std::string& filename,
+                  const std::string& glyphs,
+                  const std::string& metricsFilename = "");
 
         /**
          * Constructor. Takes an image containing the font and
@@ -124,10 +142,14 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
          *
          * @param image The image with font glyphs.
          * @param glyphs The glyphs found in the image.
+         * @param metricsFilename The filename of the glyph metrics file,
+         *                        empty to always scan the image.
          * @throws Exception when glyph list is incorrect or the font image is
          *                   is missing.
          */
-        ImageFont(Image* image, const std::string& glyphs);
+        ImageFont(Image* image,
+                  const std::string& glyphs,
+                  const std::string& metricsFilename = "");
 
         /**
          * Constructor. Takes an image file containing the font and
@@ -140,12 +162,15 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
          *                   image.
          * @param glyphsTo The ASCII value of the last glyph found in the
          *                 image.
+         * @param metricsFilename The filename of the glyph metrics file,
+         *                        empty to always scan the image.
          * @throws Exception when glyph bondaries are incorrect or the font
          *                   file is corrupt or if no ImageLoader exists.
          */
         ImageFont(const std::string& filename, 
                   unsigned char glyphsFrom=32,
-                  unsigned char glyphsTo=126);
+                  unsigned char glyphsTo=126,
+                  const std::string& metricsFilename = "");
 
         /**
          * Destructor.
@@ -160,12 +185,12 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
          *       text.
          *
          * @param graphics A graphics object used for drawing.
-         * @param glyph A glyph to draw.
+         * @param glyph The unicode code point of the glyph to draw.
          * @param x The x coordinate where to draw the glyph.
          * @param y The y coordinate where to draw the glyph.
          * @return The width of the glyph in pixels.
          */
-        virtual int drawGlyph(Graphics* graphics, unsigned char glyph,
+        virtual int drawGlyph(Graphics* graphics, unsigned int glyph,
                               int x, int y);
 
         /**
@@ -205,10 +230,11 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
         /**
          * Gets a width of a glyph in pixels.
          *
-         * @param glyph The glyph which width will be returned.
+         * @param glyph The unicode code point of the glyph which width
+         *              will be returned.
          * @return The width of a glyph in pixels.
          */
-        virtual int getWidth(unsigned char glyph) const;
+        virtual int getWidth(unsigned int glyph) const;
 
 
         // Inherited from Font
@@ -222,11 +248,15 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
 
         virtual int getStringIndexAt(const std::string& text, int x) const;
 
+        virtual void getPrefixWidths(const std::string& text, std::vector<int>& widths) const;
+
     protected:
+
         /**
          * Scans for a certain glyph.
          *
-         * @param glyph The glyph to scan for. Used for exception messages.
+         * @param glyph The code point of the glyph to scan for. Used for
+         *              exception messages.
          * @param x The x coordinate where to begin the scan. The coordinate
          *          will be updated with the end x coordinate of the glyph
          *          when the scan is complete.
@@ -234,20 +264,133 @@ pqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"); @endcode
          *          will be updated with the end y coordinate of the glyph
          *          when the scan is complete.
          * @param separator The color separator to look for where the glyph ends.
+         * @param pixels The pixels of the image with the font.
          * @return A rectangle with the found glyph dimension in the image
          *         with the font.
          * @throws Exception when no glyph is found.
          */
-         Rectangle scanForGlyph(unsigned char glyph, 
+         Rectangle scanForGlyph(unsigned int glyph,
                                 int x, 
                                 int y, 
-                                const Color& separator);
+                                const Color& separator,
+                                const std::vector<Color>& pixels);
+
+        /**
+         * Finds the glyphs in the image, from the metrics file if it is
+         * valid and otherwise by scanning the image, and converts the image
+         * to display format.
+         *
+         * @param glyphs The code points of the glyphs in the order they
+         *               appear in the image.
+         * @param metricsFilename The filename of the glyph metrics file,
+         *                        empty to always scan the image.
+         * @throws Exception when a glyph is not found.
+         */
+        void loadGlyphs(const std::vector<unsigned int>& glyphs,
+                        const std::string& metricsFilename);
+
+        /**
+         * Reads the glyph areas from a metrics file.
+         *
+         * @param metricsFilename The filename of the metrics file.
+         * @param glyphs The code points of the glyphs.
+         * @param hash The hash of the image and the glyphs.
+         * @return True if the file exists and matches the hash.
+         */
+        bool loadMetrics(const std::string& metricsFilename,
+                         const std::vector<unsigned int>& glyphs,
+                         unsigned long long hash);
+
+        /**
+         * Writes the glyph areas to a metrics file. Failing to write the
+         * file is not an error, the image is just scanned again next time.
+         *
+         * @param metricsFilename The filename of the metrics file.
+         * @param glyphs The code points of the glyphs.
+         * @param hash The hash of the image and the glyphs.
+         */
+        void saveMetrics(const std::string& metricsFilename,
+                         const std::vector<unsigned int>& glyphs,
+                         unsigned long long hash) const;
+
+        /**
+         * Gets the area of a glyph in the image.
+         *
+         * @param glyph The code point of the glyph.
+         * @return The area of the glyph, with a width of 0 if the font has
+         *         no such glyph.
+         */
+        const Rectangle& getGlyph(unsigned int glyph) const
+        {
+            if (glyph < 256)
+            {
+                return mGlyph[glyph];
+            }
+
+            return getPagedGlyph(glyph);
+        }
 
         /**
-         * Holds the glyphs areas in the image.
+         * Gets the area of a glyph at or above code point 256.
+         *
+         * @param glyph The code point of the glyph.
+         * @return The area of the glyph, with a width of 0 if the font has
+         *         no such glyph.
+         */
+        const Rectangle& getPagedGlyph(unsigned int glyph) const;
+
+        /**
+         * Gets the area of a glyph for writing, allocating its page if
+         * needed.
+         *
+         * @param glyph The code point of the glyph.
+         * @return The area of the glyph.
+         */
+        Rectangle& addGlyph(unsigned int glyph);
+
+        /**
+         * Decodes the code point starting at a byte index of UTF-8 text.
+         * A byte which does not start a valid UTF-8 sequence is returned as
+         * a Latin-1 code point.
+         *
+         * @param text The text to decode.
+         * @param index The byte index of the code point, advanced to the
+         *              index of the next code point.
+         * @return The code point.
+         */
+        static unsigned int decodeGlyph(const std::string& text, unsigned int& index)
+        {
+            unsigned char c = text[index];
+
+            // Fast path for ASCII
+            if (c < 0x80)
+            {
+                ++index;
+                return c;
+            }
+
+            return decodeMultiByteGlyph(text, index);
+        }
+
+        /**
+         * Decodes a code point starting with a byte of 0x80 or above.
+         *
+         * @see decodeGlyph
+         */
+        static unsigned int decodeMultiByteGlyph(const std::string& text, unsigned int& index);
+
+        /**
+         * Holds the areas in the image of the glyphs below code point 256.
          */
         Rectangle mGlyph[256];
 
+        /**
+         * Holds the areas in the image of the glyphs at or above code point
+         * 256, in pages of 256 glyphs indexed by the code point divided by
+         * 256. Pages without glyphs are NULL.
+         */
+        std::vector<Rectangle*> mGlyphPages;
+
         /**
          * Holds the height of the image font.
          */
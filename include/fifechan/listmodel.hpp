@@ -65,27 +65,50 @@
 #ifndef FCN_LISTMODEL_HPP
 #define FCN_LISTMODEL_HPP
 
+#include <list>
 #include <string>
 
 #include "fifechan/platform.hpp"
 
 namespace fcn
 {
+    class ListModelListener;
+
     /**
      * An interface for a model that represents a list. It is 
      * used in certain widgets, like the ListBox, to handle a 
      * lists with string elements. If you want to use widgets 
      * like ListBox, make a derived class from this class that 
      * represents your list.
+     *
+     * Models which change their elements should tell the listeners
+     * about it with distributeElementsInserted, distributeElementsRemoved
+     * and distributeElementsChanged, so widgets only have to fetch the
+     * elements that changed.
      */
     class FCN_CORE_DECLSPEC ListModel
     {
 
     public:
         /**
-         * Destructor.
+         * Constructor.
+         */
+        ListModel() { }
+
+        /**
+         * Copy constructor. The listeners are not copied.
          */
-        virtual ~ListModel() { }
+        ListModel(const ListModel&) { }
+
+        /**
+         * Assignment operator. The listeners are not copied.
+         */
+        ListModel& operator=(const ListModel&) { return *this; }
+
+        /**
+         * Destructor. Tells the listeners that the model is deleted.
+         */
+        virtual ~ListModel();
 
         /**
          * Gets the number of elements in the list.
@@ -101,6 +124,74 @@ namespace fcn
          * @return An element as a string at the a certain index.
          */
         virtual std::string getElementAt(int i) = 0;
+
+        /**
+         * Gets an element at a certain index in the list without copying
+         * it. Should be overridden by models which store their elements
+         * as strings. The pointer only has to stay valid until the model
+         * changes.
+         *
+         * @param i An index in the list.
+         * @return The element at the index, or NULL if the model doesn't
+         *         store it, in which case getElementAt should be used.
+         */
+        virtual const std::string* getElementPointer(int i) { return NULL; }
+
+        /**
+         * Adds a list model listener to the list model. If you delete
+         * your listener, be sure to also remove it using
+         * removeListModelListener().
+         *
+         * @param listModelListener The listener to add.
+         */
+        void addListModelListener(ListModelListener* listModelListener);
+
+        /**
+         * Removes a list model listener from the list model.
+         *
+         * @param listModelListener The listener to remove.
+         */
+        void removeListModelListener(ListModelListener* listModelListener);
+
+    protected:
+        /**
+         * Tells the listeners that elements have been inserted.
+         *
+         * @param first The index of the first inserted element.
+         * @param count The number of inserted elements.
+         */
+        void distributeElementsInserted(int first, int count);
+
+        /**
+         * Tells the listeners that elements have been removed.
+         *
+         * @param first The index the first removed element had.
+         * @param count The number of removed elements.
+         */
+        void distributeElementsRemoved(int first, int count);
+
+        /**
+         * Tells the listeners that elements have changed.
+         *
+         * @param first The index of the first changed element.
+         * @param count The number of changed elements.
+         */
+        void distributeElementsChanged(int first, int count);
+
+        /**
+         * Typedef.
+         */
+        typedef std::list<ListModelListener*> ListModelListenerList;
+
+        /**
+         * The listeners of the list model.
+         */
+        ListModelListenerList mListModelListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef ListModelListenerList::iterator ListModelListenerIterator;
     };
 }
 
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_LISTMODELLISTENER_HPP
+#define FCN_LISTMODELLISTENER_HPP
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class ListModel;
+
+    /**
+     * Interface for listening for changes of the elements of a list model.
+     * Ranges are given in the indices the elements have after the change,
+     * except for removed elements, which are given in the indices they had
+     * before.
+     *
+     * @see ListModel::addListModelListener,
+     *      ListModel::removeListModelListener
+     */
+    class FCN_CORE_DECLSPEC ListModelListener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~ListModelListener() { }
+
+        /**
+         * Invoked when elements have been inserted into a list model.
+         *
+         * @param model The list model.
+         * @param first The index of the first inserted element.
+         * @param count The number of inserted elements.
+         */
+        virtual void elementsInserted(ListModel* model, int first, int count) { }
+
+        /**
+         * Invoked when elements have been removed from a list model.
+         *
+         * @param model The list model.
+         * @param first The index the first removed element had.
+         * @param count The number of removed elements.
+         */
+        virtual void elementsRemoved(ListModel* model, int first, int count) { }
+
+        /**
+         * Invoked when elements of a list model have changed.
+         *
+         * @param model The list model.
+         * @param first The index of the first changed element.
+         * @param count The number of changed elements.
+         */
+        virtual void elementsChanged(ListModel* model, int first, int count) { }
+
+        /**
+         * Invoked when a list model is deleted. The listener should stop
+         * using the model.
+         *
+         * @param model The list model being deleted.
+         */
+        virtual void listModelDeleted(ListModel* model) { }
+
+    protected:
+        /**
+         * Constructor.
+         *
+         * You should not be able to make an instance of ListModelListener,
+         * therefore its constructor is protected.
+         */
+        ListModelListener() { }
+
+    };
+}
+
+#endif // end FCN_LISTMODELLISTENER_HPP
@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FCN_MEMORY_HPP
+#define FCN_MEMORY_HPP
+
+#include <fifechan/memory/memorygraphics.hpp>
+#include <fifechan/memory/memoryimage.hpp>
+#include <fifechan/memory/memorytiledgraphics.hpp>
+
+#include "platform.hpp"
+
+extern "C"
+{
+    /**
+     * Exists to be able to check for Fifechan Memory with autotools.
+     */
+    FCN_EXTENSION_DECLSPEC extern void fcnMemory();
+}
+
+#endif // end FCN_MEMORY_HPP
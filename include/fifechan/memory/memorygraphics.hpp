@@ -0,0 +1,235 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FCN_MEMORYGRAPHICS_HPP
+#define FCN_MEMORYGRAPHICS_HPP
+
+#include <stack>
+#include <utility>
+#include <vector>
+
+#include "fifechan/color.hpp"
+#include "fifechan/geometrycache.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class Image;
+    class MemoryImage;
+    class Rectangle;
+
+    /**
+     * Memory implementation of the Graphics. Rasterizes everything in
+     * software into the RGBA8 buffer of a MemoryImage, without the need of
+     * a window, SDL or OpenGL. Useful for rendering on servers, creating
+     * thumbnails and running tests on machines without a display.
+     *
+     * Fills, alpha blending, image blits and glyph compositing use SSE2 or
+     * AVX2 span kernels when the compiler targets them.
+     *
+     * @see MemoryImage
+     */
+    class FCN_EXTENSION_DECLSPEC MemoryGraphics : public Graphics
+    {
+    public:
+
+        // Needed so that drawImage(fcn::Image *, int, int) is visible.
+        using Graphics::drawImage;
+
+        /**
+         * Constructor.
+         */
+        MemoryGraphics();
+
+        /**
+         * Constructor.
+         *
+         * @param target the target to draw to.
+         */
+        MemoryGraphics(MemoryImage* target);
+
+        /**
+         * Destructor.
+         */
+        virtual ~MemoryGraphics();
+
+        /**
+         * Sets the target MemoryImage to draw to. The target is not
+         * owned by the graphics object.
+         *
+         * @param target the target to draw to.
+         */
+        virtual void setTarget(MemoryImage* target);
+
+        /**
+         * Gets the target MemoryImage.
+         *
+         * @return the target MemoryImage.
+         */
+        virtual MemoryImage* getTarget() const;
+
+        /**
+         * Composites the current color through an 8 bit coverage mask, as
+         * produced by glyph rasterizers such as FreeType. A coverage of 255
+         * draws the current color, 0 leaves the target untouched.
+         *
+         * NOTE: The clip areas will be taken into account.
+         *
+         * @param mask the first coverage value of the mask.
+         * @param pitch the number of bytes between two rows of the mask.
+         * @param dstX the destination x coordinate.
+         * @param dstY the destination y coordinate.
+         * @param width the width of the mask.
+         * @param height the height of the mask.
+         */
+        virtual void drawMask(const unsigned char* mask,
+                              int pitch,
+                              int dstX,
+                              int dstY,
+                              int width,
+                              int height);
+
+
+        // Inherited from Graphics
+
+        virtual void _beginDraw();
+
+        virtual void _endDraw();
+
+        virtual void drawImage(const Image* image,
+                               int srcX,
+                               int srcY,
+                               int dstX,
+                               int dstY,
+                               int width,
+                               int height);
+
+        virtual void drawPoint(int x, int y);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2, unsigned int width);
+
+        virtual void drawPolyLine(const PointVector& points, unsigned int width);
+
+        virtual void drawBezier(const PointVector& points, int steps, unsigned int width);
+
+        virtual void drawRectangle(const Rectangle& rectangle);
+
+        virtual void fillRectangle(const Rectangle& rectangle);
+
+        virtual void drawCircle(const Point& p, unsigned int radius);
+
+        virtual void drawFillCircle(const Point& p, unsigned int radius);
+
+        virtual void drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void setColor(const Color& color);
+
+        virtual const Color& getColor() const;
+
+        virtual Image* createTarget(int width, int height);
+
+        virtual void pushTarget(Image* image);
+
+        virtual void popTarget();
+
+        virtual void copyArea(const Rectangle& area, int dx, int dy);
+
+    protected:
+        /**
+         * Gets the top clip area.
+         *
+         * @throws Exception if the clip stack is empty.
+         */
+        const ClipRectangle& getTopClipArea() const;
+
+        /**
+         * Puts a pixel with the current color. The coordinates are in
+         * target space and are clipped against the top clip area.
+         *
+         * @param x the x coordinate.
+         * @param y the y coordinate.
+         */
+        void plot(int x, int y);
+
+        /**
+         * Draws a horizontal span with the current color. The coordinates
+         * are in target space and are clipped against the top clip area.
+         *
+         * @param x1 the first x coordinate of the span, inclusive.
+         * @param x2 the last x coordinate of the span, inclusive.
+         * @param y the y coordinate of the span.
+         */
+        void drawSpan(int x1, int x2, int y);
+
+        /**
+         * Draws a one pixel wide line with the current color using
+         * Bresenham. The coordinates are in target space. Only the pixels
+         * inside the top clip area are visited.
+         *
+         * @param x1 the first x coordinate.
+         * @param y1 the first y coordinate.
+         * @param x2 the second x coordinate.
+         * @param y2 the second y coordinate.
+         */
+        void rasterLine(long long x1, long long y1, long long x2, long long y2);
+
+        /**
+         * Fills a polygon with the current color using the even-odd rule.
+         * A pixel is filled if its center lies inside the polygon. The
+         * coordinates are in target space.
+         *
+         * @param xs the x coordinates of the vertices.
+         * @param ys the y coordinates of the vertices.
+         */
+        void fillPolygon(const std::vector<float>& xs, const std::vector<float>& ys);
+
+        MemoryImage* mTarget;
+
+        /**
+         * The targets and clip area stacks put aside by pushTarget.
+         */
+        std::vector<std::pair<MemoryImage*, std::stack<ClipRectangle> > > mTargetStack;
+
+        Color mColor;
+        unsigned int mPixel;
+        bool mAlpha;
+
+        /**
+         * The tessellated circles, circle segments and Bezier curves.
+         */
+        GeometryCache mGeometryCache;
+
+        /**
+         * Scratch buffers reused by fillPolygon and drawBezier.
+         */
+        PointVector mCurve;
+        std::vector<float> mPolygonX;
+        std::vector<float> mPolygonY;
+        std::vector<float> mCrossings;
+    };
+}
+
+#endif // end FCN_MEMORYGRAPHICS_HPP
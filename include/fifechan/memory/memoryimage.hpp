@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FCN_MEMORYIMAGE_HPP
+#define FCN_MEMORYIMAGE_HPP
+
+#include "fifechan/color.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * Memory implementation of Image. Holds the pixels as a plain RGBA8
+     * buffer, with the bytes R, G, B and A in memory order. A MemoryImage
+     * can be drawn with MemoryGraphics and is also used as its target.
+     *
+     * Unlike most other images, getPixel and putPixel keep working after
+     * the image has been converted to display format.
+     *
+     * @see MemoryGraphics
+     */
+    class FCN_EXTENSION_DECLSPEC MemoryImage : public Image
+    {
+    public:
+        /**
+         * Constructor. Creates a fully transparent image.
+         *
+         * @param width the width of the image.
+         * @param height the height of the image.
+         */
+        MemoryImage(int width, int height);
+
+        /**
+         * Constructor. Copies the pixels of an RGBA8 buffer. Magic pink
+         * (255, 0, 255) is converted to transparent.
+         *
+         * @param pixels the pixels to copy, width * height values.
+         * @param width the width of the image.
+         * @param height the height of the image.
+         * @param convertToDisplayFormat true if the image should be converted
+         *                               to display format.
+         */
+        MemoryImage(const unsigned int* pixels,
+                    int width,
+                    int height,
+                    bool convertToDisplayFormat = true);
+
+        /**
+         * Destructor.
+         */
+        virtual ~MemoryImage();
+
+        /**
+         * Gets the pixels of the image. Rows are stored one after another
+         * without padding.
+         *
+         * @return the pixels of the image, NULL if the image has been freed.
+         */
+        virtual unsigned int* getPixels();
+
+        /**
+         * Gets the pixels of the image. Rows are stored one after another
+         * without padding.
+         *
+         * @return the pixels of the image, NULL if the image has been freed.
+         */
+        virtual const unsigned int* getPixels() const;
+
+        /**
+         * Checks if every pixel of the image is opaque. Opaque images are
+         * copied instead of blended when drawn. The value is updated by
+         * convertToDisplayFormat and putPixel.
+         *
+         * @return true if the image is opaque, false otherwise.
+         */
+        virtual bool isOpaque() const;
+
+
+        // Inherited from Image
+
+        virtual void free();
+
+        virtual int getWidth() const;
+
+        virtual int getHeight() const;
+
+        virtual Color getPixel(int x, int y);
+
+        virtual void readPixels(std::vector<Color>& pixels);
+
+        virtual void putPixel(int x, int y, const Color& color);
+
+        virtual void convertToDisplayFormat();
+
+    protected:
+        unsigned int* mPixels;
+        int mWidth;
+        int mHeight;
+        bool mOpaque;
+    };
+}
+
+#endif // end FCN_MEMORYIMAGE_HPP
@@ -0,0 +1,351 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FCN_MEMORYPIXEL_HPP
+#define FCN_MEMORYPIXEL_HPP
+
+#include "fifechan/color.hpp"
+
+/*
+ * The span kernels below work on RGBA8 pixels stored as unsigned ints in
+ * the same layout as OpenGLImage, that is the bytes R, G, B, A in memory
+ * order. The SIMD paths are selected at compile time, build with -mavx2
+ * (or /arch:AVX2) to get the AVX2 kernels. All paths produce bit identical
+ * results.
+ */
+#if defined(__AVX2__)
+#define FCN_MEMORY_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FCN_MEMORY_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace fcn
+{
+#ifdef __BIG_ENDIAN__
+    const unsigned int MemoryAlphaMask = 0x000000ff;
+#else
+    const unsigned int MemoryAlphaMask = 0xff000000;
+#endif
+
+    /**
+     * Packs a color into a RGBA8 pixel.
+     *
+     * @param color the color to pack.
+     * @return the packed pixel.
+     */
+    inline unsigned int MemoryMapRGBA(const Color& color)
+    {
+#ifdef __BIG_ENDIAN__
+        return (color.a & 0xff) | (color.b & 0xff) << 8 | (color.g & 0xff) << 16 | (color.r & 0xff) << 24;
+#else
+        return (color.r & 0xff) | (color.g & 0xff) << 8 | (color.b & 0xff) << 16 | (color.a & 0xff) << 24;
+#endif
+    }
+
+    /**
+     * Unpacks a RGBA8 pixel into a color.
+     *
+     * @param pixel the pixel to unpack.
+     * @return the color of the pixel.
+     */
+    inline Color MemoryGetRGBA(unsigned int pixel)
+    {
+#ifdef __BIG_ENDIAN__
+        return Color((pixel >> 24) & 0xff, (pixel >> 16) & 0xff, (pixel >> 8) & 0xff, pixel & 0xff);
+#else
+        return Color(pixel & 0xff, (pixel >> 8) & 0xff, (pixel >> 16) & 0xff, (pixel >> 24) & 0xff);
+#endif
+    }
+
+    /**
+     * Gets the alpha of a RGBA8 pixel.
+     *
+     * @param pixel the pixel.
+     * @return the alpha of the pixel (0-255).
+     */
+    inline unsigned int MemoryGetAlpha(unsigned int pixel)
+    {
+#ifdef __BIG_ENDIAN__
+        return pixel & 0xff;
+#else
+        return pixel >> 24;
+#endif
+    }
+
+    /**
+     * Blends an opaque source pixel over a destination pixel, two channels
+     * at a time. The destination alpha is blended towards 255 so the result
+     * is a regular "source over" composition.
+     *
+     * @param src the source pixel, the alpha channel is ignored.
+     * @param dst the destination pixel.
+     * @param a the alpha of the source (0-255).
+     * @return the blended pixel.
+     */
+    inline unsigned int MemoryAlpha32(unsigned int src, unsigned int dst, unsigned int a)
+    {
+        src |= MemoryAlphaMask;
+
+        unsigned int ia = 255 - a;
+        unsigned int rb = (src & 0x00ff00ff) * a + (dst & 0x00ff00ff) * ia + 0x00800080;
+        unsigned int ga = ((src >> 8) & 0x00ff00ff) * a + ((dst >> 8) & 0x00ff00ff) * ia + 0x00800080;
+
+        rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+        ga = (ga + ((ga >> 8) & 0x00ff00ff)) & 0xff00ff00;
+
+        return rb | ga;
+    }
+
+    /**
+     * Multiplies two 8 bit values and divides by 255 with rounding.
+     */
+    inline unsigned int MemoryMul255(unsigned int a, unsigned int b)
+    {
+        unsigned int t = a * b + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+#ifdef FCN_MEMORY_SSE2
+    /**
+     * Blends 2 pixels unpacked to 16 bit lanes. The source must have
+     * its alpha lanes set to 255, sa holds the source alpha in all lanes.
+     */
+    inline __m128i MemoryBlend16SSE2(__m128i s, __m128i d, __m128i sa)
+    {
+        const __m128i c255 = _mm_set1_epi16(255);
+        const __m128i c128 = _mm_set1_epi16(128);
+
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, sa),
+                                  _mm_mullo_epi16(d, _mm_sub_epi16(c255, sa)));
+        t = _mm_add_epi16(t, c128);
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+#endif
+
+#ifdef FCN_MEMORY_AVX2
+    /**
+     * AVX2 version of MemoryBlend16SSE2, blends 4 pixels.
+     */
+    inline __m256i MemoryBlend16AVX2(__m256i s, __m256i d, __m256i sa)
+    {
+        const __m256i c255 = _mm256_set1_epi16(255);
+        const __m256i c128 = _mm256_set1_epi16(128);
+
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, sa),
+                                     _mm256_mullo_epi16(d, _mm256_sub_epi16(c255, sa)));
+        t = _mm256_add_epi16(t, c128);
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+#endif
+
+    /**
+     * Fills a span of pixels with a color.
+     *
+     * @param dst the first pixel of the span.
+     * @param n the number of pixels.
+     * @param pixel the packed color.
+     */
+    inline void MemoryFillSpan(unsigned int* dst, int n, unsigned int pixel)
+    {
+        int i = 0;
+#if defined(FCN_MEMORY_AVX2)
+        __m256i p8 = _mm256_set1_epi32((int)pixel);
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_si256((__m256i*)(dst + i), p8);
+        }
+#elif defined(FCN_MEMORY_SSE2)
+        __m128i p4 = _mm_set1_epi32((int)pixel);
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_si128((__m128i*)(dst + i), p4);
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            dst[i] = pixel;
+        }
+    }
+
+    /**
+     * Blends a color with constant alpha over a span of pixels.
+     *
+     * @param dst the first pixel of the span.
+     * @param n the number of pixels.
+     * @param pixel the packed color, the alpha channel is ignored.
+     * @param a the alpha to blend with (0-255).
+     */
+    inline void MemoryBlendSpan(unsigned int* dst, int n, unsigned int pixel, unsigned int a)
+    {
+        int i = 0;
+#if defined(FCN_MEMORY_AVX2)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i s = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)(pixel | MemoryAlphaMask)), zero);
+            __m256i sa = _mm256_set1_epi16((short)a);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+                __m256i lo = MemoryBlend16AVX2(s, _mm256_unpacklo_epi8(d, zero), sa);
+                __m256i hi = MemoryBlend16AVX2(s, _mm256_unpackhi_epi8(d, zero), sa);
+                _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+        }
+#endif
+#if defined(FCN_MEMORY_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)(pixel | MemoryAlphaMask)), zero);
+            __m128i sa = _mm_set1_epi16((short)a);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+                __m128i lo = MemoryBlend16SSE2(s, _mm_unpacklo_epi8(d, zero), sa);
+                __m128i hi = MemoryBlend16SSE2(s, _mm_unpackhi_epi8(d, zero), sa);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            dst[i] = MemoryAlpha32(pixel, dst[i], a);
+        }
+    }
+
+    /**
+     * Composites a span of RGBA8 pixels over a span of pixels using the
+     * alpha of each source pixel. Fully opaque and fully transparent runs
+     * are copied or skipped without blending.
+     *
+     * @param dst the first destination pixel.
+     * @param src the first source pixel.
+     * @param n the number of pixels.
+     */
+    inline void MemoryBlitSpan(unsigned int* dst, const unsigned int* src, int n)
+    {
+        int i = 0;
+#if defined(FCN_MEMORY_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i amask = _mm_set1_epi32((int)MemoryAlphaMask);
+            const __m128i alane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i sa = _mm_and_si128(s, amask);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, amask)) == 0xffff)
+                {
+                    _mm_storeu_si128((__m128i*)(dst + i), s);
+                    continue;
+                }
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, zero)) == 0xffff)
+                {
+                    continue;
+                }
+
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+                __m128i slo = _mm_unpacklo_epi8(s, zero);
+                __m128i shi = _mm_unpackhi_epi8(s, zero);
+                __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xff), 0xff);
+                __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xff), 0xff);
+                __m128i lo = MemoryBlend16SSE2(_mm_or_si128(slo, alane), _mm_unpacklo_epi8(d, zero), alo);
+                __m128i hi = MemoryBlend16SSE2(_mm_or_si128(shi, alane), _mm_unpackhi_epi8(d, zero), ahi);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            unsigned int s = src[i];
+            unsigned int a = MemoryGetAlpha(s);
+
+            if (a == 255)
+            {
+                dst[i] = s;
+            }
+            else if (a != 0)
+            {
+                dst[i] = MemoryAlpha32(s, dst[i], a);
+            }
+        }
+    }
+
+    /**
+     * Composites a color through a span of 8 bit coverage values, as
+     * produced by glyph rasterizers.
+     *
+     * @param dst the first destination pixel.
+     * @param coverage the first coverage value.
+     * @param n the number of pixels.
+     * @param pixel the packed color, the alpha channel is ignored.
+     * @param a the alpha of the color (0-255).
+     */
+    inline void MemoryMaskSpan(unsigned int* dst,
+                               const unsigned char* coverage,
+                               int n,
+                               unsigned int pixel,
+                               unsigned int a)
+    {
+        int i = 0;
+#if defined(FCN_MEMORY_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i c128 = _mm_set1_epi16(128);
+            __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)(pixel | MemoryAlphaMask)), zero);
+            __m128i ca = _mm_set1_epi16((short)a);
+            for (; i + 4 <= n; i += 4)
+            {
+                unsigned int c4 = coverage[i]
+                                  | (unsigned int)coverage[i + 1] << 8
+                                  | (unsigned int)coverage[i + 2] << 16
+                                  | (unsigned int)coverage[i + 3] << 24;
+                if (c4 == 0)
+                {
+                    continue;
+                }
+
+                // Effective alpha of the 4 pixels in the low lanes
+                __m128i e = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)c4), zero), ca), c128);
+                e = _mm_srli_epi16(_mm_add_epi16(e, _mm_srli_epi16(e, 8)), 8);
+                e = _mm_unpacklo_epi16(e, e);
+
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+                __m128i lo = MemoryBlend16SSE2(s, _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(e, e));
+                __m128i hi = MemoryBlend16SSE2(s, _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(e, e));
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            if (coverage[i] != 0)
+            {
+                dst[i] = MemoryAlpha32(pixel, dst[i], MemoryMul255(coverage[i], a));
+            }
+        }
+    }
+}
+
+#endif // end FCN_MEMORYPIXEL_HPP
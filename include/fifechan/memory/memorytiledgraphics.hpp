@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_MEMORYTILEDGRAPHICS_HPP
+#define FCN_MEMORYTILEDGRAPHICS_HPP
+
+#include "fifechan/platform.hpp"
+#include "fifechan/tiledgraphics.hpp"
+
+namespace fcn
+{
+    class MemoryImage;
+
+    /**
+     * Multi-threaded variant of MemoryGraphics. Drawing operations are
+     * recorded and rasterized in tiles by several MemoryGraphics objects
+     * in parallel when _endDraw() is called. The result is identical to
+     * drawing with a single MemoryGraphics.
+     *
+     * @see MemoryGraphics, TiledGraphics
+     */
+    class FCN_EXTENSION_DECLSPEC MemoryTiledGraphics : public TiledGraphics
+    {
+    public:
+
+        /**
+         * Constructor.
+         */
+        MemoryTiledGraphics();
+
+        /**
+         * Constructor.
+         *
+         * @param target the target to draw to.
+         */
+        MemoryTiledGraphics(MemoryImage* target);
+
+        /**
+         * Destructor.
+         */
+        virtual ~MemoryTiledGraphics();
+
+        /**
+         * Sets the target MemoryImage to draw to. The target is not
+         * owned by the graphics object.
+         *
+         * @param target the target to draw to.
+         */
+        virtual void setTarget(MemoryImage* target);
+
+        /**
+         * Gets the target MemoryImage.
+         *
+         * @return the target MemoryImage.
+         */
+        virtual MemoryImage* getTarget() const;
+
+
+        // Inherited from Graphics
+
+        virtual void _beginDraw();
+
+    protected:
+
+        // Inherited from TiledGraphics
+
+        virtual Graphics* createTileGraphics();
+
+        virtual int getTargetWidth() const;
+
+        virtual int getTargetHeight() const;
+
+        MemoryImage* mTarget;
+    };
+}
+
+#endif // end FCN_MEMORYTILEDGRAPHICS_HPP
@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_MINMAXPYRAMID_HPP
+#define FCN_MINMAXPYRAMID_HPP
+
+#include <vector>
+
+#include "fifechan/platform.hpp"
+#include "fifechan/point.hpp"
+
+namespace fcn
+{
+    /**
+     * A level of detail index over the points of a graph. Level k holds,
+     * for every bucket of 2^k consecutive points, the points with the
+     * lowest and the highest y coordinate. Points appended to the vector
+     * are indexed in logarithmic time each.
+     *
+     * If the x coordinates of the points never decrease, the pyramid can
+     * decimate the points to about two per pixel column, keeping the
+     * extremes of every column so a line through them covers the same
+     * pixels as the full data.
+     *
+     * The pyramid doesn't own the points, the same vector must be passed
+     * to every call until clear() is called.
+     */
+    class FCN_CORE_DECLSPEC MinMaxPyramid
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        MinMaxPyramid();
+
+        /**
+         * Indexes the points appended since the last update. If the
+         * vector is shorter than when last updated, it is indexed again.
+         *
+         * @param points The points.
+         */
+        void update(const PointVector& points);
+
+        /**
+         * Removes all indexed points, needed when points were changed
+         * rather than appended.
+         */
+        void clear();
+
+        /**
+         * Checks if the x coordinates of the indexed points never decrease.
+         *
+         * @return True if the x coordinates never decrease, false otherwise.
+         */
+        bool isMonotonic() const;
+
+        /**
+         * Decimates the points to the lowest and highest point of every
+         * pixel column, plus the first and the last point. Points are only
+         * decimated if they are monotonic and there are at least four
+         * points per column on average.
+         *
+         * @param points The indexed points.
+         * @param result The vector to store the decimated points in.
+         * @return True if the points were decimated, false if they should
+         *         be drawn as they are.
+         */
+        bool decimate(const PointVector& points, PointVector& result) const;
+
+    protected:
+        /**
+         * The lowest and highest point of a bucket, as indexes in the
+         * points.
+         */
+        struct Node
+        {
+            unsigned int min;
+            unsigned int max;
+        };
+
+        /**
+         * Indexes a point. All points before it must be indexed.
+         *
+         * @param points The points.
+         * @param index The index of the point to index.
+         */
+        void insert(const PointVector& points, unsigned int index);
+
+        /**
+         * The levels, starting with buckets of two points.
+         */
+        std::vector<std::vector<Node> > mLevels;
+
+        /**
+         * The number of indexed points.
+         */
+        unsigned int mIndexed;
+
+        /**
+         * True if the x coordinates never decrease, false otherwise.
+         */
+        bool mMonotonic;
+    };
+}
+
+#endif // end FCN_MINMAXPYRAMID_HPP
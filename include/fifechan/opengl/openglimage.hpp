@@ -159,6 +159,8 @@ namespace fcn
 
         virtual Color getPixel(int x, int y);
 
+        virtual void readPixels(std::vector<Color>& pixels);
+
         virtual void putPixel(int x, int y, const Color& color);
 
         virtual void convertToDisplayFormat();
@@ -0,0 +1,168 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_RANGESET_HPP
+#define FCN_RANGESET_HPP
+
+#include <map>
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * A set of integers stored as sorted, disjoint ranges, used for
+     * selections in lists. Selecting all of a million rows takes one
+     * range. Checking if an integer is in the set takes logarithmic time
+     * in the number of ranges.
+     *
+     * Iterating the set gives the ranges in increasing order, each as a
+     * pair of its first integer and the integer after its last one.
+     */
+    class FCN_CORE_DECLSPEC RangeSet
+    {
+    public:
+        /**
+         * Typedef.
+         */
+        typedef std::map<int, int>::const_iterator const_iterator;
+
+        /**
+         * Checks if an integer is in the set.
+         *
+         * @param value The integer.
+         * @return True if the integer is in the set, false otherwise.
+         */
+        bool contains(int value) const;
+
+        /**
+         * Checks if any integer of a range is in the set.
+         *
+         * @param first The first integer of the range.
+         * @param count The number of integers in the range.
+         * @return True if any integer of the range is in the set, false
+         *         otherwise.
+         */
+        bool intersects(int first, int count) const;
+
+        /**
+         * Adds a range of integers to the set.
+         *
+         * @param first The first integer of the range.
+         * @param count The number of integers in the range.
+         */
+        void add(int first, int count);
+
+        /**
+         * Removes a range of integers from the set.
+         *
+         * @param first The first integer of the range.
+         * @param count The number of integers in the range.
+         */
+        void remove(int first, int count);
+
+        /**
+         * Adds an integer to the set if it isn't in it, removes it
+         * otherwise.
+         *
+         * @param value The integer.
+         */
+        void toggle(int value);
+
+        /**
+         * Removes all integers from the set.
+         */
+        void clear();
+
+        /**
+         * Checks if the set is empty.
+         *
+         * @return True if the set is empty, false otherwise.
+         */
+        bool isEmpty() const;
+
+        /**
+         * Gets the number of integers in the set. Takes linear time in
+         * the number of ranges.
+         *
+         * @return The number of integers in the set.
+         */
+        int getSize() const;
+
+        /**
+         * Gets the number of ranges in the set.
+         *
+         * @return The number of ranges in the set.
+         */
+        int getNumberOfRanges() const;
+
+        /**
+         * Moves the integers from a position up to make room for a range
+         * that isn't in the set, as needed when elements are inserted into
+         * a list.
+         *
+         * @param first The first integer of the inserted range.
+         * @param count The number of integers in the inserted range.
+         */
+        void insertGap(int first, int count);
+
+        /**
+         * Removes a range and moves the integers after it down, as needed
+         * when elements are removed from a list.
+         *
+         * @param first The first integer of the removed range.
+         * @param count The number of integers in the removed range.
+         */
+        void removeGap(int first, int count);
+
+        /**
+         * Gets an iterator to the first range.
+         *
+         * @return An iterator to the first range.
+         */
+        const_iterator begin() const;
+
+        /**
+         * Gets an iterator past the last range.
+         *
+         * @return An iterator past the last range.
+         */
+        const_iterator end() const;
+
+    protected:
+        /**
+         * Moves the ranges starting at or after a position.
+         *
+         * @param from The position.
+         * @param offset The number to move the ranges by.
+         */
+        void shift(int from, int offset);
+
+        /**
+         * The ranges, as the first integer of each range mapped to the
+         * integer after its last one.
+         */
+        std::map<int, int> mRanges;
+    };
+}
+
+#endif // end FCN_RANGESET_HPP
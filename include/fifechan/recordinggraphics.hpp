@@ -0,0 +1,278 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_RECORDINGGRAPHICS_HPP
+#define FCN_RECORDINGGRAPHICS_HPP
+
+#include <string>
+#include <vector>
+
+#include "fifechan/color.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class Image;
+
+    /**
+     * Graphics which records the drawing operations into a command buffer,
+     * to be replayed on any other Graphics later. The commands are stored
+     * in one flat buffer of integers which keeps its capacity when it is
+     * cleared, so recording a frame does not allocate once the buffer has
+     * grown to the size of a frame.
+     *
+     * If a target is set, every operation is also passed on to the target,
+     * so the recording graphics can be put between the Gui and the real
+     * Graphics. Without a target nothing is drawn, and the size set with
+     * setSize is used as the base clip area.
+     *
+     * Text is recorded as the primitives the font draws with.
+     *
+     * Example of skipping frames which did not change:
+     * @code
+     * recorder.clear();
+     * gui->setGraphics(&recorder);
+     * gui->draw();
+     * if (!recorder.isEqual(previousFrame))
+     * {
+     *     recorder.replay(&graphics);
+     * }
+     * @endcode
+     */
+    class FCN_CORE_DECLSPEC RecordingGraphics : public Graphics
+    {
+    public:
+
+        // Needed so that drawImage(fcn::Image *, int, int) is visible.
+        using Graphics::drawImage;
+
+        /**
+         * Constructor.
+         */
+        RecordingGraphics();
+
+        /**
+         * Constructor.
+         *
+         * @param target the graphics to pass the operations on to.
+         */
+        RecordingGraphics(Graphics* target);
+
+        /**
+         * Destructor.
+         */
+        virtual ~RecordingGraphics();
+
+        /**
+         * Sets the graphics to pass the operations on to.
+         *
+         * @param target the graphics to pass the operations on to, NULL
+         *               to only record.
+         */
+        void setTarget(Graphics* target);
+
+        /**
+         * Gets the graphics the operations are passed on to.
+         *
+         * @return the graphics the operations are passed on to.
+         */
+        Graphics* getTarget() const;
+
+        /**
+         * Sets the size of the base clip area used when there is no
+         * target.
+         *
+         * @param width the width of the base clip area.
+         * @param height the height of the base clip area.
+         */
+        void setSize(int width, int height);
+
+        /**
+         * Removes all recorded commands. The memory of the command buffer
+         * is kept for the next recording.
+         */
+        void clear();
+
+        /**
+         * Gets the number of recorded commands.
+         *
+         * @return the number of recorded commands.
+         */
+        unsigned int getCommandCount() const;
+
+        /**
+         * Gets the size of the command buffer in bytes.
+         *
+         * @return the size of the command buffer in bytes.
+         */
+        unsigned int getSize() const;
+
+        /**
+         * Checks if two recordings contain the same commands.
+         *
+         * @param other the recording to compare with.
+         * @return true if the recordings contain the same commands.
+         */
+        bool isEqual(const RecordingGraphics& other) const;
+
+        /**
+         * Replays the recorded commands on a graphics.
+         *
+         * @param graphics the graphics to replay on.
+         * @throws Exception if the command buffer is corrupt, which
+         *         includes coordinates, radii, angles, line widths and
+         *         bezier steps too large to come from a user interface.
+         */
+        void replay(Graphics* graphics) const;
+
+        /**
+         * Saves the recorded commands to a binary file. Images can not
+         * be saved, they are stored as references only.
+         *
+         * @param filename the name of the file to save to.
+         * @throws Exception if the file could not be written.
+         */
+        void save(const std::string& filename) const;
+
+        /**
+         * Loads recorded commands from a binary file saved with save,
+         * replacing the current recording. Images are not stored in the
+         * file, so images are skipped when a loaded recording is
+         * replayed.
+         *
+         * @param filename the name of the file to load from.
+         * @throws Exception if the file could not be read or its counts
+         *         don't fit its size.
+         */
+        void load(const std::string& filename);
+
+
+        // Inherited from Graphics
+
+        virtual void _beginDraw();
+
+        virtual void _endDraw();
+
+        virtual bool pushClipArea(Rectangle area);
+
+        virtual void popClipArea();
+
+        virtual void drawImage(const Image* image,
+                               int srcX,
+                               int srcY,
+                               int dstX,
+                               int dstY,
+                               int width,
+                               int height);
+
+        virtual void drawPoint(int x, int y);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2, unsigned int width);
+
+        virtual void drawPolyLine(const PointVector& points, unsigned int width);
+
+        virtual void drawBezier(const PointVector& points, int steps, unsigned int width);
+
+        virtual void drawRectangle(const Rectangle& rectangle);
+
+        virtual void fillRectangle(const Rectangle& rectangle);
+
+        virtual void drawCircle(const Point& p, unsigned int radius);
+
+        virtual void drawFillCircle(const Point& p, unsigned int radius);
+
+        virtual void drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void setColor(const Color& color);
+
+        virtual const Color& getColor() const;
+
+    protected:
+        /**
+         * Types of the recorded commands.
+         */
+        enum CommandType
+        {
+            BeginDraw = 0,
+            EndDraw,
+            PushClipArea,
+            PopClipArea,
+            DrawImage,
+            DrawPoint,
+            DrawLine,
+            DrawThickLine,
+            DrawPolyLine,
+            DrawBezier,
+            DrawRectangle,
+            FillRectangle,
+            DrawCircle,
+            DrawFillCircle,
+            DrawCircleSegment,
+            DrawFillCircleSegment,
+            SetColor,
+            CommandTypeCount
+        };
+
+        /**
+         * Appends a command to the command buffer.
+         *
+         * @param type the type of the command.
+         * @param size the number of arguments of the command.
+         * @return the first argument of the command, valid until the next
+         *         command is appended.
+         */
+        int* append(CommandType type, int size);
+
+        /**
+         * Appends a command with a point list to the command buffer.
+         *
+         * @param type the type of the command.
+         * @param points the points of the command.
+         * @param first the first argument, written before the points.
+         * @param second the second argument, written before the points.
+         */
+        void appendPoints(CommandType type, const PointVector& points, int first, int second);
+
+        Graphics* mTarget;
+        Color mColor;
+        int mWidth;
+        int mHeight;
+        unsigned int mCommandCount;
+
+        /**
+         * The commands, each one is its type followed by its arguments.
+         */
+        std::vector<int> mCommands;
+
+        /**
+         * The images of the image commands, referenced by index.
+         */
+        std::vector<const Image*> mImages;
+    };
+}
+
+#endif // end FCN_RECORDINGGRAPHICS_HPP
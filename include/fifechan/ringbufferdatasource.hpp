@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_RINGBUFFERDATASOURCE_HPP
+#define FCN_RINGBUFFERDATASOURCE_HPP
+
+#include <vector>
+
+#include "fifechan/graphdatasource.hpp"
+#include "fifechan/platform.hpp"
+#include "fifechan/point.hpp"
+
+namespace fcn
+{
+    /**
+     * A graph data source holding a fixed number of points in a ring
+     * buffer. When the buffer is full, appending a point removes the
+     * oldest one, so appending never allocates or copies earlier points.
+     *
+     * The lowest and highest points of the buffer are kept in a segment
+     * tree, which takes logarithmic time to update per appended point, so
+     * a graph fetching a window of many points only does logarithmic work
+     * per pixel column.
+     */
+    class FCN_CORE_DECLSPEC RingBufferDataSource : public GraphDataSource
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param capacity The maximum number of points.
+         */
+        RingBufferDataSource(int capacity);
+
+        /**
+         * Destructor.
+         */
+        virtual ~RingBufferDataSource();
+
+        /**
+         * Appends a point, removing the oldest point if the buffer is full.
+         *
+         * @param point The point to append.
+         * @throws Exception if the x coordinate of the point is lower than
+         *                   the one of the newest point.
+         */
+        void addPoint(const Point& point);
+
+        /**
+         * Appends points, removing the oldest points if the buffer is full.
+         * Listeners are only told once.
+         *
+         * @param points The points to append.
+         * @throws Exception if the x coordinates of the points decrease.
+         */
+        void addPoints(const PointVector& points);
+
+        /**
+         * Removes all points.
+         */
+        void clear();
+
+        /**
+         * Gets the maximum number of points.
+         *
+         * @return The maximum number of points.
+         */
+        int getCapacity() const;
+
+
+        // Inherited from GraphDataSource
+
+        virtual int getNumberOfPoints() const;
+
+        virtual Point getPoint(int index) const;
+
+    protected:
+        // Inherited from GraphDataSource
+
+        virtual void getExtremes(int first, int count, int& min, int& max) const;
+
+        /**
+         * Stores a point in the buffer without telling the listeners.
+         *
+         * @param point The point to store.
+         * @return True if the oldest point was removed, false otherwise.
+         */
+        bool store(const Point& point);
+
+        /**
+         * Gets the lower of two slots, with None for no slot.
+         */
+        unsigned int lower(unsigned int a, unsigned int b) const;
+
+        /**
+         * Gets the higher of two slots, with None for no slot.
+         */
+        unsigned int higher(unsigned int a, unsigned int b) const;
+
+        /**
+         * Gets the lowest and highest point of some slots which don't wrap
+         * around the end of the buffer.
+         *
+         * @param first The first slot.
+         * @param last The slot after the last slot.
+         * @param min Combined with the slot of the lowest point.
+         * @param max Combined with the slot of the highest point.
+         */
+        void query(unsigned int first, unsigned int last, unsigned int& min, unsigned int& max) const;
+
+        /**
+         * Marks a tree node without a slot.
+         */
+        static const unsigned int None;
+
+        /**
+         * The slots of the buffer.
+         */
+        std::vector<Point> mPoints;
+
+        /**
+         * The slot of the oldest point.
+         */
+        unsigned int mFirst;
+
+        /**
+         * The number of points.
+         */
+        unsigned int mSize;
+
+        /**
+         * The number of leaves of the segment trees, a power of two.
+         */
+        unsigned int mLeaves;
+
+        /**
+         * Segment trees of the slots with the lowest and highest point,
+         * node i having children 2i and 2i + 1, and the leaves starting at
+         * mLeaves.
+         */
+        std::vector<unsigned int> mMinTree;
+        std::vector<unsigned int> mMaxTree;
+    };
+}
+
+#endif // end FCN_RINGBUFFERDATASOURCE_HPP
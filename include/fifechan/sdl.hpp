@@ -69,6 +69,9 @@
 #include <fifechan/sdl/sdlimage.hpp>
 #include <fifechan/sdl/sdlimageloader.hpp>
 #include <fifechan/sdl/sdlinput.hpp>
+#include <fifechan/sdl/sdlrenderergraphics.hpp>
+#include <fifechan/sdl/sdltextureimage.hpp>
+#include <fifechan/sdl/sdltextureimageloader.hpp>
 
 #include "platform.hpp"
 
@@ -65,9 +65,31 @@
 #ifndef FCN_SDLPIXEL_HPP
 #define FCN_SDLPIXEL_HPP
 
+#include <vector>
+
 #include "SDL.h"
 #include "fifechan/color.hpp"
 
+#if defined(__AVX2__)
+#define FCN_SDL_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FCN_SDL_SSE2
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FCN_SDL_NEON
+#endif
+
+#if defined(FCN_SDL_AVX2)
+#include <immintrin.h>
+#elif defined(FCN_SDL_SSE2)
+#include <emmintrin.h>
+#elif defined(FCN_SDL_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace fcn
 {
 
@@ -124,6 +146,67 @@ namespace fcn
         return Color(r,g,b,a);
     }
 
+    /**
+     * Gets the colors of all pixels of an SDL_Surface, row by row. Locks
+     * the surface only once, which makes it much faster than calling
+     * SDLgetPixel for every pixel.
+     *
+     * @param surface the surface to read.
+     * @param pixels receives the w * h colors of the surface.
+     */
+    inline void SDLgetPixels(SDL_Surface* surface, std::vector<Color>& pixels)
+    {
+        int bpp = surface->format->BytesPerPixel;
+
+        pixels.resize(surface->w * surface->h);
+
+        SDL_LockSurface(surface);
+
+        for (int y = 0; y < surface->h; ++y)
+        {
+            Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch;
+
+            for (int x = 0; x < surface->w; ++x, p += bpp)
+            {
+                unsigned int color = 0;
+
+                switch(bpp)
+                {
+                  case 1:
+                      color = *p;
+                      break;
+
+                  case 2:
+                      color = *(Uint16 *)p;
+                      break;
+
+                  case 3:
+                      if(SDL_BYTEORDER == SDL_BIG_ENDIAN)
+                      {
+                          color = p[0] << 16 | p[1] << 8 | p[2];
+                      }
+                      else
+                      {
+                          color = p[0] | p[1] << 8 | p[2] << 16;
+                      }
+                      break;
+
+                  case 4:
+                      color = *(Uint32 *)p;
+                      break;
+                }
+
+                unsigned char r,g,b,a;
+
+                SDL_GetRGBA(color, surface->format, &r, &g, &b, &a);
+
+                pixels[x + y * surface->w] = Color(r,g,b,a);
+            }
+        }
+
+        SDL_UnlockSurface(surface);
+    }
+
     /**
      * Puts a pixel on an SDL_Surface.
      *
@@ -276,6 +359,242 @@ namespace fcn
 
         SDL_UnlockSurface(surface);
     }
+
+    /**
+     * Blends a 32 bit color into a span of 32 bit pixels. Gives the same
+     * result as calling SDLAlpha32 for every pixel, but blends 8 (AVX2) or
+     * 4 (SSE2, NEON) pixels at a time when the compiler targets it.
+     *
+     * @param dst the first pixel of the span.
+     * @param n the number of pixels in the span.
+     * @param pixel the source color.
+     * @param a alpha.
+     */
+    inline void SDLAlphaSpan32(Uint32* dst, int n, Uint32 pixel, unsigned char a)
+    {
+        int i = 0;
+
+#if defined(FCN_SDL_AVX2)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i mask = _mm256_set1_epi32(0x00ffffff);
+            const __m256i ia = _mm256_set1_epi16(255 - a);
+            const __m256i sa = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32(pixel), zero),
+                                                  _mm256_set1_epi16(a));
+
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+                __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), ia);
+                __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), ia);
+                lo = _mm256_srli_epi16(_mm256_add_epi16(lo, sa), 8);
+                hi = _mm256_srli_epi16(_mm256_add_epi16(hi, sa), 8);
+                _mm256_storeu_si256((__m256i*)(dst + i), _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask));
+            }
+        }
+#endif
+
+#if defined(FCN_SDL_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mask = _mm_set1_epi32(0x00ffffff);
+            const __m128i ia = _mm_set1_epi16(255 - a);
+            const __m128i sa = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(pixel), zero),
+                                               _mm_set1_epi16(a));
+
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+                __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), ia);
+                __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), ia);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, sa), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, sa), 8);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_and_si128(_mm_packus_epi16(lo, hi), mask));
+            }
+        }
+#elif defined(FCN_SDL_NEON)
+        {
+            const uint8x8_t va = vdup_n_u8(a);
+            const uint8x8_t ia = vdup_n_u8(255 - a);
+            const uint32x4_t mask = vdupq_n_u32(0x00ffffff);
+            const uint16x8_t sa = vmull_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)), va);
+
+            for (; i + 4 <= n; i += 4)
+            {
+                uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+                uint16x8_t lo = vmlal_u8(sa, vget_low_u8(d), ia);
+                uint16x8_t hi = vmlal_u8(sa, vget_high_u8(d), ia);
+                uint8x16_t r = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+                vst1q_u32(dst + i, vandq_u32(vreinterpretq_u32_u8(r), mask));
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            dst[i] = SDLAlpha32(pixel, dst[i], a);
+        }
+    }
+
+    /**
+     * Blends a 16 bit color into a span of 16 bit pixels. Gives the same
+     * result as calling SDLAlpha16 for every pixel, but blends 16 (AVX2) or
+     * 8 (SSE2, NEON) pixels at a time when the compiler targets it.
+     *
+     * @param dst the first pixel of the span.
+     * @param n the number of pixels in the span.
+     * @param pixel the source color.
+     * @param a alpha.
+     * @param f the pixel format of the span.
+     */
+    inline void SDLAlphaSpan16(Uint16* dst, int n, Uint16 pixel, unsigned char a, const SDL_PixelFormat *f)
+    {
+        int i = 0;
+
+#if defined(FCN_SDL_SSE2) || defined(FCN_SDL_NEON)
+        // Blending a channel in place and masking it gives the same bits
+        // as blending the channel on its own and shifting it back, which
+        // fits in 16 bit lanes.
+        const int shifts[3] = { f->Rshift, f->Gshift, f->Bshift };
+        const int masks[3] = { (int)(f->Rmask >> f->Rshift),
+                               (int)(f->Gmask >> f->Gshift),
+                               (int)(f->Bmask >> f->Bshift) };
+        int sa[3];
+
+        for (int c = 0; c < 3; ++c)
+        {
+            sa[c] = ((pixel >> shifts[c]) & masks[c]) * a;
+        }
+#endif
+
+#if defined(FCN_SDL_AVX2)
+        {
+            const __m256i ia = _mm256_set1_epi16(255 - a);
+
+            for (; i + 16 <= n; i += 16)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+                __m256i r = _mm256_setzero_si256();
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    const __m128i shift = _mm_cvtsi32_si128(shifts[c]);
+                    __m256i dc = _mm256_and_si256(_mm256_srl_epi16(d, shift), _mm256_set1_epi16(masks[c]));
+                    dc = _mm256_add_epi16(_mm256_mullo_epi16(dc, ia), _mm256_set1_epi16(sa[c]));
+                    r = _mm256_or_si256(r, _mm256_sll_epi16(_mm256_srli_epi16(dc, 8), shift));
+                }
+
+                _mm256_storeu_si256((__m256i*)(dst + i), r);
+            }
+        }
+#endif
+
+#if defined(FCN_SDL_SSE2)
+        {
+            const __m128i ia = _mm_set1_epi16(255 - a);
+
+            for (; i + 8 <= n; i += 8)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+                __m128i r = _mm_setzero_si128();
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    const __m128i shift = _mm_cvtsi32_si128(shifts[c]);
+                    __m128i dc = _mm_and_si128(_mm_srl_epi16(d, shift), _mm_set1_epi16(masks[c]));
+                    dc = _mm_add_epi16(_mm_mullo_epi16(dc, ia), _mm_set1_epi16(sa[c]));
+                    r = _mm_or_si128(r, _mm_sll_epi16(_mm_srli_epi16(dc, 8), shift));
+                }
+
+                _mm_storeu_si128((__m128i*)(dst + i), r);
+            }
+        }
+#elif defined(FCN_SDL_NEON)
+        {
+            const uint16x8_t ia = vdupq_n_u16(255 - a);
+
+            for (; i + 8 <= n; i += 8)
+            {
+                uint16x8_t d = vld1q_u16(dst + i);
+                uint16x8_t r = vdupq_n_u16(0);
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    uint16x8_t dc = vandq_u16(vshlq_u16(d, vdupq_n_s16(-shifts[c])), vdupq_n_u16(masks[c]));
+                    dc = vmlaq_u16(vdupq_n_u16(sa[c]), dc, ia);
+                    r = vorrq_u16(r, vshlq_u16(vshrq_n_u16(dc, 8), vdupq_n_s16(shifts[c])));
+                }
+
+                vst1q_u16(dst + i, r);
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            dst[i] = SDLAlpha16(pixel, dst[i], a, f);
+        }
+    }
+
+    /**
+     * Puts a horizontal span of pixels on an SDL_Surface with alpha. Gives
+     * the same result as calling SDLputPixelAlpha for every pixel, but only
+     * dispatches on the pixel format once.
+     *
+     * @param x the x coordinate of the first pixel on the surface.
+     * @param y the y coordinate on the surface.
+     * @param n the number of pixels in the span.
+     * @param color the color the pixels should be in.
+     */
+    inline void SDLputSpanAlpha(SDL_Surface* surface, int x, int y, int n, const Color& color)
+    {
+        int bpp = surface->format->BytesPerPixel;
+
+        SDL_LockSurface(surface);
+
+        Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
+
+        Uint32 pixel = SDL_MapRGB(surface->format, color.r, color.g, color.b);
+
+        switch(bpp)
+        {
+          case 1:
+              for (int i = 0; i < n; ++i)
+              {
+                  p[i] = pixel;
+              }
+              break;
+
+          case 2:
+              SDLAlphaSpan16((Uint16 *)p, n, pixel, color.a, surface->format);
+              break;
+
+          case 3:
+          {
+              // Offsets of the red and blue components in memory
+              int ri = SDL_BYTEORDER == SDL_BIG_ENDIAN ? 0 : 2;
+              int bi = 2 - ri;
+
+              for (int i = 0; i < n; ++i, p += 3)
+              {
+                  unsigned int r = (p[ri] * (255 - color.a) + color.r * color.a) >> 8;
+                  unsigned int g = (p[1] * (255 - color.a) + color.g * color.a) >> 8;
+                  unsigned int b = (p[bi] * (255 - color.a) + color.b * color.a) >> 8;
+
+                  p[ri] = r;
+                  p[1] = g;
+                  p[bi] = b;
+              }
+              break;
+          }
+
+          case 4:
+              SDLAlphaSpan32((Uint32 *)p, n, pixel, color.a);
+              break;
+        }
+
+        SDL_UnlockSurface(surface);
+    }
 }
 
 #endif // end FCN_SDLPIXEL_HPP
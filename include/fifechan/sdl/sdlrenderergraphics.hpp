@@ -0,0 +1,240 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_SDLRENDERERGRAPHICS_HPP
+#define FCN_SDLRENDERERGRAPHICS_HPP
+
+#include <vector>
+
+#include "SDL.h"
+
+#include "fifechan/color.hpp"
+#include "fifechan/geometrycache.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class Image;
+    class Rectangle;
+
+    /**
+     * SDL_Renderer implementation of the Graphics. Unlike SDLGraphics,
+     * which draws into an SDL_Surface on the CPU, everything is drawn
+     * through an SDL_Renderer and composited by the GPU when the renderer
+     * is accelerated. Rectangles, spans and points of the same color are
+     * batched into a single SDL_RenderFillRects call.
+     *
+     * Images must be SDLTextureImage, loaded with SDLTextureImageLoader
+     * for the same renderer.
+     *
+     * The graphics can be tested without a window using a software
+     * renderer created by SDL_CreateSoftwareRenderer.
+     *
+     * @see SDLTextureImage, SDLTextureImageLoader
+     */
+    class FCN_EXTENSION_DECLSPEC SDLRendererGraphics : public Graphics
+    {
+    public:
+
+        // Needed so that drawImage(fcn::Image *, int, int) is visible.
+        using Graphics::drawImage;
+
+        /**
+         * Constructor.
+         */
+        SDLRendererGraphics();
+
+        /**
+         * Constructor.
+         *
+         * @param renderer the renderer to draw with.
+         */
+        SDLRendererGraphics(SDL_Renderer* renderer);
+
+        /**
+         * Destructor.
+         */
+        virtual ~SDLRendererGraphics();
+
+        /**
+         * Sets the renderer to draw with. Everything is drawn to the
+         * current render target of the renderer.
+         *
+         * @param renderer the renderer to draw with.
+         */
+        virtual void setRenderer(SDL_Renderer* renderer);
+
+        /**
+         * Gets the renderer to draw with.
+         *
+         * @return the renderer to draw with.
+         */
+        virtual SDL_Renderer* getRenderer() const;
+
+        /**
+         * Sets the blend mode used for drawing points, lines and shapes.
+         * Default is SDL_BLENDMODE_BLEND. The blend mode of images is set
+         * with SDLTextureImage::setBlendMode.
+         *
+         * @param mode the blend mode.
+         */
+        virtual void setBlendMode(SDL_BlendMode mode);
+
+        /**
+         * Gets the blend mode used for drawing points, lines and shapes.
+         *
+         * @return the blend mode.
+         */
+        virtual SDL_BlendMode getBlendMode() const;
+
+        /**
+         * Draws an SDL_Texture on the render target. Normaly you'll
+         * use drawImage, but if you want to write SDL specific code
+         * this function might come in handy.
+         *
+         * NOTE: The clip areas will be taken into account.
+         */
+        virtual void drawSDLTexture(SDL_Texture* texture,
+                                    SDL_Rect source,
+                                    SDL_Rect destination);
+
+
+        // Inherited from Graphics
+
+        virtual void _beginDraw();
+
+        virtual void _endDraw();
+
+        virtual bool pushClipArea(Rectangle area);
+
+        virtual void popClipArea();
+
+        virtual void drawImage(const Image* image,
+                               int srcX,
+                               int srcY,
+                               int dstX,
+                               int dstY,
+                               int width,
+                               int height);
+
+        virtual void drawPoint(int x, int y);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2, unsigned int width);
+
+        virtual void drawPolyLine(const PointVector& points, unsigned int width);
+
+        virtual void drawBezier(const PointVector& points, int steps, unsigned int width);
+
+        virtual void drawRectangle(const Rectangle& rectangle);
+
+        virtual void fillRectangle(const Rectangle& rectangle);
+
+        virtual void drawCircle(const Point& p, unsigned int radius);
+
+        virtual void drawFillCircle(const Point& p, unsigned int radius);
+
+        virtual void drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void setColor(const Color& color);
+
+        virtual const Color& getColor() const;
+
+    protected:
+        /**
+         * Gets the top clip area.
+         *
+         * @throws Exception if the clip stack is empty.
+         */
+        const ClipRectangle& getTopClipArea() const;
+
+        /**
+         * Sets the clip rectangle of the renderer to the top clip area.
+         */
+        void updateClipRect();
+
+        /**
+         * Draws the batched rectangles.
+         */
+        void flush();
+
+        /**
+         * Adds a rectangle to the batch. The coordinates are in target
+         * space and are clipped against the top clip area.
+         *
+         * @param x the x coordinate of the rectangle.
+         * @param y the y coordinate of the rectangle.
+         * @param width the width of the rectangle.
+         * @param height the height of the rectangle.
+         */
+        void batchRect(int x, int y, int width, int height);
+
+        /**
+         * Adds a horizontal span to the batch. The coordinates are in
+         * target space.
+         *
+         * @param x1 the first x coordinate of the span, inclusive.
+         * @param x2 the last x coordinate of the span, inclusive.
+         * @param y the y coordinate of the span.
+         */
+        void batchSpan(int x1, int x2, int y);
+
+        /**
+         * Fills a polygon with the current color using the even-odd rule.
+         * A pixel is filled if its center lies inside the polygon. The
+         * coordinates are in target space.
+         *
+         * @param xs the x coordinates of the vertices.
+         * @param ys the y coordinates of the vertices.
+         */
+        void fillPolygon(const std::vector<float>& xs, const std::vector<float>& ys);
+
+        SDL_Renderer* mRenderer;
+        Color mColor;
+        SDL_BlendMode mBlendMode;
+
+        /**
+         * The rectangles waiting to be drawn with the current color.
+         */
+        std::vector<SDL_Rect> mRects;
+
+        /**
+         * The tessellated circles, circle segments and Bezier curves.
+         */
+        GeometryCache mGeometryCache;
+
+        /**
+         * Scratch buffers.
+         */
+        std::vector<SDL_Point> mLinePoints;
+        PointVector mCurve;
+        std::vector<float> mPolygonX;
+        std::vector<float> mPolygonY;
+        std::vector<float> mCrossings;
+    };
+}
+
+#endif // end FCN_SDLRENDERERGRAPHICS_HPP
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_SDLTEXTUREIMAGE_HPP
+#define FCN_SDLTEXTUREIMAGE_HPP
+
+#include "SDL.h"
+
+#include "fifechan/color.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * SDL_Renderer implementation of Image. The image is uploaded to an
+     * SDL_Texture of a renderer when it is converted to display format.
+     *
+     * NOTE: The functions getPixel and putPixel are only guaranteed to work
+     *       before an image has been converted to display format.
+     *
+     * @see SDLRendererGraphics, SDLTextureImageLoader
+     */
+    class FCN_EXTENSION_DECLSPEC SDLTextureImage : public Image
+    {
+    public:
+        /**
+         * Constructor. Load an image from an SDL surface. The surface is
+         * uploaded to a texture of the renderer by convertToDisplayFormat.
+         *
+         * @param renderer the renderer the texture is created for.
+         * @param surface the surface from which to load.
+         * @param autoFree true if the surface and the texture should
+         *                 automatically be deleted.
+         */
+        SDLTextureImage(SDL_Renderer* renderer, SDL_Surface* surface, bool autoFree);
+
+        /**
+         * Constructor. Wraps an existing texture, for instance one used
+         * as a render target.
+         *
+         * @param texture the texture of the image.
+         * @param autoFree true if the texture should automatically be
+         *                 deleted.
+         */
+        SDLTextureImage(SDL_Texture* texture, bool autoFree);
+
+        /**
+         * Destructor.
+         */
+        virtual ~SDLTextureImage();
+
+        /**
+         * Gets the SDL texture of the image.
+         *
+         * @return the SDL texture of the image, NULL if the image has not
+         *         been converted to display format.
+         */
+        virtual SDL_Texture* getTexture() const;
+
+        /**
+         * Gets the SDL surface of the image.
+         *
+         * @return the SDL surface of the image, NULL if the image has
+         *         been converted to display format.
+         */
+        virtual SDL_Surface* getSurface() const;
+
+        /**
+         * Sets the blend mode used when the image is drawn. Default is
+         * SDL_BLENDMODE_BLEND.
+         *
+         * @param mode the blend mode.
+         */
+        virtual void setBlendMode(SDL_BlendMode mode);
+
+        /**
+         * Gets the blend mode used when the image is drawn.
+         *
+         * @return the blend mode.
+         */
+        virtual SDL_BlendMode getBlendMode() const;
+
+
+        // Inherited from Image
+
+        virtual void free();
+
+        virtual int getWidth() const;
+
+        virtual int getHeight() const;
+
+        virtual Color getPixel(int x, int y);
+
+        virtual void putPixel(int x, int y, const Color& color);
+
+        virtual void convertToDisplayFormat();
+
+    protected:
+        SDL_Renderer* mRenderer;
+        SDL_Surface* mSurface;
+        SDL_Texture* mTexture;
+        SDL_BlendMode mBlendMode;
+        int mWidth;
+        int mHeight;
+        bool mAutoFree;
+    };
+}
+
+#endif // end FCN_SDLTEXTUREIMAGE_HPP
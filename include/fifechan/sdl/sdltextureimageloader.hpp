@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_SDLTEXTUREIMAGELOADER_HPP
+#define FCN_SDLTEXTUREIMAGELOADER_HPP
+
+#include "SDL.h"
+
+#include "fifechan/platform.hpp"
+#include "fifechan/sdl/sdlimageloader.hpp"
+
+namespace fcn
+{
+    class Image;
+
+    /**
+     * SDL_Renderer implementation of ImageLoader. Loads images as
+     * SDLTextureImage for a renderer.
+     *
+     * @see SDLRendererGraphics, SDLTextureImage
+     */
+    class FCN_EXTENSION_DECLSPEC SDLTextureImageLoader : public SDLImageLoader
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param renderer the renderer the images are loaded for.
+         */
+        SDLTextureImageLoader(SDL_Renderer* renderer);
+
+        /**
+         * Sets the renderer the images are loaded for.
+         *
+         * @param renderer the renderer the images are loaded for.
+         */
+        void setRenderer(SDL_Renderer* renderer);
+
+        /**
+         * Gets the renderer the images are loaded for.
+         *
+         * @return the renderer the images are loaded for.
+         */
+        SDL_Renderer* getRenderer() const;
+
+
+        // Inherited from ImageLoader
+
+        virtual Image* load(const std::string& filename, bool convertToDisplayFormat = true);
+
+    protected:
+        SDL_Renderer* mRenderer;
+    };
+}
+
+#endif // end FCN_SDLTEXTUREIMAGELOADER_HPP
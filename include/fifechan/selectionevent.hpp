@@ -73,7 +73,9 @@ namespace fcn
     class Widget;
 
     /**
-     * Represents a selection event.
+     * Represents a selection event. Widgets with multiple selection
+     * report the rows whose selection may have changed as one range, so
+     * listeners don't have to compare every row.
      *
      * @author Olof Naessn
      */
@@ -88,10 +90,46 @@ namespace fcn
          */
         SelectionEvent(Widget* source);
 
+        /**
+         * Constructor.
+         *
+         * @param source source The widget of the selection event.
+         * @param first The first row whose selection may have changed.
+         * @param count The number of rows whose selection may have changed.
+         */
+        SelectionEvent(Widget* source, int first, int count);
+
         /**
          * Destructor.
          */
         virtual ~SelectionEvent();
+
+        /**
+         * Gets the first row whose selection may have changed.
+         *
+         * @return The first row whose selection may have changed, -1 if
+         *         the rows are not known.
+         */
+        int getFirstChanged() const;
+
+        /**
+         * Gets the number of rows whose selection may have changed.
+         *
+         * @return The number of rows whose selection may have changed, 0 if
+         *         the rows are not known.
+         */
+        int getNumberOfChanged() const;
+
+    protected:
+        /**
+         * The first row whose selection may have changed.
+         */
+        int mFirstChanged;
+
+        /**
+         * The number of rows whose selection may have changed.
+         */
+        int mNumberOfChanged;
     };
 }
 
@@ -0,0 +1,254 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_SORTEDLISTMODEL_HPP
+#define FCN_SORTEDLISTMODEL_HPP
+
+#include <string>
+#include <vector>
+
+#include "fifechan/listmodel.hpp"
+#include "fifechan/listmodellistener.hpp"
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    /**
+     * A list model showing the elements of another list model in sorted
+     * order. The model keeps a permutation of the indices of the source
+     * model, so the source model doesn't have to be sorted itself.
+     *
+     * Elements inserted into or changed in the source model are moved to
+     * their place with a binary search. Large changes and sources with
+     * many elements are sorted again on a worker thread. The worker sorts
+     * a copy of the elements and the finished permutation is published by
+     * update(), which has to be called regularly on the thread using the
+     * model, for instance once per frame. Until then the model keeps
+     * showing the previous order.
+     *
+     * By default elements are ordered by comparing their bytes. Elements
+     * which compare equal keep the order of the source model.
+     */
+    class FCN_CORE_DECLSPEC SortedListModel :
+        public ListModel,
+        public ListModelListener
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param sourceModel The list model to sort.
+         */
+        SortedListModel(ListModel* sourceModel = NULL);
+
+        /**
+         * Destructor. Waits for a running sort to finish.
+         */
+        virtual ~SortedListModel();
+
+        /**
+         * Sets the list model to sort.
+         *
+         * @param sourceModel The list model to sort.
+         * @see getSourceModel
+         */
+        void setSourceModel(ListModel* sourceModel);
+
+        /**
+         * Gets the list model being sorted.
+         *
+         * @return The list model being sorted.
+         * @see setSourceModel
+         */
+        ListModel* getSourceModel() const;
+
+        /**
+         * Sets the number of elements from which the source model is
+         * sorted on a worker thread. Default is 10000. Subclasses are
+         * always sorted on the calling thread, as they may override
+         * lessThan.
+         *
+         * @param threshold The number of elements, 0 to always sort on the
+         *                  calling thread.
+         * @see getAsynchronousThreshold
+         */
+        void setAsynchronousThreshold(int threshold);
+
+        /**
+         * Gets the number of elements from which the source model is
+         * sorted on a worker thread.
+         *
+         * @return The number of elements, 0 if the source model is always
+         *         sorted on the calling thread.
+         * @see setAsynchronousThreshold
+         */
+        int getAsynchronousThreshold() const;
+
+        /**
+         * Sorts all elements again, for instance after the order defined by
+         * lessThan has changed.
+         */
+        void sort();
+
+        /**
+         * Checks whether a sort is running on a worker thread or waiting to
+         * be published.
+         *
+         * @return True if a sort is running, false otherwise.
+         */
+        bool isSorting() const;
+
+        /**
+         * Publishes the result of a sort finished by the worker thread and
+         * tells the listeners that all elements have changed.
+         *
+         * @return True if a result was published, false otherwise.
+         */
+        bool update();
+
+        /**
+         * Gets the index an element has in the source model.
+         *
+         * @param i An index in this model.
+         * @return The index of the element in the source model.
+         */
+        int getSourceIndex(int i) const;
+
+        /**
+         * Compares two elements. Can be overridden to sort differently.
+         * Subclasses are always sorted on the calling thread, so an
+         * override is never called from the worker thread.
+         *
+         * @param a An element.
+         * @param b Another element.
+         * @return True if a comes before b, false otherwise.
+         */
+        virtual bool lessThan(const std::string& a, const std::string& b) const;
+
+
+        // Inherited from ListModel
+
+        virtual int getNumberOfElements();
+
+        virtual std::string getElementAt(int i);
+
+        virtual const std::string* getElementPointer(int i);
+
+
+        // Inherited from ListModelListener
+
+        virtual void elementsInserted(ListModel* model, int first, int count);
+
+        virtual void elementsRemoved(ListModel* model, int first, int count);
+
+        virtual void elementsChanged(ListModel* model, int first, int count);
+
+        virtual void listModelDeleted(ListModel* model);
+
+    protected:
+        /**
+         * Inserts an element of the source model at its place and tells
+         * the listeners about it.
+         *
+         * @param index The index of the element in the source model.
+         */
+        void insertSorted(int index);
+
+        /**
+         * Removes the elements with source indices in a range and tells
+         * the listeners about it. The remaining indices are copied into a
+         * new vector in one pass. While the listeners are told about a run
+         * of removed elements, the model reads the copied indices followed
+         * by the old indices not looked at yet, so it matches every
+         * notification.
+         *
+         * @param first The first source index of the range.
+         * @param count The number of source indices in the range.
+         * @param shift True to move the source indices after the range
+         *              down, which is needed when the source model removed
+         *              the range.
+         */
+        void removeRange(int first, int count, bool shift);
+
+        /**
+         * Gets an element of the source model.
+         *
+         * @param index The index of the element in the source model.
+         * @param element Holds the element if the source model has no
+         *                element pointers.
+         * @return The element.
+         */
+        const std::string& getSourceElement(int index, std::string& element);
+
+        /**
+         * Waits for a running sort and discards it.
+         */
+        void cancelSort();
+
+        /**
+         * The number of changed elements from which all elements are
+         * sorted again instead of moving every element to its place.
+         */
+        static const int MaximumIncrementalChanges = 64;
+
+        /**
+         * The list model being sorted.
+         */
+        ListModel* mSourceModel;
+
+        /**
+         * The indices of the elements in the source model, in sorted
+         * order.
+         */
+        std::vector<int> mIndices;
+
+        /**
+         * The indices kept so far while removeRange runs, empty otherwise.
+         */
+        std::vector<int> mMergedIndices;
+
+        /**
+         * The first index in mIndices not looked at yet while removeRange
+         * runs, zero otherwise.
+         */
+        unsigned int mMergeTail;
+
+        /**
+         * The number of elements from which sorts run on a worker thread.
+         */
+        int mAsynchronousThreshold;
+
+        /**
+         * Counts the changes of the source model, used to discard sorts of
+         * outdated elements.
+         */
+        int mRevision;
+
+        /**
+         * Holds the worker thread, defined in the source file.
+         */
+        class SortTask;
+        SortTask* mSortTask;
+    };
+}
+
+#endif // end FCN_SORTEDLISTMODEL_HPP
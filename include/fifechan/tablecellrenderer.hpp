@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TABLECELLRENDERER_HPP
+#define FCN_TABLECELLRENDERER_HPP
+
+#include <string>
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class Graphics;
+    class Table;
+
+    /**
+     * Draws the cells of a Table. A table uses one renderer for all its
+     * cells instead of a widget per cell, so the cost of a table only
+     * depends on the number of visible cells. The default implementation
+     * draws the element as text, derive from this class to draw cells
+     * differently.
+     *
+     * @see Table::setCellRenderer
+     */
+    class FCN_CORE_DECLSPEC TableCellRenderer
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~TableCellRenderer() { }
+
+        /**
+         * Draws a cell. The graphics object is clipped to the cell and
+         * its origin is the top left corner of the cell. The background
+         * of the cell, including the selection color of a selected row,
+         * has already been drawn by the table.
+         *
+         * @param graphics The graphics object to draw with.
+         * @param table The table the cell belongs to.
+         * @param element The element of the cell.
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @param width The width of the cell.
+         * @param height The height of the cell.
+         * @param selected True if the row of the cell is selected.
+         */
+        virtual void drawCell(Graphics* graphics,
+                              Table* table,
+                              const std::string& element,
+                              int row,
+                              int column,
+                              int width,
+                              int height,
+                              bool selected);
+    };
+}
+
+#endif // end FCN_TABLECELLRENDERER_HPP
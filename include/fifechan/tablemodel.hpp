@@ -0,0 +1,188 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TABLEMODEL_HPP
+#define FCN_TABLEMODEL_HPP
+
+#include <list>
+#include <string>
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class TableModelListener;
+
+    /**
+     * An interface for a model that represents a table of string elements,
+     * in the style of ListModel. It is used by the Table widget, which only
+     * asks for the rows it draws, so the rows can be generated on demand.
+     *
+     * Models which change their rows should tell the listeners about it
+     * with distributeRowsInserted, distributeRowsRemoved and
+     * distributeRowsChanged.
+     *
+     * @see Table
+     */
+    class FCN_CORE_DECLSPEC TableModel
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        TableModel() { }
+
+        /**
+         * Copy constructor. The listeners are not copied.
+         */
+        TableModel(const TableModel&) { }
+
+        /**
+         * Assignment operator. The listeners are not copied.
+         */
+        TableModel& operator=(const TableModel&) { return *this; }
+
+        /**
+         * Destructor. Tells the listeners that the model is deleted.
+         */
+        virtual ~TableModel();
+
+        /**
+         * Gets the number of rows in the table.
+         *
+         * @return The number of rows in the table.
+         */
+        virtual int getNumberOfRows() = 0;
+
+        /**
+         * Gets the number of columns in the table.
+         *
+         * @return The number of columns in the table.
+         */
+        virtual int getNumberOfColumns() = 0;
+
+        /**
+         * Gets the element of a cell.
+         *
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @return The element of the cell as a string.
+         */
+        virtual std::string getElementAt(int row, int column) = 0;
+
+        /**
+         * Gets the element of a cell without copying it. Should be
+         * overridden by models which store their elements as strings. The
+         * pointer only has to stay valid until the model changes.
+         *
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @return The element of the cell, or NULL if the model doesn't
+         *         store it, in which case getElementAt should be used.
+         */
+        virtual const std::string* getElementPointer(int row, int column) { return NULL; }
+
+        /**
+         * Gets the name of a column, shown in the header of the table.
+         *
+         * @param column The column.
+         * @return The name of the column.
+         */
+        virtual std::string getColumnName(int column) { return ""; }
+
+        /**
+         * Gets the height of a row. Only used by tables with variable row
+         * heights enabled.
+         *
+         * @param row The row.
+         * @return The height of the row, or 0 to use the row height of
+         *         the table.
+         * @see Table::setVariableRowHeightsEnabled
+         */
+        virtual int getRowHeight(int row) { return 0; }
+
+        /**
+         * Adds a table model listener to the table model. If you delete
+         * your listener, be sure to also remove it using
+         * removeTableModelListener().
+         *
+         * @param tableModelListener The listener to add.
+         */
+        void addTableModelListener(TableModelListener* tableModelListener);
+
+        /**
+         * Removes a table model listener from the table model.
+         *
+         * @param tableModelListener The listener to remove.
+         */
+        void removeTableModelListener(TableModelListener* tableModelListener);
+
+    protected:
+        /**
+         * Tells the listeners that rows have been inserted.
+         *
+         * @param first The index of the first inserted row.
+         * @param count The number of inserted rows.
+         */
+        void distributeRowsInserted(int first, int count);
+
+        /**
+         * Tells the listeners that rows have been removed.
+         *
+         * @param first The index the first removed row had.
+         * @param count The number of removed rows.
+         */
+        void distributeRowsRemoved(int first, int count);
+
+        /**
+         * Tells the listeners that the elements or the heights of rows
+         * have changed.
+         *
+         * @param first The index of the first changed row.
+         * @param count The number of changed rows.
+         */
+        void distributeRowsChanged(int first, int count);
+
+        /**
+         * Tells the listeners that the number or the names of the columns
+         * have changed.
+         */
+        void distributeColumnsChanged();
+
+        /**
+         * Typedef.
+         */
+        typedef std::list<TableModelListener*> TableModelListenerList;
+
+        /**
+         * The listeners of the table model.
+         */
+        TableModelListenerList mTableModelListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef TableModelListenerList::iterator TableModelListenerIterator;
+    };
+}
+
+#endif // end FCN_TABLEMODEL_HPP
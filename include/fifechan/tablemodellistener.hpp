@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TABLEMODELLISTENER_HPP
+#define FCN_TABLEMODELLISTENER_HPP
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class TableModel;
+
+    /**
+     * Interface for listening for changes of the rows of a table model.
+     * Ranges are given in the indices the rows have after the change,
+     * except for removed rows, which are given in the indices they had
+     * before.
+     *
+     * @see TableModel::addTableModelListener,
+     *      TableModel::removeTableModelListener
+     */
+    class FCN_CORE_DECLSPEC TableModelListener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~TableModelListener() { }
+
+        /**
+         * Invoked when rows have been inserted into a table model.
+         *
+         * @param model The table model.
+         * @param first The index of the first inserted row.
+         * @param count The number of inserted rows.
+         */
+        virtual void rowsInserted(TableModel* model, int first, int count) { }
+
+        /**
+         * Invoked when rows have been removed from a table model.
+         *
+         * @param model The table model.
+         * @param first The index the first removed row had.
+         * @param count The number of removed rows.
+         */
+        virtual void rowsRemoved(TableModel* model, int first, int count) { }
+
+        /**
+         * Invoked when the elements or the heights of rows of a table
+         * model have changed.
+         *
+         * @param model The table model.
+         * @param first The index of the first changed row.
+         * @param count The number of changed rows.
+         */
+        virtual void rowsChanged(TableModel* model, int first, int count) { }
+
+        /**
+         * Invoked when the number or the names of the columns of a table
+         * model have changed.
+         *
+         * @param model The table model.
+         */
+        virtual void columnsChanged(TableModel* model) { }
+
+        /**
+         * Invoked when a table model is deleted. The listener should stop
+         * using the model.
+         *
+         * @param model The table model being deleted.
+         */
+        virtual void tableModelDeleted(TableModel* model) { }
+
+    protected:
+        /**
+         * Constructor.
+         *
+         * You should not be able to make an instance of TableModelListener,
+         * therefore its constructor is protected.
+         */
+        TableModelListener() { }
+
+    };
+}
+
+#endif // end FCN_TABLEMODELLISTENER_HPP
@@ -68,6 +68,7 @@
 #include "fifechan/platform.hpp"
 #include "fifechan/rectangle.hpp"
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,11 @@ namespace fcn
      * TextBox and TextField. The class wraps common text operations
      * such as inserting and deleting text.
      *
+     * The text is kept as one string per row. The positions of the rows
+     * are indexed in a Fenwick tree, so converting between caret
+     * positions and rows takes logarithmic time also for texts with
+     * a large number of rows.
+     *
      */
     class FCN_CORE_DECLSPEC Text
     {
@@ -148,9 +154,21 @@ namespace fcn
          * @param row Row to be erased.
          */
         virtual void eraseRow(unsigned int row);
+
+        /**
+         * Erases a number of rows from the beginning of the text. Takes
+         * constant time per erased row, which makes it suitable for
+         * capping the length of logs. The caret stays at its character,
+         * or moves to the beginning of the text if its row is erased.
+         *
+         * @param count The number of rows to erase.
+         */
+        virtual void eraseFirstRows(unsigned int count);
         
         /**
-         * Gets a reference to a row.
+         * Gets a reference to a row. As the row may be changed through the
+         * reference, the widths of the row are measured again the next time
+         * they are needed. Use the const version to only read the row.
          *
          * @param row The row to get the content of.
          * @return The reference to a row.
@@ -158,6 +176,15 @@ namespace fcn
          */
         virtual std::string& getRow(unsigned int row);
 
+        /**
+         * Gets a const reference to a row.
+         *
+         * @param row The row to get the content of.
+         * @return The const reference to a row.
+         * @throws Exception when no such row exists.
+         */
+        virtual const std::string& getRow(unsigned int row) const;
+
         /**
          * Inserts a character at the current caret position.
          *
@@ -165,6 +192,15 @@ namespace fcn
          */
         virtual void insert(int character);
 
+        /**
+         * Inserts a string at the current caret position and moves the
+         * caret to the end of the inserted string. Line feeds in the
+         * string split the row, all new rows are added in one go.
+         *
+         * @param text The string to insert.
+         */
+        virtual void insert(const std::string& text);
+
         /**
          * Removes a given number of characters at starting
          * at the current caret position. 
@@ -330,10 +366,94 @@ namespace fcn
          */
         void calculateCaretPositionFromRowAndColumn();
 
+        /**
+         * Gets the widths of all prefixes of a row, as returned by
+         * Font::getPrefixWidths. The widths are measured the first time
+         * they are needed and kept until the row is edited, or the font or
+         * its revision changes.
+         *
+         * @param row The row to get the widths of.
+         * @param font The font to measure the row with.
+         * @return The widths of the prefixes of the row.
+         */
+        const std::vector<int>& getRowWidths(unsigned int row, Font* font) const;
+
+        /**
+         * Gets the caret position of the first character of a row.
+         *
+         * @param row The row to get the position of, may be the number of
+         *            rows to get the number of characters in the text.
+         * @return The caret position of the first character of the row.
+         */
+        unsigned int getRowPosition(unsigned int row) const;
+
+        /**
+         * Gets the row a caret position lies in.
+         *
+         * @param position The caret position, must be less than the number
+         *                 of characters in the text.
+         * @return The row the position lies in.
+         */
+        unsigned int getRowAt(unsigned int position) const;
+
+        /**
+         * Gets the sum of the lengths of the first slots of the row index.
+         *
+         * @param slots The number of slots to sum.
+         * @return The sum of the lengths.
+         */
+        unsigned int getIndexSum(unsigned int slots) const;
+
+        /**
+         * Brings the row index up to date with the rows.
+         */
+        void updateRowIndex() const;
+
+        /**
+         * Builds the nodes of the row index from a slot on. The nodes
+         * before the slot are left as they are, so building the index
+         * from the last slots is cheap.
+         *
+         * @param slot The first slot whose length has changed.
+         */
+        void buildRowIndex(unsigned int slot);
+
+        /**
+         * Marks a row as changed. Drops the widths of the row and updates
+         * its length in the row index. Called when the content of the row
+         * changes.
+         *
+         * @param row The row which has changed.
+         */
+        void invalidateRow(unsigned int row);
+
+        /**
+         * Marks all rows as changed. Called when all rows are replaced.
+         */
+        void invalidateRows();
+
+        /**
+         * Makes room for inserted rows in the row widths and the row
+         * index. Called after the rows have been inserted.
+         *
+         * @param row The first inserted row.
+         * @param count The number of inserted rows.
+         */
+        void rowsInserted(unsigned int row, unsigned int count);
+
+        /**
+         * Drops erased rows from the row widths and the row index. Called
+         * after the rows have been erased.
+         *
+         * @param row The first erased row.
+         * @param count The number of erased rows.
+         */
+        void rowsErased(unsigned int row, unsigned int count);
+
         /**
          * Holds the text row by row.
          */
-        std::vector<std::string> mRows;
+        std::deque<std::string> mRows;
 
         /**
          * Holds the position of the caret. This variable should
@@ -352,6 +472,58 @@ namespace fcn
          * be valid.
          */
         unsigned int mCaretColumn;
+
+        /**
+         * Holds the prefix widths of the rows, an empty entry if the
+         * widths of a row have not been measured.
+         */
+        mutable std::deque<std::vector<int> > mRowWidths;
+
+        /**
+         * Holds the font the row widths were measured with.
+         */
+        mutable const Font* mRowWidthsFont;
+
+        /**
+         * Holds the revision of the font the row widths were measured with.
+         */
+        mutable unsigned int mRowWidthsRevision;
+
+        /**
+         * Holds the length of each row plus one for the line feed, as
+         * stored in the row index.
+         */
+        mutable std::vector<unsigned int> mRowLengths;
+
+        /**
+         * Holds the row index, a Fenwick tree over the row lengths.
+         */
+        mutable std::vector<unsigned int> mRowIndex;
+
+        /**
+         * Holds the slot of the first row in the row index. Rows erased
+         * from the beginning of the text leave their slots behind until
+         * the index is built again.
+         */
+        mutable unsigned int mRowIndexBase;
+
+        /**
+         * Holds the rows which have changed since the row index was
+         * updated.
+         */
+        mutable std::vector<unsigned int> mChangedRows;
+
+        /**
+         * Holds the rows handed out by getRow. They may be changed through
+         * the reference at any time, so their lengths are checked every
+         * time the row index is updated.
+         */
+        std::vector<unsigned int> mWatchedRows;
+
+        /**
+         * True if the row index has to be built from scratch.
+         */
+        mutable bool mRowIndexInvalid;
     };
 }
 #endif
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FCN_TILEDGRAPHICS_HPP
+#define FCN_TILEDGRAPHICS_HPP
+
+#include <vector>
+
+#include "fifechan/color.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/platform.hpp"
+#include "fifechan/point.hpp"
+#include "fifechan/rectangle.hpp"
+
+namespace fcn
+{
+    class Image;
+
+    /**
+     * Base class for software renderers that rasterize a frame in tiles on
+     * several threads. Between _beginDraw() and _endDraw() all drawing
+     * operations are only recorded. _endDraw() bins the operations into
+     * screen tiles and rasterizes the tiles in parallel on a pool of worker
+     * threads, each worker using its own Graphics object clipped to the
+     * tile it works on.
+     *
+     * Tiles never share pixels and the operations of a tile are replayed
+     * in the order they were recorded, so the result is identical to
+     * drawing the frame on a single thread, as long as the Graphics objects
+     * returned by createTileGraphics() rasterize independently of the clip
+     * area (which all software backends in Fifechan do).
+     *
+     * Text is recorded as the primitives the font draws with, so fonts
+     * must draw through the Graphics interface. Fonts which require a
+     * specific Graphics implementation can not be used.
+     *
+     * @see MemoryTiledGraphics
+     */
+    class FCN_CORE_DECLSPEC TiledGraphics : public Graphics
+    {
+    public:
+
+        // Needed so that drawImage(fcn::Image *, int, int) is visible.
+        using Graphics::drawImage;
+
+        /**
+         * Constructor.
+         */
+        TiledGraphics();
+
+        /**
+         * Destructor.
+         */
+        virtual ~TiledGraphics();
+
+        /**
+         * Sets the number of threads used to rasterize tiles, including
+         * the thread calling _endDraw(). Default is 0.
+         *
+         * @param threads the number of threads, 0 to use one thread per
+         *                hardware thread.
+         * @see getThreadCount
+         */
+        void setThreadCount(int threads);
+
+        /**
+         * Gets the number of threads used to rasterize tiles.
+         *
+         * @return the number of threads, 0 if one thread per hardware
+         *         thread is used.
+         * @see setThreadCount
+         */
+        int getThreadCount() const;
+
+        /**
+         * Sets the size of the tiles. Default is 128x128 pixels.
+         *
+         * @param width the width of a tile.
+         * @param height the height of a tile.
+         */
+        void setTileSize(int width, int height);
+
+        /**
+         * Gets the width of the tiles.
+         *
+         * @return the width of the tiles.
+         */
+        int getTileWidth() const;
+
+        /**
+         * Gets the height of the tiles.
+         *
+         * @return the height of the tiles.
+         */
+        int getTileHeight() const;
+
+
+        // Inherited from Graphics
+
+        virtual void _beginDraw();
+
+        virtual void _endDraw();
+
+        virtual void drawImage(const Image* image,
+                               int srcX,
+                               int srcY,
+                               int dstX,
+                               int dstY,
+                               int width,
+                               int height);
+
+        virtual void drawPoint(int x, int y);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2);
+
+        virtual void drawLine(int x1, int y1, int x2, int y2, unsigned int width);
+
+        virtual void drawPolyLine(const PointVector& points, unsigned int width);
+
+        virtual void drawBezier(const PointVector& points, int steps, unsigned int width);
+
+        virtual void drawRectangle(const Rectangle& rectangle);
+
+        virtual void fillRectangle(const Rectangle& rectangle);
+
+        virtual void drawCircle(const Point& p, unsigned int radius);
+
+        virtual void drawFillCircle(const Point& p, unsigned int radius);
+
+        virtual void drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle);
+
+        virtual void setColor(const Color& color);
+
+        virtual const Color& getColor() const;
+
+    protected:
+        /**
+         * Creates a Graphics object drawing to the same target as this
+         * object. One is created for every worker thread, so the objects
+         * must not share any mutable state. They are deleted by
+         * TiledGraphics.
+         *
+         * @return a new Graphics object.
+         */
+        virtual Graphics* createTileGraphics() = 0;
+
+        /**
+         * Gets the width of the target.
+         *
+         * @return the width of the target.
+         */
+        virtual int getTargetWidth() const = 0;
+
+        /**
+         * Gets the height of the target.
+         *
+         * @return the height of the target.
+         */
+        virtual int getTargetHeight() const = 0;
+
+        /**
+         * Deletes the Graphics objects of the workers. Should be called by
+         * subclasses when the target changes.
+         */
+        void clearTileGraphics();
+
+        /**
+         * Types of the recorded operations.
+         */
+        enum CommandType
+        {
+            DrawImage = 0,
+            DrawPoint,
+            DrawLine,
+            DrawThickLine,
+            DrawPolyLine,
+            DrawBezier,
+            DrawRectangle,
+            FillRectangle,
+            DrawCircle,
+            DrawFillCircle,
+            DrawCircleSegment,
+            DrawFillCircleSegment
+        };
+
+        /**
+         * A recorded operation. All coordinates are in target space.
+         */
+        struct Command
+        {
+            CommandType type;
+            int args[6];
+            const Image* image;
+            Color color;
+            Rectangle clip;
+            unsigned int firstPoint;
+            unsigned int pointCount;
+        };
+
+        /**
+         * Records an operation if it is visible in the current clip area
+         * and bins it into the tiles it touches.
+         *
+         * @param type the type of the operation.
+         * @param bounds the area the operation may touch, in target space.
+         * @return the recorded operation, NULL if it is not visible.
+         */
+        Command* record(CommandType type, const Rectangle& bounds);
+
+        /**
+         * Rasterizes a tile.
+         *
+         * @param worker the index of the worker rasterizing the tile.
+         * @param tile the index of the tile.
+         */
+        void renderTile(int worker, int tile);
+
+        Color mColor;
+        int mThreads;
+        int mTileWidth;
+        int mTileHeight;
+        int mTilesX;
+        int mTilesY;
+
+        std::vector<Command> mCommands;
+        PointVector mPoints;
+        std::vector<std::vector<unsigned int> > mTiles;
+        std::vector<int> mActiveTiles;
+        std::vector<Graphics*> mTileGraphics;
+        std::vector<PointVector> mTilePoints;
+
+        /**
+         * Holds the worker threads, defined in the source file.
+         */
+        class WorkerPool;
+        WorkerPool* mPool;
+    };
+}
+
+#endif // end FCN_TILEDGRAPHICS_HPP
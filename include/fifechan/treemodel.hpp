@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TREEMODEL_HPP
+#define FCN_TREEMODEL_HPP
+
+#include <list>
+#include <string>
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class TreeModelListener;
+
+    /**
+     * An interface for a model that represents a tree, used by the
+     * TreeView widget. Nodes are identified by handles chosen by the model,
+     * for instance pointers to its own node objects. Handles must be unique
+     * and not NULL, NULL stands for the invisible root whose children are
+     * the top level nodes.
+     *
+     * Children are enumerated lazily: a tree view only asks for the number
+     * of children of a node when the node is expanded, and for a child when
+     * its row becomes visible.
+     *
+     * Models which change their nodes should tell the listeners about it
+     * with distributeChildrenChanged.
+     *
+     * @see TreeView
+     */
+    class FCN_CORE_DECLSPEC TreeModel
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        TreeModel() { }
+
+        /**
+         * Copy constructor. The listeners are not copied.
+         */
+        TreeModel(const TreeModel&) { }
+
+        /**
+         * Assignment operator. The listeners are not copied.
+         */
+        TreeModel& operator=(const TreeModel&) { return *this; }
+
+        /**
+         * Destructor. Tells the listeners that the model is deleted.
+         */
+        virtual ~TreeModel();
+
+        /**
+         * Gets the number of children of a node.
+         *
+         * @param node The node, NULL for the root.
+         * @return The number of children of the node.
+         */
+        virtual int getNumberOfChildren(void* node) = 0;
+
+        /**
+         * Gets a child of a node.
+         *
+         * @param node The node, NULL for the root.
+         * @param index The index of the child.
+         * @return The handle of the child.
+         */
+        virtual void* getChild(void* node, int index) = 0;
+
+        /**
+         * Gets the text of a node.
+         *
+         * @param node The node.
+         * @return The text of the node.
+         */
+        virtual std::string getNodeText(void* node) = 0;
+
+        /**
+         * Checks whether a node has children, which decides if it can be
+         * expanded. Should be overridden by models for which counting the
+         * children is expensive, as it is called for every visible row.
+         *
+         * @param node The node.
+         * @return True if the node has children, false otherwise.
+         */
+        virtual bool hasChildren(void* node) { return getNumberOfChildren(node) > 0; }
+
+        /**
+         * Adds a tree model listener to the tree model. If you delete
+         * your listener, be sure to also remove it using
+         * removeTreeModelListener().
+         *
+         * @param treeModelListener The listener to add.
+         */
+        void addTreeModelListener(TreeModelListener* treeModelListener);
+
+        /**
+         * Removes a tree model listener from the tree model.
+         *
+         * @param treeModelListener The listener to remove.
+         */
+        void removeTreeModelListener(TreeModelListener* treeModelListener);
+
+    protected:
+        /**
+         * Tells the listeners that the children of a node have changed.
+         *
+         * @param node The node whose children changed, NULL for the root.
+         */
+        void distributeChildrenChanged(void* node);
+
+        /**
+         * Typedef.
+         */
+        typedef std::list<TreeModelListener*> TreeModelListenerList;
+
+        /**
+         * The listeners of the tree model.
+         */
+        TreeModelListenerList mTreeModelListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef TreeModelListenerList::iterator TreeModelListenerIterator;
+    };
+}
+
+#endif // end FCN_TREEMODEL_HPP
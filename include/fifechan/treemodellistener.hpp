@@ -0,0 +1,76 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TREEMODELLISTENER_HPP
+#define FCN_TREEMODELLISTENER_HPP
+
+#include "fifechan/platform.hpp"
+
+namespace fcn
+{
+    class TreeModel;
+
+    /**
+     * Interface for listening for changes of the nodes of a tree model.
+     *
+     * @see TreeModel::addTreeModelListener,
+     *      TreeModel::removeTreeModelListener
+     */
+    class FCN_CORE_DECLSPEC TreeModelListener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~TreeModelListener() { }
+
+        /**
+         * Invoked when the children of a node have changed, that is
+         * children have been added, removed or replaced.
+         *
+         * @param model The tree model.
+         * @param node The node whose children changed, NULL for the root.
+         */
+        virtual void childrenChanged(TreeModel* model, void* node) { }
+
+        /**
+         * Invoked when a tree model is deleted. The listener should stop
+         * using the model.
+         *
+         * @param model The tree model being deleted.
+         */
+        virtual void treeModelDeleted(TreeModel* model) { }
+
+    protected:
+        /**
+         * Constructor.
+         *
+         * You should not be able to make an instance of TreeModelListener,
+         * therefore its constructor is protected.
+         */
+        TreeModelListener() { }
+
+    };
+}
+
+#endif // end FCN_TREEMODELLISTENER_HPP
@@ -24,6 +24,7 @@
 
 // Standard C++ library includes
 #include <string>
+#include <vector>
 
 namespace fcn {
 
@@ -33,10 +34,27 @@ namespace fcn {
 	 * This is a helper class which allows to use UTF-8 strings in
 	 * your application.
 	 * 
+	 * Moving between characters takes constant time and editing doesn't
+	 * copy the text. Counting characters and finding offsets walk the
+	 * text, but skip runs of ASCII characters 16 bytes at a time when the
+	 * compiler targets SSE2.
+	 *
+	 * An editor object also keeps the byte offsets of every
+	 * CheckpointInterval-th character of the text it was last used on, so
+	 * countCharsIndexed and getOffsetIndexed only walk from the nearest
+	 * checkpoint. insertCharIndexed and eraseCharIndexed update the
+	 * checkpoints behind the edit. Changing the text in any other way
+	 * requires a call to invalidateIndex.
+	 *
 	 * @author Przemyslaw Grzywacz
 	 */
 	class UTF8StringEditor {
 	public:
+		/**
+		 * Constructor.
+		 */
+		UTF8StringEditor();
+
 		/**
 		 * Returns byte offset of the next character.
 		 * 
@@ -94,6 +112,106 @@ namespace fcn {
 		 * @return Byte offset of character at charIndex.
 		 */
 		static int getOffset(const std::string& text, int charIndex);
+
+		/**
+		 * Checks if a text is valid UTF-8. Runs of ASCII characters are
+		 * checked 16 bytes at a time, so this is cheap enough to call on
+		 * large pasted texts.
+		 *
+		 * @param text UTF-8 text to check.
+		 * @return True if the text is valid UTF-8, false otherwise.
+		 */
+		static bool isValid(const std::string& text);
+
+		/**
+		 * Counts characters up to byteOffset using the checkpoint index,
+		 * which is built first if it doesn't belong to the text.
+		 *
+		 * @param text UTF-8 text to navigate.
+		 * @param byteOffset Byte offset inside the text.
+		 * @return Number of characters.
+		 * @see countChars
+		 */
+		int countCharsIndexed(const std::string& text, int byteOffset);
+
+		/**
+		 * Gets byte offset for character index using the checkpoint
+		 * index, which is built first if it doesn't belong to the text.
+		 * Clips charIndex like getOffset.
+		 *
+		 * @param text UTF-8 text to navigate.
+		 * @param charIndex Character index to move to.
+		 * @return Byte offset of character at charIndex.
+		 * @see getOffset
+		 */
+		int getOffsetIndexed(const std::string& text, int charIndex);
+
+		/**
+		 * Insert a character at specified byte offset and update the
+		 * checkpoint index of the text.
+		 *
+		 * @param text UTF-8 text to modify.
+		 * @param byteOffset Byte offset where character will be inserted.
+		 * @param ch Unicode character to insert.
+		 * @return New byte offset (after the new character).
+		 * @see insertChar
+		 */
+		int insertCharIndexed(std::string& text, int byteOffset, int ch);
+
+		/**
+		 * Erase character at specified byte offset and update the
+		 * checkpoint index of the text.
+		 *
+		 * @param text UTF-8 text to modify.
+		 * @param byteOffset Byte offset of the character to erase.
+		 * @return New byte offset (is equal to byteOffset).
+		 * @see eraseChar
+		 */
+		int eraseCharIndexed(std::string& text, int byteOffset);
+
+		/**
+		 * Discards the checkpoint index. Has to be called when the
+		 * indexed text is changed other than by insertCharIndexed and
+		 * eraseCharIndexed, or when another text may take its place in
+		 * memory.
+		 */
+		void invalidateIndex();
+
+		/**
+		 * The number of characters between two checkpoints.
+		 */
+		static const int CheckpointInterval = 64;
+
+	protected:
+		/**
+		 * Builds the checkpoint index if it doesn't belong to a text.
+		 *
+		 * @param text UTF-8 text to index.
+		 */
+		void updateIndex(const std::string& text);
+
+		/**
+		 * The indexed text, NULL if there is no index.
+		 */
+		const std::string* mIndexedText;
+
+		/**
+		 * The size the indexed text had when it was last indexed or
+		 * edited through this editor.
+		 */
+		std::string::size_type mIndexedSize;
+
+		/**
+		 * The number of characters of the indexed text.
+		 */
+		int mIndexedChars;
+
+		/**
+		 * The byte offsets of character 0, CheckpointInterval,
+		 * 2 * CheckpointInterval and so on, up to the number of
+		 * characters of the indexed text.
+		 */
+		std::vector<int> mCheckpoints;
 	};
 
 };
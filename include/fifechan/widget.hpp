@@ -823,6 +823,42 @@ namespace fcn
          */
         virtual void requestMoveToBottom();
 
+        /**
+         * Requests the widget to be drawn again by ancestors which keep what
+         * they show of their children, such as a ScrollArea with scroll
+         * blitting enabled. Should be called when the appearance of the
+         * widget changes without the widget being resized, for instance when
+         * its selection changes.
+         *
+         * @see redrawChild, setRedrawRequesting
+         */
+        virtual void requestRedraw();
+
+        /**
+         * Sets whether the widget calls requestRedraw whenever its appearance
+         * changes without the widget being resized. Ancestors which keep what
+         * they show of their children only keep it for widgets which do, and
+         * draw other widgets every time. Subclasses changing their appearance
+         * in other ways, for instance by animating, have to call requestRedraw
+         * themselves or set this to false. False by default.
+         *
+         * @param requesting True if the widget requests to be drawn again when
+         *                   its appearance changes, false otherwise.
+         * @see isRedrawRequesting, requestRedraw
+         */
+        void setRedrawRequesting(bool requesting);
+
+        /**
+         * Checks whether the widget and all widgets inside it call
+         * requestRedraw whenever their appearance changes without them being
+         * resized.
+         *
+         * @return True if the widget and all widgets inside it request to be
+         *         drawn again when their appearance changes, false otherwise.
+         * @see setRedrawRequesting
+         */
+        bool isRedrawRequesting() const;
+
         /**
          * Called whenever a widget should draw itself. The function will
          * set up clip areas and call the draw function for this widget
@@ -1288,6 +1324,17 @@ namespace fcn
          */
         virtual void moveToBottom(Widget* widget);
 
+        /**
+         * Called when a child, or a widget inside a child, requests to be
+         * drawn again. Passes the request on to the parent of the widget.
+         * Widgets which keep what they show of their children overload it
+         * to draw the child again the next time they are drawn.
+         *
+         * @param widget The child which requested to be drawn again.
+         * @see requestRedraw
+         */
+        virtual void redrawChild(Widget* widget);
+
         /**
          * Focuses the next widget in the widget.
          * 
@@ -1501,6 +1548,17 @@ namespace fcn
          * @param ancestor Ancestor widget that was shown.
          */
         void distributeAncestorShownEvent(Widget* ancestor);
+
+        /**
+         * Draws the children of the widget, clipped by the children area.
+         * Called by _draw after draw if the widget has children. Widgets
+         * drawing their children in another way, such as a ScrollArea
+         * keeping its content in an offscreen image, overload it.
+         *
+         * @param graphics A graphics object to draw with.
+         * @see getChildrenArea
+         */
+        virtual void drawChildren(Graphics* graphics);
         
         /**
          * Adds a child to the widget.
@@ -1737,6 +1795,12 @@ namespace fcn
          */
         bool mEnabled;
 
+        /**
+         * True if the widget calls requestRedraw whenever its appearance
+         * changes, false otherwise.
+         */
+        bool mRedrawRequesting;
+
         /**
          * Holds the id of the widget.
          */
@@ -22,15 +22,18 @@
 #ifndef FCN_CURVEGRAPH_HPP
 #define FCN_CURVEGRAPH_HPP
 
+#include "fifechan/graphdatalistener.hpp"
+#include "fifechan/minmaxpyramid.hpp"
 #include "fifechan/point.hpp"
 #include "fifechan/widget.hpp"
 
 
 namespace fcn
 {
+    class GraphDataSource;
     class Graphics;
 
-    class FCN_CORE_DECLSPEC CurveGraph : public Widget {
+    class FCN_CORE_DECLSPEC CurveGraph : public Widget, public GraphDataListener {
     public:
 
         /**
@@ -42,16 +45,70 @@ namespace fcn
         /**
          * Destructor.
          */
-        virtual ~CurveGraph() { };
+        virtual ~CurveGraph();
 
         void setPointVector(const PointVector& data);
         const PointVector& getPointVector() const;
         void resetPointVector();
 
+        /**
+         * Appends a point. Cheaper than setting the whole vector, as only
+         * the new point has to be indexed for decimation and only the last
+         * segments of the curve have to be tessellated again.
+         *
+         * @param point The point to append.
+         */
+        void addPoint(const Point& point);
+
+        /**
+         * Sets a data source to draw instead of the point vector. The
+         * graph shows the window of the data source and only fetches the
+         * points that scroll into it. The data source is not owned by the
+         * graph.
+         *
+         * @param source The data source, NULL to draw the point vector.
+         * @see GraphDataSource
+         */
+        void setDataSource(GraphDataSource* source);
+
+        /**
+         * @return The data source, NULL if the point vector is drawn.
+         */
+        GraphDataSource* getDataSource() const;
+
         void setThickness(unsigned int thickness);
         unsigned int getThickness() const;
 
+        /**
+         * Sets whether the curve is fitted only through the lowest and
+         * highest point of every pixel column, when the x coordinates of
+         * the points never decrease and there are many points per column.
+         * Default is true.
+         *
+         * @param decimation True to enable decimation, false otherwise.
+         * @see MinMaxPyramid
+         */
+        void setDecimationEnabled(bool decimation);
+
+        /**
+         * @return Whether decimation is enabled or not.
+         */
+        bool isDecimationEnabled() const;
+
+        /**
+         * Sets whether the curve passes through the points, as a
+         * Catmull-Rom spline, or the points are the control points of
+         * cubic bezier segments, the last point of a segment being the
+         * first of the next. Default is true.
+         *
+         * @param acp True if the curve passes through the points, false
+         *            if the points are control points.
+         */
         void setAutomaticControllPoints(bool acp);
+
+        /**
+         * @return Whether the curve passes through the points or not.
+         */
         bool isAutomaticControllPoints() const;
 
         /**
@@ -71,25 +128,53 @@ namespace fcn
          */
         virtual void draw(Graphics* graphics);
 
+
+        // Inherited from GraphDataListener
+
+        virtual void pointsAppended(GraphDataSource* source, int count);
+
+        virtual void pointsRemoved(GraphDataSource* source, int count);
+
+        virtual void windowChanged(GraphDataSource* source);
+
+        virtual void graphDataSourceDeleted(GraphDataSource* source);
+
     protected:
-        /** Precalculate bezier curve.
+        /** Precalculate bezier curve. If points were only appended since
+         *  the last update, only the segments they change are tessellated.
          */
         void update();
 
-        /** Helper that returns an interpolated Point
+        /** Helper that tessellates the curve segments from a segment on,
+         *  replacing the tessellated points of these segments.
          */
-        Point getBezierPoint(const PointVector& points, int elements, float t);
+        void tessellate(const PointVector& points, unsigned int firstSegment);
 
-        /** Helper that adds the control points for bezier curves.
+        /** Helper that tessellates a cubic bezier segment by forward
+         *  differencing. The start point is only added for the first segment.
          */
-        void addControlPoints(const PointVector& points, PointVector& newPoints);
+        void addSegment(const double* x, const double* y, bool first);
 
         bool m_opaque;
         bool m_acp;
         bool m_needUpdate;
+        bool m_decimation;
         unsigned int m_thickness;
         PointVector m_data;
+        PointVector m_decimated;
         PointVector m_curveData;
+        MinMaxPyramid m_pyramid;
+
+        // index of the first tessellated point of each segment
+        std::vector<unsigned int> m_segmentStarts;
+        // number of points of m_data the curve was tessellated for, 0 if
+        // it has to be tessellated from scratch
+        unsigned int m_tessellatedPoints;
+
+        GraphDataSource* m_source;
+        int m_sourceStart;
+        int m_sourceEnd;
+        PointVector m_sourceData;
     };
 };
 
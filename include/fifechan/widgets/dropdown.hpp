@@ -65,10 +65,15 @@
 #ifndef FCN_DROPDOWN_HPP
 #define FCN_DROPDOWN_HPP
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "fifechan/actionlistener.hpp"
 #include "fifechan/focushandler.hpp"
 #include "fifechan/focuslistener.hpp"
 #include "fifechan/keylistener.hpp"
+#include "fifechan/listmodellistener.hpp"
 #include "fifechan/mouselistener.hpp"
 #include "fifechan/platform.hpp"
 #include "fifechan/selectionlistener.hpp"
@@ -95,10 +100,17 @@ namespace fcn
      * all selection listeners of the drop down. If an item is selected by
      * using a mouse click or by using the enter or space key an action event
      * will be sent to all action listeners of the drop down.
+     *
+     * Typing selects the first item, in alphabetical order, starting with
+     * the typed characters. Typing the same character again selects the
+     * next item starting with it. The items are looked up in a sorted index
+     * of the list model, which is rebuilt when the model tells that it has
+     * changed.
      */
     class FCN_CORE_DECLSPEC DropDown :
         public ActionListener,
         public KeyListener,
+        public ListModelListener,
         public MouseListener,
         public FocusListener,
         public SelectionListener,
@@ -241,7 +253,31 @@ namespace fcn
 
         virtual void valueChanged(const SelectionEvent& event);
 
+
+        // Inherited from ListModelListener
+
+        virtual void elementsInserted(ListModel* model, int first, int count);
+
+        virtual void elementsRemoved(ListModel* model, int first, int count);
+
+        virtual void elementsChanged(ListModel* model, int first, int count);
+
+        virtual void listModelDeleted(ListModel* model);
+
     protected:
+        /**
+         * Selects the item starting with the typed characters.
+         *
+         * @param text the typed character, UTF-8 encoded.
+         */
+        void typeAhead(const std::string& text);
+
+        /**
+         * Builds the prefix index if it is outdated, that is if the list
+         * model notified a change or holds a different number of elements.
+         */
+        void updatePrefixIndex();
+
         /**
          * Draws the button of the drop down.
          *
@@ -319,6 +355,27 @@ namespace fcn
          */
         bool mIsDragged;
 
+        /**
+         * The list model the drop down listens to for changes.
+         */
+        ListModel* mTypeAheadModel;
+
+        /**
+         * The characters typed so far.
+         */
+        std::string mTypeAheadPrefix;
+
+        /**
+         * The items with ASCII letters in lower case and their indices,
+         * sorted.
+         */
+        std::vector<std::pair<std::string, int> > mPrefixIndex;
+
+        /**
+         * True if the prefix index has to be rebuilt.
+         */
+        bool mPrefixIndexInvalid;
+
         /**
          * Typedef.
          */
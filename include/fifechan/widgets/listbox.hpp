@@ -65,12 +65,16 @@
 #ifndef FCN_LISTBOX_HPP
 #define FCN_LISTBOX_HPP
 
+#include <deque>
 #include <list>
+#include <string>
 
 #include "fifechan/keylistener.hpp"
 #include "fifechan/listmodel.hpp"
+#include "fifechan/listmodellistener.hpp"
 #include "fifechan/mouselistener.hpp"
 #include "fifechan/platform.hpp"
+#include "fifechan/rangeset.hpp"
 #include "fifechan/widget.hpp"
 
 namespace fcn
@@ -87,11 +91,22 @@ namespace fcn
      * all selection listeners of the list box. If an item is selected by using
      * a mouse click or by using the enter or space key an action event will be
      * sent to all action listeners of the list box.
+     *
+     * With multiple selection enabled, clicking a row with control held
+     * toggles it and clicking with shift held selects all rows from the
+     * row clicked last. The selected rows are kept as ranges, so a
+     * selection of any size takes little memory, and a single select event
+     * is sent for every change, holding the range of rows that changed.
+     *
+     * Only the rows inside the current clip area are fetched from the list
+     * model when drawing. For very large or generated models the list box
+     * can be virtualized, see setVirtualized.
      */
     class FCN_CORE_DECLSPEC ListBox :
         public Widget,
         public MouseListener,
-        public KeyListener
+        public KeyListener,
+        public ListModelListener
     {
     public:
         /**
@@ -109,10 +124,12 @@ namespace fcn
         /**
          * Destructor.
          */
-        virtual ~ListBox() { }
+        virtual ~ListBox();
 
         /**
-         * Gets the selected item as an index in the list model.
+         * Gets the selected item as an index in the list model. With
+         * multiple selection enabled, this is the item the selection was
+         * last changed at.
          *
          * @return the selected item as an index in the list model.
          * @see setSelected
@@ -121,13 +138,66 @@ namespace fcn
 
          /**
          * Sets the selected item. The selected item is represented by
-         * an index from the list model.
+         * an index from the list model. Any other selected items are
+         * deselected.
          *
          * @param selected the selected item as an index from the list model.
          * @see getSelected
          */
         void setSelected(int selected);
 
+        /**
+         * Sets the list box to allow selecting more than one item or not.
+         * Default is false.
+         *
+         * @param enabled True to allow multiple selection, false otherwise.
+         * @see isMultipleSelectionEnabled
+         */
+        void setMultipleSelectionEnabled(bool enabled);
+
+        /**
+         * Checks whether the list box allows selecting more than one item.
+         *
+         * @return True if multiple selection is enabled, false otherwise.
+         * @see setMultipleSelectionEnabled
+         */
+        bool isMultipleSelectionEnabled() const;
+
+        /**
+         * Checks if an item is selected.
+         *
+         * @param index The index of the item in the list model.
+         * @return True if the item is selected, false otherwise.
+         */
+        bool isSelected(int index) const;
+
+        /**
+         * Gets the selected items.
+         *
+         * @return The indexes of the selected items in the list model.
+         */
+        const RangeSet& getSelection() const;
+
+        /**
+         * Selects or deselects a range of items. If multiple selection is
+         * disabled, selecting a range selects only its first item.
+         *
+         * @param first The index of the first item in the list model.
+         * @param count The number of items.
+         * @param selected True to select the items, false to deselect them.
+         */
+        void setRangeSelected(int first, int count, bool selected);
+
+        /**
+         * Selects all items if multiple selection is enabled.
+         */
+        void selectAll();
+
+        /**
+         * Deselects all items.
+         */
+        void clearSelection();
+
         /**
          * Sets the list model to use.
          *
@@ -171,6 +241,33 @@ namespace fcn
          */
         void setWrappingEnabled(bool wrappingEnabled);
 
+        /**
+         * Sets the list box to be virtualized or not. A virtualized list
+         * box never walks the whole list model. It doesn't measure the
+         * elements, so its width is left as set by the user, and it keeps
+         * the elements of the rows it draws between frames, fetching only
+         * the rows that scroll into view or that the model reports as
+         * changed. The list model must therefore tell its listeners about
+         * every change. Default is false.
+         *
+         * NOTE: The height of the list box is still limited by its maximum
+         *       size, which has to be raised for lists with more than a
+         *       few thousand rows.
+         *
+
+         * @param virtualized True to virtualize the list box, false otherwise.
+         * @see isVirtualized, ListModelListener
+         */
+        void setVirtualized(bool virtualized);
+
+        /**
+         * Checks whether the list box is virtualized.
+         *
+         * @return True if the list box is virtualized, false otherwise.
+         * @see setVirtualized
+         */
+        bool isVirtualized() const;
+
         /**
          * Adds a selection listener to the list box. When the selection
          * changes an event will be sent to all selection listeners of the
@@ -224,19 +321,111 @@ namespace fcn
         virtual void mouseDragged(MouseEvent& mouseEvent);
 
 
+        // Inherited from ListModelListener
+
+        virtual void elementsInserted(ListModel* model, int first, int count);
+
+        virtual void elementsRemoved(ListModel* model, int first, int count);
+
+        virtual void elementsChanged(ListModel* model, int first, int count);
+
+        virtual void listModelDeleted(ListModel* model);
+
+
     protected:
+        /**
+         * Gets the element of a row for drawing. Uses the element pointer
+         * of the list model if it has one, otherwise the cached element of
+         * the row if the list box is virtualized, otherwise fetches the
+         * element into a scratch string.
+         *
+         * @param row The row, which must be cached if the list box is
+         *            virtualized.
+         * @return The element of the row.
+         */
+        const std::string& getRowElement(int row);
+
+        /**
+         * Makes the cache of a virtualized list box hold exactly the given
+         * rows, keeping the cached elements of rows already in it.
+         *
+         * @param startRow The first row to cache.
+         * @param endRow The row after the last row to cache.
+         */
+        void updateRowCache(int startRow, int endRow);
+
+        /**
+         * Removes the cached rows from a row on.
+         *
+         * @param row The first row to remove from the cache.
+         */
+        void truncateRowCache(int row);
+
+        /**
+         * Replaces or extends the selection with a range of items and
+         * scrolls to the item the selection was changed at.
+         *
+         * @param lead The item the selection was changed at, -1 if none.
+         * @param first The index of the first item to select.
+         * @param count The number of items to select.
+         * @param extend True to keep the selected items, false to
+         *               deselect them first.
+         */
+        void changeSelection(int lead, int first, int count, bool extend);
+
+        /**
+         * Moves the selection to an item, extending it from the anchor if
+         * shift is held and multiple selection is enabled.
+         *
+         * @param index The item to move the selection to.
+         * @param keyEvent The key event moving the selection.
+         */
+        void moveSelection(int index, KeyEvent& keyEvent);
+
+        /**
+         * Moves the lead to the first selected item if the lead is no
+         * longer selected, or to -1 if nothing is selected.
+         */
+        void updateLead();
+
+        /**
+         * Scrolls a row into view.
+         *
+         * @param row The row, -1 to scroll to the top.
+         */
+        void showRow(int row);
+
         /**
          * Distributes a value changed event to all selection listeners
          * of the list box.
          *
+         * @param first The first row whose selection may have changed, -1
+         *              if not known.
+         * @param count The number of rows whose selection may have changed.
          */
-        void distributeValueChangedEvent();
+        void distributeValueChangedEvent(int first, int count);
 
         /**
          * The selected item as an index in the list model.
          */
         int mSelected;
 
+        /**
+         * The item a range selected with shift starts at, -1 if none.
+         */
+        int mAnchor;
+
+        /**
+         * The selected items. Holds mSelected alone if multiple selection
+         * is disabled.
+         */
+        RangeSet mSelection;
+
+        /**
+         * True if multiple selection is enabled, false otherwise.
+         */
+        bool mMultipleSelection;
+
         /**
          * The list model to use.
          */
@@ -247,6 +436,42 @@ namespace fcn
          */
         bool mWrappingEnabled;
 
+        /**
+         * True if the list box is virtualized, false otherwise.
+         */
+        bool mVirtualized;
+
+        /**
+         * The number of elements the size of the list box was last
+         * adjusted to, -1 if the size has to be adjusted.
+         */
+        int mAdjustedElements;
+
+        /**
+         * A cached element of a virtualized list box.
+         */
+        struct CachedRow
+        {
+            std::string element;
+            bool valid;
+        };
+
+        /**
+         * The cached elements of the rows drawn last, starting at
+         * mFirstCachedRow.
+         */
+        std::deque<CachedRow> mCachedRows;
+
+        /**
+         * The row of the first cached element.
+         */
+        int mFirstCachedRow;
+
+        /**
+         * Holds fetched elements when they are not cached.
+         */
+        std::string mRowElement;
+
         /**
          * Typdef.
          */
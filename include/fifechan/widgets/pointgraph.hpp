@@ -22,15 +22,18 @@
 #ifndef FCN_POINTGRAPH_HPP
 #define FCN_POINTGRAPH_HPP
 
+#include "fifechan/graphdatalistener.hpp"
+#include "fifechan/minmaxpyramid.hpp"
 #include "fifechan/point.hpp"
 #include "fifechan/widget.hpp"
 
 
 namespace fcn
 {
+    class GraphDataSource;
     class Graphics;
 
-    class FCN_CORE_DECLSPEC PointGraph : public Widget {
+    class FCN_CORE_DECLSPEC PointGraph : public Widget, public GraphDataListener {
     public:
 
         /**
@@ -42,15 +45,55 @@ namespace fcn
         /**
          * Destructor.
          */
-        virtual ~PointGraph() { };
+        virtual ~PointGraph();
 
         void setPointVector(const PointVector& data);
         const PointVector& getPointVector() const;
         void resetPointVector();
 
+        /**
+         * Appends a point. Cheaper than setting the whole vector, as only
+         * the new point has to be indexed for decimation.
+         *
+         * @param point The point to append.
+         */
+        void addPoint(const Point& point);
+
+        /**
+         * Sets a data source to draw instead of the point vector. The
+         * graph shows the window of the data source and only fetches the
+         * points that scroll into it. The data source is not owned by the
+         * graph.
+         *
+         * @param source The data source, NULL to draw the point vector.
+         * @see GraphDataSource
+         */
+        void setDataSource(GraphDataSource* source);
+
+        /**
+         * @return The data source, NULL if the point vector is drawn.
+         */
+        GraphDataSource* getDataSource() const;
+
         void setThickness(unsigned int thickness);
         unsigned int getThickness() const;
 
+        /**
+         * Sets whether the graph draws only the lowest and highest point
+         * of every pixel column, when the x coordinates of the points never
+         * decrease and there are many points per column. Points between
+         * the extremes of a column are not drawn then. Default is true.
+         *
+         * @param decimation True to enable decimation, false otherwise.
+         * @see MinMaxPyramid
+         */
+        void setDecimationEnabled(bool decimation);
+
+        /**
+         * @return Whether decimation is enabled or not.
+         */
+        bool isDecimationEnabled() const;
+
         /**
          * Sets the opacity of the graph.
          * 
@@ -68,10 +111,30 @@ namespace fcn
          */
         virtual void draw(Graphics* graphics);
 
+
+        // Inherited from GraphDataListener
+
+        virtual void pointsAppended(GraphDataSource* source, int count);
+
+        virtual void pointsRemoved(GraphDataSource* source, int count);
+
+        virtual void windowChanged(GraphDataSource* source);
+
+        virtual void graphDataSourceDeleted(GraphDataSource* source);
+
     protected:
         bool m_opaque;
+        bool m_decimation;
         unsigned int m_thickness;
         PointVector m_data;
+        PointVector m_decimated;
+        MinMaxPyramid m_pyramid;
+
+        GraphDataSource* m_source;
+        bool m_sourceChanged;
+        int m_sourceStart;
+        int m_sourceEnd;
+        PointVector m_sourceData;
     };
 };
 
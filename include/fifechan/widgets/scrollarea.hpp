@@ -67,16 +67,26 @@
 
 #include <string>
 
+#include "fifechan/color.hpp"
 #include "fifechan/mouselistener.hpp"
 #include "fifechan/platform.hpp"
 #include "fifechan/widget.hpp"
 
 namespace fcn
 {
+    class Image;
+
     /**
      * Implementation if a scrollable area used to view widgets larger than the scroll area.
+     *
      * A scroll area can be customized to always show scroll bars or to show them only when
      * necessary.
+     *
+     * With scroll blitting enabled the scroll area keeps what it showed of its content
+     * in an offscreen image. When scrolled the image is moved by the scroll distance and
+     * only the newly exposed strip of the content is drawn.
+     *
+     * @see setScrollBlittingEnabled
      */
     class FCN_CORE_DECLSPEC ScrollArea:
         public MouseListener,
@@ -343,6 +353,45 @@ namespace fcn
          * @return True if the scroll area is opaque, false otherwise.
          */
         bool isOpaque() const;
+
+        /**
+         * Sets the scroll area to keep what it shows of its content in an offscreen
+         * image, and to draw only the part of the content scrolled into view. The
+         * content is drawn completely when the scroll area or the content is resized,
+         * the background color changes or invalidateContent is called.
+         *
+         * Content changing without being resized, for instance a moved caret or a
+         * changed selection, has to call Widget::requestRedraw, otherwise it is not
+         * drawn until invalidateContent is called. The offscreen image is therefore
+         * only used if the content and every widget inside it are marked with
+         * Widget::setRedrawRequesting, which ListBox, TextBox, Table and TreeView
+         * are. Other content, such as a container or a widget which animates, is
+         * drawn as usual every time. Scroll blitting is also only used for opaque
+         * scroll areas with an opaque background color, and with Graphics objects
+         * which can draw to images. Disabled by default.
+         *
+         * @param enabled True to enable scroll blitting, false otherwise.
+         * @see isScrollBlittingEnabled, invalidateContent, Widget::requestRedraw,
+         *      Widget::setRedrawRequesting, Graphics::createTarget
+         */
+        void setScrollBlittingEnabled(bool enabled);
+
+        /**
+         * Checks if scroll blitting is enabled.
+         *
+         * @return True if scroll blitting is enabled, false otherwise.
+         * @see setScrollBlittingEnabled
+         */
+        bool isScrollBlittingEnabled() const;
+
+        /**
+         * Makes the scroll area draw all of its visible content the next time it is
+         * drawn. Should be called when the content changes while scroll blitting is
+         * enabled.
+         *
+         * @see setScrollBlittingEnabled
+         */
+        void invalidateContent();
         
         
         // Inherited from BasicContainer
@@ -372,6 +421,8 @@ namespace fcn
 
         virtual void expandContent(bool recursiv=true);
 
+        virtual void redrawChild(Widget* widget);
+
         // Inherited from MouseListener
 
         virtual void mousePressed(MouseEvent& mouseEvent);
@@ -397,6 +448,19 @@ namespace fcn
          */
         virtual void drawBackground(Graphics *graphics);
 
+        /**
+         * Draws a part of the content to the offscreen image of the scroll area,
+         * on top of the background.
+         *
+         * @param graphics a Graphics object drawing to the offscreen image.
+         * @param area the part of the children area to draw.
+         */
+        virtual void drawContentArea(Graphics* graphics, const Rectangle& area);
+
+        // Inherited from Widget
+
+        virtual void drawChildren(Graphics* graphics);
+
         /**
          * Draws the up button.
          *
@@ -614,6 +678,39 @@ namespace fcn
          * display its background), false otherwise.
          */
         bool mOpaque;
+
+        /**
+         * True if scroll blitting is enabled, false otherwise.
+         */
+        bool mScrollBlitting;
+
+        /**
+         * Holds the offscreen image of the children area, NULL if there
+         * is none.
+         */
+        Image* mBuffer;
+
+        /**
+         * Holds the Graphics object the offscreen image was created with.
+         */
+        Graphics* mBufferGraphics;
+
+        /**
+         * True if the offscreen image shows the content, false if the
+         * content has to be drawn completely.
+         */
+        bool mBufferValid;
+
+        /**
+         * Holds the dimension of the content when the offscreen image
+         * was drawn.
+         */
+        Rectangle mBufferContentDimension;
+
+        /**
+         * Holds the background color the offscreen image was drawn with.
+         */
+        Color mBufferBackgroundColor;
     };
 }
 
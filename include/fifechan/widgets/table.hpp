@@ -0,0 +1,461 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TABLE_HPP
+#define FCN_TABLE_HPP
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "fifechan/keylistener.hpp"
+#include "fifechan/mouselistener.hpp"
+#include "fifechan/platform.hpp"
+#include "fifechan/tablecellrenderer.hpp"
+#include "fifechan/tablemodellistener.hpp"
+#include "fifechan/widget.hpp"
+
+namespace fcn
+{
+    class SelectionListener;
+    class TableModel;
+
+    /**
+     * A table of string elements provided by a TableModel, with a row
+     * that can be selected. It is meant to be put in a ScrollArea.
+     *
+     * The table doesn't create a widget per cell. It only asks the model
+     * for the cells inside the current clip area and draws them with a
+     * TableCellRenderer, so scrolling a table with a million rows costs as
+     * much as scrolling one with a hundred.
+     *
+     * Rows have the same height by default. With variable row heights
+     * enabled the heights are asked from the model and the positions of
+     * the rows are kept in a Fenwick tree, which finds the row at a
+     * position in logarithmic time. The tree is rebuilt when rows are
+     * inserted or removed.
+     *
+     * The header with the names of the columns stays at the top of the
+     * visible area when the table is scrolled.
+     *
+     * If a row is selected a select event will be sent to all selection
+     * listeners of the table. If a row is selected by using a mouse click
+     * or by using the enter or space key an action event will be sent to
+     * all action listeners of the table.
+     */
+    class FCN_CORE_DECLSPEC Table :
+        public Widget,
+        public MouseListener,
+        public KeyListener,
+        public TableModelListener
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        Table();
+
+        /**
+         * Constructor.
+         *
+         * @param tableModel the table model to use.
+         */
+        Table(TableModel* tableModel);
+
+        /**
+         * Destructor.
+         */
+        virtual ~Table();
+
+        /**
+         * Sets the table model to use.
+         *
+         * @param tableModel the table model to use.
+         * @see getTableModel
+         */
+        void setTableModel(TableModel* tableModel);
+
+        /**
+         * Gets the table model used.
+         *
+         * @return the table model used.
+         * @see setTableModel
+         */
+        TableModel* getTableModel() const;
+
+        /**
+         * Gets the selected row.
+         *
+         * @return the selected row, -1 if no row is selected.
+         * @see setSelected
+         */
+        int getSelected() const;
+
+        /**
+         * Sets the selected row and scrolls it into view.
+         *
+         * @param selected the row to select, -1 to select no row.
+         * @see getSelected
+         */
+        void setSelected(int selected);
+
+        /**
+         * Sets the cell renderer used to draw the cells. The renderer is
+         * not owned by the table.
+         *
+         * @param cellRenderer the cell renderer, NULL to use the default
+         *                     renderer which draws the elements as text.
+         * @see getCellRenderer
+         */
+        void setCellRenderer(TableCellRenderer* cellRenderer);
+
+        /**
+         * Gets the cell renderer used to draw the cells.
+         *
+         * @return the cell renderer.
+         * @see setCellRenderer
+         */
+        TableCellRenderer* getCellRenderer() const;
+
+        /**
+         * Sets the width of a column.
+         *
+         * @param column the column.
+         * @param width the width of the column.
+         * @see getColumnWidth, setDefaultColumnWidth
+         */
+        void setColumnWidth(int column, int width);
+
+        /**
+         * Gets the width of a column.
+         *
+         * @param column the column.
+         * @return the width of the column.
+         * @see setColumnWidth
+         */
+        int getColumnWidth(int column) const;
+
+        /**
+         * Sets the width of columns without a width of their own. Default
+         * is 100.
+         *
+         * @param width the width of the columns.
+         * @see getDefaultColumnWidth, setColumnWidth
+         */
+        void setDefaultColumnWidth(int width);
+
+        /**
+         * Gets the width of columns without a width of their own.
+         *
+         * @return the width of the columns.
+         * @see setDefaultColumnWidth
+         */
+        int getDefaultColumnWidth() const;
+
+        /**
+         * Sets the height of the rows.
+         *
+         * @param height the height of the rows, 0 to use the font height
+         *               plus two pixels, which is the default.
+         * @see getRowHeight
+         */
+        void setRowHeight(unsigned int height);
+
+        /**
+         * Gets the height of the rows. With variable row heights enabled
+         * this is the height of rows for which the model returns 0.
+         *
+         * @return the height of the rows.
+         * @see setRowHeight
+         */
+        unsigned int getRowHeight() const;
+
+        /**
+         * Sets the table to ask the model for the height of every row or
+         * not. Default is false.
+         *
+         * @param enabled true to enable variable row heights, false
+         *                otherwise.
+         * @see isVariableRowHeightsEnabled, TableModel::getRowHeight
+         */
+        void setVariableRowHeightsEnabled(bool enabled);
+
+        /**
+         * Checks whether the table asks the model for the height of every
+         * row.
+         *
+         * @return true if variable row heights are enabled, false
+         *         otherwise.
+         * @see setVariableRowHeightsEnabled
+         */
+        bool isVariableRowHeightsEnabled() const;
+
+        /**
+         * Sets the header with the names of the columns visible or not.
+         * Default is true.
+         *
+         * @param visible true if the header should be visible, false
+         *                otherwise.
+         * @see isHeaderVisible
+         */
+        void setHeaderVisible(bool visible);
+
+        /**
+         * Checks whether the header is visible.
+         *
+         * @return true if the header is visible, false otherwise.
+         * @see setHeaderVisible
+         */
+        bool isHeaderVisible() const;
+
+        /**
+         * Gets the height of the header.
+         *
+         * @return the height of the header, 0 if it isn't visible.
+         */
+        int getHeaderHeight() const;
+
+        /**
+         * Gets the position of a row, relative to the first row.
+         *
+         * @param row the row.
+         * @return the y coordinate of the row below the header.
+         */
+        int getRowPosition(int row) const;
+
+        /**
+         * Gets the height of a row.
+         *
+         * @param row the row.
+         * @return the height of the row.
+         */
+        int getRowHeight(int row) const;
+
+        /**
+         * Gets the row at a position, relative to the first row.
+         *
+         * @param y the y coordinate below the header.
+         * @return the row at the position, -1 if there is none.
+         */
+        int getRowAt(int y) const;
+
+        /**
+         * Gets the column at a position.
+         *
+         * @param x the x coordinate.
+         * @return the column at the position, -1 if there is none.
+         */
+        int getColumnAt(int x) const;
+
+        /**
+         * Adds a selection listener to the table. When the selection
+         * changes an event will be sent to all selection listeners of the
+         * table.
+         *
+         * If you delete your selection listener, be sure to also remove it
+         * using removeSelectionListener().
+         *
+         * @param selectionListener The selection listener to add.
+         */
+        void addSelectionListener(SelectionListener* selectionListener);
+
+        /**
+         * Removes a selection listener from the table.
+         *
+         * @param selectionListener The selection listener to remove.
+         */
+        void removeSelectionListener(SelectionListener* selectionListener);
+
+
+        // Inherited from Widget
+
+        virtual void resizeToContent(bool recursiv=true);
+
+        virtual void adjustSize();
+
+        virtual void draw(Graphics* graphics);
+
+        virtual void logic();
+
+
+        // Inherited from KeyListener
+
+        virtual void keyPressed(KeyEvent& keyEvent);
+
+
+        // Inherited from MouseListener
+
+        virtual void mousePressed(MouseEvent& mouseEvent);
+
+        virtual void mouseDragged(MouseEvent& mouseEvent);
+
+
+        // Inherited from TableModelListener
+
+        virtual void rowsInserted(TableModel* model, int first, int count);
+
+        virtual void rowsRemoved(TableModel* model, int first, int count);
+
+        virtual void rowsChanged(TableModel* model, int first, int count);
+
+        virtual void columnsChanged(TableModel* model);
+
+        virtual void tableModelDeleted(TableModel* model);
+
+    protected:
+        /**
+         * Draws the header at a position.
+         *
+         * @param graphics the graphics object to draw with.
+         * @param y the y coordinate of the header.
+         */
+        virtual void drawHeader(Graphics* graphics, int y);
+
+        /**
+         * Gets the element of a cell for drawing. Uses the element pointer
+         * of the table model if it has one, otherwise fetches the element
+         * into a scratch string.
+         *
+         * @param row the row of the cell.
+         * @param column the column of the cell.
+         * @return the element of the cell.
+         */
+        const std::string& getCellElement(int row, int column);
+
+        /**
+         * Rebuilds the index of the row positions if it is invalid, and
+         * applies the heights of changed rows to it.
+         */
+        void updateRowIndex() const;
+
+        /**
+         * Distributes a value changed event to all selection listeners
+         * of the table.
+         */
+        void distributeValueChangedEvent();
+
+        /**
+         * The table model to use.
+         */
+        TableModel* mTableModel;
+
+        /**
+         * The selected row, -1 if no row is selected.
+         */
+        int mSelected;
+
+        /**
+         * The renderer drawing the cells.
+         */
+        TableCellRenderer* mCellRenderer;
+
+        /**
+         * The renderer used when no renderer is set.
+         */
+        TableCellRenderer mDefaultCellRenderer;
+
+        /**
+         * The widths of the columns, -1 for the default width.
+         */
+        std::vector<int> mColumnWidths;
+
+        /**
+         * The width of columns without a width of their own.
+         */
+        int mDefaultColumnWidth;
+
+        /**
+         * The height of the rows, 0 for the font height plus two.
+         */
+        unsigned int mRowHeight;
+
+        /**
+         * True if variable row heights are enabled, false otherwise.
+         */
+        bool mVariableRowHeights;
+
+        /**
+         * True if the header is visible, false otherwise.
+         */
+        bool mHeaderVisible;
+
+        /**
+         * The y coordinate the header was drawn at last, used to tell
+         * clicks on the header from clicks on rows.
+         */
+        int mHeaderY;
+
+        /**
+         * The number of rows the size of the table was last adjusted to,
+         * -1 if the size has to be adjusted.
+         */
+        int mAdjustedRows;
+
+        /**
+         * The heights of the rows, used with variable row heights.
+         */
+        mutable std::vector<int> mRowHeights;
+
+        /**
+         * A Fenwick tree over mRowHeights. Every node holds the sum of the
+         * heights of the rows it covers.
+         */
+        mutable std::vector<int> mRowIndex;
+
+        /**
+         * Rows whose height may have changed since the index was updated.
+         */
+        mutable std::vector<int> mChangedRows;
+
+        /**
+         * True if the index has to be rebuilt.
+         */
+        mutable bool mRowIndexInvalid;
+
+        /**
+         * The row height the index was built with.
+         */
+        mutable int mIndexedRowHeight;
+
+        /**
+         * Holds fetched elements when the model has no element pointers.
+         */
+        std::string mCellElement;
+
+        /**
+         * Typdef.
+         */
+        typedef std::list<SelectionListener*> SelectionListenerList;
+
+        /**
+         * The selection listeners of the table.
+         */
+        SelectionListenerList mSelectionListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef SelectionListenerList::iterator SelectionListenerIterator;
+    };
+}
+
+#endif // end FCN_TABLE_HPP
@@ -225,6 +225,39 @@ namespace fcn
          */
         virtual void addRow(const std::string &row);
 
+        /**
+         * Appends a row of text to the end of the text, for using the text
+         * box as a log console. Unlike addRow the size of the text box is
+         * not adjusted right away; the rows appended during a frame are
+         * laid out together in logic(). If the bottom of the text box was
+         * visible in its scroll area it is kept visible.
+         *
+         * As only the widths of the new rows are measured, the text box
+         * doesn't get narrower when its widest row is removed because of
+         * the maximum number of rows. Call adjustSize to fit it again.
+         *
+         * @param row The row to append.
+         * @see setMaximumRows
+         */
+        virtual void appendRow(const std::string& row);
+
+        /**
+         * Sets the maximum number of rows of the text. When rows are added
+         * or appended beyond the maximum, the first rows are removed.
+         *
+         * @param rows The maximum number of rows, 0 for no maximum.
+         * @see getMaximumRows
+         */
+        void setMaximumRows(unsigned int rows);
+
+        /**
+         * Gets the maximum number of rows of the text.
+         *
+         * @return The maximum number of rows, 0 if there is no maximum.
+         * @see setMaximumRows
+         */
+        unsigned int getMaximumRows() const;
+
         /**
          * Checks if the text box is opaque. An opaque text box will draw
          * it's background and it's text. A non opaque text box only draw it's
@@ -252,6 +285,8 @@ namespace fcn
 
         virtual void fontChanged();
 
+        virtual void logic();
+
         virtual void resizeToContent(bool recursiv=true);
         /**
          * Adjusts the text box's size to fit the text.
@@ -296,6 +331,22 @@ namespace fcn
          * @param y the y position.
          */
         virtual void drawCaret(Graphics* graphics, int x, int y);
+
+        /**
+         * Removes the first rows of the text if it has more rows than
+         * the maximum.
+         *
+         * @return The number of rows removed.
+         */
+        unsigned int removeExcessRows();
+
+        /**
+         * Gets the row the caret is in without copying it, so the string
+         * editor can keep its character index of the row.
+         *
+         * @return The row the caret is in.
+         */
+        const std::string& getCaretRowText() const;
         
         /**
          * Holds the text of the text box.
@@ -316,6 +367,28 @@ namespace fcn
          * UTF8StringEditor for UTF8 support.
          */
         UTF8StringEditor* mStringEditor;
+
+        /**
+         * Holds the maximum number of rows, 0 if there is no maximum.
+         */
+        unsigned int mMaximumRows;
+
+        /**
+         * True if rows have been appended since the last layout.
+         */
+        bool mLayoutPending;
+
+        /**
+         * Holds the width needed by the rows appended since the last
+         * layout.
+         */
+        int mPendingWidth;
+
+        /**
+         * Holds the number of rows removed from the beginning of the text
+         * since the last layout.
+         */
+        unsigned int mPendingRemovedRows;
     };
 }
 
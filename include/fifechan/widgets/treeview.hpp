@@ -0,0 +1,385 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FCN_TREEVIEW_HPP
+#define FCN_TREEVIEW_HPP
+
+#include <list>
+#include <map>
+
+#include "fifechan/keylistener.hpp"
+#include "fifechan/mouselistener.hpp"
+#include "fifechan/platform.hpp"
+#include "fifechan/treemodellistener.hpp"
+#include "fifechan/widget.hpp"
+
+namespace fcn
+{
+    class SelectionListener;
+    class TreeModel;
+
+    /**
+     * A tree of nodes provided by a TreeModel, shown as one row per node
+     * with the children of expanded nodes below them. It is meant to be
+     * put in a ScrollArea.
+     *
+     * The tree view doesn't create a widget per node and never walks the
+     * expanded nodes. It only keeps the expanded nodes, each with its
+     * number of visible descendants, and finds the node of a row by
+     * descending them. Expanding a node only asks the model for its number
+     * of children, so it costs the same for a hundred children as for a
+     * hundred thousand. Only the rows inside the current clip area are
+     * fetched from the model and drawn.
+     *
+     * Like a virtualized ListBox, the tree view doesn't measure the nodes,
+     * so its width is left as set by the user.
+     *
+     * If a row is selected a select event will be sent to all selection
+     * listeners of the tree view. If a row is selected by using a mouse
+     * click or by using the enter or space key an action event will be
+     * sent to all action listeners of the tree view.
+     */
+    class FCN_CORE_DECLSPEC TreeView :
+        public Widget,
+        public MouseListener,
+        public KeyListener,
+        public TreeModelListener
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        TreeView();
+
+        /**
+         * Constructor.
+         *
+         * @param treeModel the tree model to use.
+         */
+        TreeView(TreeModel* treeModel);
+
+        /**
+         * Destructor.
+         */
+        virtual ~TreeView();
+
+        /**
+         * Sets the tree model to use. All nodes are collapsed.
+         *
+         * @param treeModel the tree model to use.
+         * @see getTreeModel
+         */
+        void setTreeModel(TreeModel* treeModel);
+
+        /**
+         * Gets the tree model used.
+         *
+         * @return the tree model used.
+         * @see setTreeModel
+         */
+        TreeModel* getTreeModel() const;
+
+        /**
+         * Gets the number of visible rows, that is the number of top level
+         * nodes plus the number of visible descendants of expanded nodes.
+         *
+         * @return the number of rows.
+         */
+        int getNumberOfRows() const;
+
+        /**
+         * Gets the node of a row.
+         *
+         * @param row the row.
+         * @return the node of the row, NULL if there is no such row.
+         */
+        void* getNodeAt(int row) const;
+
+        /**
+         * Gets the level of a row, 0 for top level nodes.
+         *
+         * @param row the row.
+         * @return the level of the row, -1 if there is no such row.
+         */
+        int getLevel(int row) const;
+
+        /**
+         * Gets the row at a position.
+         *
+         * @param y the y coordinate.
+         * @return the row at the position, -1 if there is none.
+         */
+        int getRowAt(int y) const;
+
+        /**
+         * Expands or collapses the node of a row. Nodes without children
+         * are not expanded. Collapsing a node forgets which of its
+         * descendants were expanded.
+         *
+         * @param row the row.
+         * @param expanded true to expand the node, false to collapse it.
+         * @see isExpanded
+         */
+        void setExpanded(int row, bool expanded);
+
+        /**
+         * Checks whether the node of a row is expanded.
+         *
+         * @param row the row.
+         * @return true if the node is expanded, false otherwise.
+         * @see setExpanded
+         */
+        bool isExpanded(int row) const;
+
+        /**
+         * Gets the selected row.
+         *
+         * @return the selected row, -1 if no row is selected.
+         * @see setSelected
+         */
+        int getSelected() const;
+
+        /**
+         * Sets the selected row and scrolls it into view.
+         *
+         * @param selected the row to select, -1 to select no row.
+         * @see getSelected
+         */
+        void setSelected(int selected);
+
+        /**
+         * Gets the node of the selected row.
+         *
+         * @return the selected node, NULL if no row is selected.
+         */
+        void* getSelectedNode() const;
+
+        /**
+         * Sets the number of pixels a level is indented by. Default is 12.
+         *
+         * @param indentation the indentation of a level.
+         * @see getIndentation
+         */
+        void setIndentation(int indentation);
+
+        /**
+         * Gets the number of pixels a level is indented by.
+         *
+         * @return the indentation of a level.
+         * @see setIndentation
+         */
+        int getIndentation() const;
+
+        /**
+         * Gets the height of a row. Should be overridden if another row
+         * height than the font height is preferred.
+         *
+         * @return The height of a row.
+         */
+        virtual unsigned int getRowHeight() const;
+
+        /**
+         * Adds a selection listener to the tree view. When the selection
+         * changes an event will be sent to all selection listeners of the
+         * tree view.
+         *
+         * If you delete your selection listener, be sure to also remove it
+         * using removeSelectionListener().
+         *
+         * @param selectionListener The selection listener to add.
+         */
+        void addSelectionListener(SelectionListener* selectionListener);
+
+        /**
+         * Removes a selection listener from the tree view.
+         *
+         * @param selectionListener The selection listener to remove.
+         */
+        void removeSelectionListener(SelectionListener* selectionListener);
+
+
+        // Inherited from Widget
+
+        virtual void resizeToContent(bool recursiv=true);
+
+        virtual void adjustSize();
+
+        virtual void draw(Graphics* graphics);
+
+        virtual void logic();
+
+
+        // Inherited from KeyListener
+
+        virtual void keyPressed(KeyEvent& keyEvent);
+
+
+        // Inherited from MouseListener
+
+        virtual void mousePressed(MouseEvent& mouseEvent);
+
+        virtual void mouseDragged(MouseEvent& mouseEvent);
+
+
+        // Inherited from TreeModelListener
+
+        virtual void childrenChanged(TreeModel* model, void* node);
+
+        virtual void treeModelDeleted(TreeModel* model);
+
+    protected:
+        /**
+         * An expanded node.
+         */
+        struct ExpandedNode
+        {
+            /**
+             * The handle of the node, NULL for the root.
+             */
+            void* node;
+
+            /**
+             * The expanded parent, NULL for the root.
+             */
+            ExpandedNode* parent;
+
+            /**
+             * The index of the node among the children of its parent.
+             */
+            int index;
+
+            /**
+             * The level of the children of the node.
+             */
+            int level;
+
+            /**
+             * The number of visible rows below the node, that is its
+             * children and the visible descendants of expanded children.
+             */
+            int descendants;
+
+            /**
+             * The expanded children, by index.
+             */
+            std::map<int, ExpandedNode*> children;
+        };
+
+        /**
+         * Draws the box showing whether a node is expanded.
+         *
+         * @param graphics the graphics object to draw with.
+         * @param x the x coordinate of the level of the node.
+         * @param y the y coordinate of the row of the node.
+         * @param expanded true if the node is expanded, false otherwise.
+         */
+        virtual void drawExpander(Graphics* graphics, int x, int y, bool expanded);
+
+        /**
+         * Finds the expanded parent of a row and the index of the node
+         * of the row among the children of the parent.
+         *
+         * @param row the row.
+         * @param parent set to the expanded parent.
+         * @param index set to the index of the node of the row.
+         * @return false if there is no such row, true otherwise.
+         */
+        bool findRow(int row, ExpandedNode*& parent, int& index) const;
+
+        /**
+         * Gets the row of an expanded node.
+         *
+         * @param node the expanded node.
+         * @return the row of the node, -1 for the root.
+         */
+        int getRowOf(const ExpandedNode* node) const;
+
+        /**
+         * Adds rows to the number of visible descendants of an expanded
+         * node and its ancestors.
+         *
+         * @param node the expanded node.
+         * @param rows the number of rows to add, negative to remove rows.
+         */
+        void addDescendants(ExpandedNode* node, int rows);
+
+        /**
+         * Deletes the expanded children of an expanded node.
+         *
+         * @param node the expanded node.
+         */
+        void clearChildren(ExpandedNode* node);
+
+        /**
+         * Collapses all nodes and reads the top level nodes from the model.
+         */
+        void reset();
+
+        /**
+         * Distributes a value changed event to all selection listeners
+         * of the tree view.
+         */
+        void distributeValueChangedEvent();
+
+        /**
+         * The tree model to use.
+         */
+        TreeModel* mTreeModel;
+
+        /**
+         * The invisible root, which is always expanded.
+         */
+        ExpandedNode mRoot;
+
+        /**
+         * The expanded nodes by their handles.
+         */
+        std::map<void*, ExpandedNode*> mExpandedNodes;
+
+        /**
+         * The selected row, -1 if no row is selected.
+         */
+        int mSelected;
+
+        /**
+         * The indentation of a level.
+         */
+        int mIndentation;
+
+        /**
+         * Typdef.
+         */
+        typedef std::list<SelectionListener*> SelectionListenerList;
+
+        /**
+         * The selection listeners of the tree view.
+         */
+        SelectionListenerList mSelectionListeners;
+
+        /**
+         * Typedef.
+         */
+        typedef SelectionListenerList::iterator SelectionListenerIterator;
+    };
+}
+
+#endif // end FCN_TREEVIEW_HPP
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/cachedfont.hpp"
+
+#include "fifechan/exception.hpp"
+
+namespace fcn
+{
+    CachedFont::CachedFont(Font* font, unsigned int capacity)
+        : mFont(NULL),
+          mCapacity(capacity),
+          mFontRevision(0),
+          mHits(0),
+          mMisses(0)
+    {
+        setFont(font);
+    }
+
+    CachedFont::~CachedFont()
+    {
+    }
+
+    void CachedFont::setFont(Font* font)
+    {
+        if (font == NULL)
+        {
+            throw FCN_EXCEPTION("Font is NULL.");
+        }
+
+        // Pick our own revision so that getRevision moves on by one
+        unsigned int revision = mFont != NULL ? getRevision() + 1 : 0;
+
+        mFont = font;
+        mFontRevision = font->getRevision();
+        mRevision = revision - mFontRevision;
+        clear();
+    }
+
+    Font* CachedFont::getFont() const
+    {
+        return mFont;
+    }
+
+    void CachedFont::setCapacity(unsigned int capacity)
+    {
+        mCapacity = capacity;
+        shrink(mCapacity);
+    }
+
+    unsigned int CachedFont::getCapacity() const
+    {
+        return mCapacity;
+    }
+
+    unsigned int CachedFont::getSize() const
+    {
+        return mEntries.size();
+    }
+
+    void CachedFont::clear()
+    {
+        mEntries.clear();
+        mIndex.clear();
+    }
+
+    unsigned int CachedFont::getHits() const
+    {
+        return mHits;
+    }
+
+    unsigned int CachedFont::getMisses() const
+    {
+        return mMisses;
+    }
+
+    float CachedFont::getHitRate() const
+    {
+        if (mHits + mMisses == 0)
+        {
+            return 0.0f;
+        }
+
+        return mHits / (float)(mHits + mMisses);
+    }
+
+    void CachedFont::resetStatistics()
+    {
+        mHits = 0;
+        mMisses = 0;
+    }
+
+    int CachedFont::getWidth(const std::string& text) const
+    {
+        if (mFont->getRevision() != mFontRevision)
+        {
+            mFontRevision = mFont->getRevision();
+            mEntries.clear();
+            mIndex.clear();
+        }
+
+        EntryIndex::iterator it = mIndex.find(text);
+
+        if (it != mIndex.end())
+        {
+            ++mHits;
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            return it->second->second;
+        }
+
+        ++mMisses;
+
+        int width = mFont->getWidth(text);
+
+        if (mCapacity > 0)
+        {
+            shrink(mCapacity - 1);
+            mEntries.push_front(std::make_pair(text, width));
+            mIndex[text] = mEntries.begin();
+        }
+
+        return width;
+    }
+
+    int CachedFont::getHeight() const
+    {
+        return mFont->getHeight();
+    }
+
+    int CachedFont::getStringIndexAt(const std::string& text, int x) const
+    {
+        return mFont->getStringIndexAt(text, x);
+    }
+
+    void CachedFont::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+    {
+        mFont->getPrefixWidths(text, widths);
+    }
+
+    void CachedFont::drawString(Graphics* graphics, const std::string& text, int x, int y)
+    {
+        mFont->drawString(graphics, text, x, y);
+    }
+
+    unsigned int CachedFont::getRevision() const
+    {
+        return mRevision + mFont->getRevision();
+    }
+
+    void CachedFont::shrink(unsigned int size) const
+    {
+        while (mEntries.size() > size)
+        {
+            mIndex.erase(mEntries.back().first);
+            mEntries.pop_back();
+        }
+    }
+}
@@ -0,0 +1,466 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/contrib/freetype/atlasfont.hpp"
+
+#include <algorithm>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "fifechan/exception.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/utf8stringeditor.hpp"
+#include "fifechan/util/utf8/utf8.hpp"
+
+namespace fcn
+{
+    namespace contrib
+    {
+        AtlasFont::AtlasFont(const std::string& filename, int size, int pageSize)
+            : mLibrary(NULL),
+              mFace(NULL),
+              mPageSize(pageSize),
+              mRowSpacing(0),
+              mGlyphSpacing(0),
+              mAntiAlias(true),
+              mKerning(true),
+              mMaxColors(8),
+              mUseCounter(0),
+              mShelfX(0),
+              mShelfY(0),
+              mShelfHeight(0)
+        {
+            if (FT_Init_FreeType(&mLibrary) != 0)
+            {
+                throw FCN_EXCEPTION("AtlasFont::AtlasFont. Could not initialize FreeType.");
+            }
+
+            if (FT_New_Face(mLibrary, filename.c_str(), 0, &mFace) != 0)
+            {
+                FT_Done_FreeType(mLibrary);
+                throw FCN_EXCEPTION("AtlasFont::AtlasFont. Could not load font " + filename + ".");
+            }
+
+            if (FT_Set_Pixel_Sizes(mFace, 0, size) != 0)
+            {
+                FT_Done_Face(mFace);
+                FT_Done_FreeType(mLibrary);
+                throw FCN_EXCEPTION("AtlasFont::AtlasFont. Font " + filename + " has no size usable as pixel size.");
+            }
+        }
+
+        AtlasFont::~AtlasFont()
+        {
+            clearAtlas();
+
+            FT_Done_Face(mFace);
+            FT_Done_FreeType(mLibrary);
+        }
+
+        void AtlasFont::setRowSpacing(int spacing)
+        {
+            mRowSpacing = spacing;
+        }
+
+        int AtlasFont::getRowSpacing()
+        {
+            return mRowSpacing;
+        }
+
+        void AtlasFont::setGlyphSpacing(int spacing)
+        {
+            mGlyphSpacing = spacing;
+            invalidateMetrics();
+        }
+
+        int AtlasFont::getGlyphSpacing()
+        {
+            return mGlyphSpacing;
+        }
+
+        void AtlasFont::setAntiAlias(bool antiAlias)
+        {
+            if (mAntiAlias != antiAlias)
+            {
+                mAntiAlias = antiAlias;
+                clearAtlas();
+                invalidateMetrics();
+            }
+        }
+
+        bool AtlasFont::isAntiAlias()
+        {
+            return mAntiAlias;
+        }
+
+        void AtlasFont::setKerning(bool kerning)
+        {
+            mKerning = kerning;
+            invalidateMetrics();
+        }
+
+        bool AtlasFont::isKerning()
+        {
+            return mKerning;
+        }
+
+        void AtlasFont::setMaxColors(unsigned int colors)
+        {
+            mMaxColors = colors;
+        }
+
+        unsigned int AtlasFont::getMaxColors() const
+        {
+            return mMaxColors;
+        }
+
+        int AtlasFont::getPageCount() const
+        {
+            return mPages.size();
+        }
+
+        void AtlasFont::clearAtlas()
+        {
+            std::map<unsigned int, PageImages>::iterator it;
+            for (it = mPageImages.begin(); it != mPageImages.end(); ++it)
+            {
+                deletePageImages(it->second);
+            }
+
+            mPageImages.clear();
+            mGlyphs.clear();
+            mPages.clear();
+            mPageVersions.clear();
+            mShelfX = 0;
+            mShelfY = 0;
+            mShelfHeight = 0;
+        }
+
+        int AtlasFont::getWidth(const std::string& text) const
+        {
+            std::vector<unsigned int> characters;
+            decode(text, characters);
+
+            int width = 0;
+            unsigned int previous = 0;
+
+            for (unsigned int i = 0; i < characters.size(); ++i)
+            {
+                const Glyph& glyph = getGlyph(characters[i]);
+
+                width += getKerning(previous, glyph.index) + glyph.advance + mGlyphSpacing;
+                previous = glyph.index;
+            }
+
+            return width;
+        }
+
+        void AtlasFont::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+        {
+            // Laid out the same way as the whole string is in drawString,
+            // which decodes invalid UTF-8 one byte per character.
+            bool valid = UTF8StringEditor::isValid(text);
+            std::string::const_iterator it = text.begin();
+
+            int width = 0;
+            unsigned int previous = 0;
+
+            widths.resize(text.size() + 1);
+            widths[0] = 0;
+
+            while (it != text.end())
+            {
+                unsigned int start = it - text.begin();
+                unsigned int character = valid ? utf8::unchecked::next(it) : (unsigned char)*it++;
+                unsigned int end = it - text.begin();
+                const Glyph& glyph = getGlyph(character);
+
+                width += getKerning(previous, glyph.index) + glyph.advance + mGlyphSpacing;
+                previous = glyph.index;
+
+                for (unsigned int i = start + 1; i < end; ++i)
+                {
+                    widths[i] = widths[start];
+                }
+
+                widths[end] = width;
+            }
+        }
+
+        int AtlasFont::getHeight() const
+
+        {
+            return ((mFace->size->metrics.height + 63) >> 6) + mRowSpacing;
+        }
+
+        void AtlasFont::drawString(Graphics* graphics, const std::string& text, int x, int y)
+        {
+            if (text.empty())
+            {
+                return;
+            }
+
+            decode(text, mCharacters);
+
+            // Rasterize all glyphs first, so that every changed page is
+            // only turned into an image once.
+            for (unsigned int i = 0; i < mCharacters.size(); ++i)
+            {
+                getGlyph(mCharacters[i]);
+            }
+
+            PageImages& images = getPageImages(graphics->getColor());
+
+            // This is needed for drawing the glyphs in the middle if we have spacing
+            int baseline = y + ((mFace->size->metrics.ascender + 63) >> 6) + mRowSpacing / 2;
+            unsigned int previous = 0;
+
+            for (unsigned int i = 0; i < mCharacters.size(); ++i)
+            {
+                const Glyph& glyph = getGlyph(mCharacters[i]);
+
+                x += getKerning(previous, glyph.index);
+
+                if (glyph.page >= 0)
+                {
+                    graphics->drawImage(images.images[glyph.page],
+                                        glyph.x,
+                                        glyph.y,
+                                        x + glyph.left,
+                                        baseline - glyph.top,
+                                        glyph.width,
+                                        glyph.height);
+                }
+
+                x += glyph.advance + mGlyphSpacing;
+                previous = glyph.index;
+            }
+        }
+
+        const AtlasFont::Glyph& AtlasFont::getGlyph(unsigned int character) const
+        {
+            std::map<unsigned int, Glyph>::iterator it = mGlyphs.find(character);
+
+            if (it != mGlyphs.end())
+            {
+                return it->second;
+            }
+
+            unsigned int index = FT_Get_Char_Index(mFace, character);
+            FT_Int32 flags = FT_LOAD_RENDER | (mAntiAlias ? FT_LOAD_TARGET_NORMAL : FT_LOAD_TARGET_MONO);
+
+            if (FT_Load_Glyph(mFace, index, flags) != 0)
+            {
+                throw FCN_EXCEPTION("AtlasFont::getGlyph. Could not rasterize glyph.");
+            }
+
+            const FT_GlyphSlot slot = mFace->glyph;
+            const FT_Bitmap& bitmap = slot->bitmap;
+
+            Glyph glyph;
+            glyph.index = index;
+            glyph.page = -1;
+            glyph.x = 0;
+            glyph.y = 0;
+            glyph.width = bitmap.width;
+            glyph.height = bitmap.rows;
+            glyph.left = slot->bitmap_left;
+            glyph.top = slot->bitmap_top;
+            glyph.advance = (slot->advance.x + 32) >> 6;
+
+            if (glyph.width > 0 && glyph.height > 0)
+            {
+                // Glyphs are packed in rows (shelves) with one pixel of
+                // padding, so that neighbours never bleed into each other.
+                if (glyph.width + 2 > mPageSize || glyph.height + 2 > mPageSize)
+                {
+                    throw FCN_EXCEPTION("AtlasFont::getGlyph. Glyph does not fit on an atlas page, use a larger page size.");
+                }
+
+                if (!mPages.empty() && mShelfX + glyph.width + 1 > mPageSize)
+                {
+                    mShelfX = 1;
+                    mShelfY += mShelfHeight + 1;
+                    mShelfHeight = 0;
+                }
+
+                if (mPages.empty() || mShelfY + glyph.height + 1 > mPageSize)
+                {
+                    mPages.push_back(std::vector<unsigned char>(mPageSize * mPageSize, 0));
+                    mPageVersions.push_back(0);
+                    mShelfX = 1;
+                    mShelfY = 1;
+                    mShelfHeight = 0;
+                }
+
+                glyph.page = mPages.size() - 1;
+                glyph.x = mShelfX;
+                glyph.y = mShelfY;
+
+                mShelfX += glyph.width + 1;
+                mShelfHeight = std::max(mShelfHeight, glyph.height);
+
+                std::vector<unsigned char>& page = mPages[glyph.page];
+
+                for (int row = 0; row < glyph.height; ++row)
+                {
+                    const unsigned char* src = bitmap.buffer + row * bitmap.pitch;
+                    unsigned char* dst = &page[(glyph.y + row) * mPageSize + glyph.x];
+
+                    if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+                    {
+                        for (int col = 0; col < glyph.width; ++col)
+                        {
+                            dst[col] = (src[col >> 3] & (0x80 >> (col & 7))) ? 255 : 0;
+                        }
+                    }
+                    else
+                    {
+                        std::copy(src, src + glyph.width, dst);
+                    }
+                }
+
+                ++mPageVersions[glyph.page];
+            }
+
+            return mGlyphs.insert(std::make_pair(character, glyph)).first->second;
+        }
+
+        void AtlasFont::decode(const std::string& text, std::vector<unsigned int>& characters)
+        {
+            characters.clear();
+
+            if (UTF8StringEditor::isValid(text))
+            {
+                std::string::const_iterator it = text.begin();
+
+                while (it != text.end())
+                {
+                    characters.push_back(utf8::unchecked::next(it));
+                }
+            }
+            else
+            {
+                for (unsigned int i = 0; i < text.size(); ++i)
+                {
+                    characters.push_back((unsigned char)text[i]);
+                }
+            }
+        }
+
+        int AtlasFont::getKerning(unsigned int left, unsigned int right) const
+        {
+            if (!mKerning || left == 0 || !FT_HAS_KERNING(mFace))
+            {
+                return 0;
+            }
+
+            FT_Vector delta;
+
+            if (FT_Get_Kerning(mFace, left, right, FT_KERNING_DEFAULT, &delta) != 0)
+            {
+                return 0;
+            }
+
+            return delta.x >> 6;
+        }
+
+        AtlasFont::PageImages& AtlasFont::getPageImages(const Color& color)
+        {
+            unsigned int key = ((color.r & 0xff) << 24)
+                | ((color.g & 0xff) << 16)
+                | ((color.b & 0xff) << 8)
+                | (color.a & 0xff);
+
+            std::map<unsigned int, PageImages>::iterator it = mPageImages.find(key);
+
+            if (it == mPageImages.end())
+            {
+                if (!mPageImages.empty() && mPageImages.size() >= mMaxColors)
+                {
+                    std::map<unsigned int, PageImages>::iterator oldest = mPageImages.begin();
+                    std::map<unsigned int, PageImages>::iterator jt;
+                    for (jt = mPageImages.begin(); jt != mPageImages.end(); ++jt)
+                    {
+                        if (jt->second.lastUsed < oldest->second.lastUsed)
+                        {
+                            oldest = jt;
+                        }
+                    }
+
+                    deletePageImages(oldest->second);
+                    mPageImages.erase(oldest);
+                }
+
+                it = mPageImages.insert(std::make_pair(key, PageImages())).first;
+            }
+
+            PageImages& images = it->second;
+            images.lastUsed = ++mUseCounter;
+
+            images.images.resize(mPages.size(), NULL);
+            images.versions.resize(mPages.size(), 0);
+
+            for (unsigned int i = 0; i < mPages.size(); ++i)
+            {
+                if (images.images[i] != NULL && images.versions[i] == mPageVersions[i])
+                {
+                    continue;
+                }
+
+                const std::vector<unsigned char>& page = mPages[i];
+                mPixels.resize(page.size() * 4);
+
+                for (unsigned int j = 0; j < page.size(); ++j)
+                {
+                    mPixels[j * 4] = color.r;
+                    mPixels[j * 4 + 1] = color.g;
+                    mPixels[j * 4 + 2] = color.b;
+                    mPixels[j * 4 + 3] = (page[j] * color.a + 127) / 255;
+                }
+
+                delete images.images[i];
+                images.images[i] = createPageImage(&mPixels[0], mPageSize, mPageSize);
+                images.versions[i] = mPageVersions[i];
+            }
+
+            return images;
+        }
+
+        void AtlasFont::deletePageImages(PageImages& images)
+        {
+            for (unsigned int i = 0; i < images.images.size(); ++i)
+            {
+                delete images.images[i];
+            }
+
+            images.images.clear();
+            images.versions.clear();
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/contrib/opengl/openglatlasfont.hpp"
+
+#include "fifechan/opengl/openglimage.hpp"
+
+namespace fcn
+{
+    namespace contrib
+    {
+        OpenGLAtlasFont::OpenGLAtlasFont(const std::string& filename, int size, int pageSize)
+            : AtlasFont(filename, size, pageSize)
+        {
+        }
+
+        Image* OpenGLAtlasFont::createPageImage(const unsigned char* pixels, int width, int height)
+        {
+            // OpenGLImage uploads its pixels as RGBA bytes, so the byte
+            // order of the page can be passed on as is.
+            return new OpenGLImage(reinterpret_cast<const unsigned int*>(pixels), width, height, true);
+        }
+    }
+}
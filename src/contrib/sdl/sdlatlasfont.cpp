@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/contrib/sdl/sdlatlasfont.hpp"
+
+#include <cstring>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/sdl/sdlimage.hpp"
+#include "fifechan/sdl/sdltextureimage.hpp"
+
+namespace fcn
+{
+    namespace contrib
+    {
+        SDLAtlasFont::SDLAtlasFont(const std::string& filename,
+                                   int size,
+                                   SDL_Renderer* renderer,
+                                   int pageSize)
+            : AtlasFont(filename, size, pageSize),
+              mRenderer(renderer)
+        {
+        }
+
+        Image* SDLAtlasFont::createPageImage(const unsigned char* pixels, int width, int height)
+        {
+            // Masks for RGBA bytes in memory
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+            SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, 32,
+                                                        0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
+#else
+            SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, 32,
+                                                        0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
+#endif
+
+            if (surface == NULL)
+            {
+                throw FCN_EXCEPTION("SDLAtlasFont::createPageImage. " + std::string(SDL_GetError()));
+            }
+
+            SDL_LockSurface(surface);
+
+            for (int y = 0; y < height; ++y)
+            {
+                std::memcpy((Uint8*)surface->pixels + y * surface->pitch, pixels + y * width * 4, width * 4);
+            }
+
+            SDL_UnlockSurface(surface);
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+
+            if (mRenderer == NULL)
+            {
+                return new SDLImage(surface, true);
+            }
+
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surface);
+            SDL_FreeSurface(surface);
+
+            if (texture == NULL)
+            {
+                throw FCN_EXCEPTION("SDLAtlasFont::createPageImage. " + std::string(SDL_GetError()));
+            }
+
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+            return new SDLTextureImage(texture, true);
+        }
+    }
+}
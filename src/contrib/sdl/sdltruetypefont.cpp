@@ -84,6 +84,12 @@ namespace fcn
             mAntiAlias = true;        
             mFilename = filename;
             mFont = NULL;
+            mCacheMode = CacheRuns;
+            mCacheBudget = 4 * 1024 * 1024;
+            mCacheSize = 0;
+            mCacheHits = 0;
+            mCacheMisses = 0;
+            mCacheEvictions = 0;
         
             mFont = TTF_OpenFont(filename.c_str(), size);
         
@@ -95,18 +101,76 @@ namespace fcn
     
         SDLTrueTypeFont::~SDLTrueTypeFont()
         {
+            clearCache();
             TTF_CloseFont(mFont);
         }
   
         int SDLTrueTypeFont::getWidth(const std::string& text) const
         {
+            if (mCacheMode == CacheGlyphs)
+            {
+                int width = 0;
+
+                for (unsigned int i = 0; i < text.size(); ++i)
+                {
+                    width += getGlyphAdvance(text[i]) + mGlyphSpacing;
+                }
+
+                return width;
+            }
+
+            CacheKey key;
+            key.kind = RunWidth;
+            key.text = text;
+            key.color = 0;
+            key.antiAlias = false;
+
+            CacheEntry* entry = findCacheEntry(key);
+
+            if (entry != NULL)
+            {
+                return entry->width;
+            }
+
             int w, h;
             TTF_SizeText(mFont, text.c_str(), &w, &h);
+
+            addCacheEntry(key, NULL, 0, w);
         
             return w;
         }
 
+        void SDLTrueTypeFont::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+        {
+            widths.resize(text.size() + 1);
+            widths[0] = 0;
+
+            if (mCacheMode == CacheGlyphs)
+            {
+                for (unsigned int i = 0; i < text.size(); ++i)
+                {
+                    widths[i + 1] = widths[i] + getGlyphAdvance(text[i]) + mGlyphSpacing;
+                }
+
+                return;
+            }
+
+            // Measured directly, the prefixes would only push the widths
+            // of whole strings out of the cache.
+            std::string prefix;
+            prefix.reserve(text.size());
+
+            for (unsigned int i = 0; i < text.size(); ++i)
+            {
+                int w, h;
+                prefix += text[i];
+                TTF_SizeText(mFont, prefix.c_str(), &w, &h);
+                widths[i + 1] = w;
+            }
+        }
+
         int SDLTrueTypeFont::getHeight() const
+
         {
             return TTF_FontHeight(mFont) + mRowSpacing;
         }
@@ -136,14 +200,107 @@ namespace fcn
             sdlCol.r = col.r;
             sdlCol.g = col.g;
 
+            CacheKey key;
+            key.color = (col.r << 16) | (col.g << 8) | col.b;
+            key.antiAlias = mAntiAlias;
+
+            if (mCacheMode == CacheGlyphs)
+            {
+                key.kind = GlyphSurface;
+
+                for (unsigned int i = 0; i < text.size(); ++i)
+                {
+                    key.text = text.substr(i, 1);
+                    CacheEntry* entry = findCacheEntry(key);
+
+                    if (entry == NULL)
+                    {
+                        Uint16 glyph = (unsigned char)text[i];
+                        SDL_Surface* glyphSurface;
+
+                        if (mAntiAlias)
+                        {
+                            glyphSurface = TTF_RenderGlyph_Blended(mFont, glyph, sdlCol);
+                        }
+                        else
+                        {
+                            glyphSurface = TTF_RenderGlyph_Solid(mFont, glyph, sdlCol);
+                        }
+
+                        int minx = 0;
+                        TTF_GlyphMetrics(mFont, glyph, &minx, NULL, NULL, NULL, NULL);
+
+                        entry = addCacheEntry(key, glyphSurface, minx, getGlyphAdvance(text[i]));
+
+                        if (entry == NULL)
+                        {
+                            // Does not fit in the cache, draw it uncached
+                            if (glyphSurface != NULL)
+                            {
+                                SDL_Rect dst, src;
+                                dst.x = x + minx;
+                                dst.y = y + yoffset;
+                                src.w = glyphSurface->w;
+                                src.h = glyphSurface->h;
+                                src.x = 0;
+                                src.y = 0;
+
+                                sdlGraphics->drawSDLSurface(glyphSurface, src, dst);
+                                SDL_FreeSurface(glyphSurface);
+                            }
+
+                            x += getGlyphAdvance(text[i]) + mGlyphSpacing;
+                            continue;
+                        }
+                    }
+
+                    if (entry->surface != NULL)
+                    {
+                        SDL_Rect dst, src;
+                        dst.x = x + entry->x;
+                        dst.y = y + yoffset;
+                        src.w = entry->surface->w;
+                        src.h = entry->surface->h;
+                        src.x = 0;
+                        src.y = 0;
+
+                        sdlGraphics->drawSDLSurface(entry->surface, src, dst);
+                    }
+
+                    x += entry->width + mGlyphSpacing;
+                }
+
+                return;
+            }
+
+            key.kind = RunSurface;
+            key.text = text;
+
             SDL_Surface *textSurface;
-            if (mAntiAlias)
+            CacheEntry* entry = findCacheEntry(key);
+            bool cached = true;
+
+            if (entry != NULL)
             {
-                textSurface = TTF_RenderText_Blended(mFont, text.c_str(), sdlCol);
+                textSurface = entry->surface;
             }
             else
             {
-                textSurface = TTF_RenderText_Solid(mFont, text.c_str(), sdlCol);
+                if (mAntiAlias)
+                {
+                    textSurface = TTF_RenderText_Blended(mFont, text.c_str(), sdlCol);
+                }
+                else
+                {
+                    textSurface = TTF_RenderText_Solid(mFont, text.c_str(), sdlCol);
+                }
+
+                if (textSurface == NULL)
+                {
+                    throw FCN_EXCEPTION("SDLTrueTypeFont::drawString. "+std::string(TTF_GetError()));
+                }
+
+                cached = addCacheEntry(key, textSurface, 0, textSurface->w) != NULL;
             }
         
             SDL_Rect dst, src;
@@ -155,7 +312,11 @@ namespace fcn
             src.y = 0;
         
             sdlGraphics->drawSDLSurface(textSurface, src, dst);
-            SDL_FreeSurface(textSurface);        
+
+            if (!cached)
+            {
+                SDL_FreeSurface(textSurface);
+            }
         }
     
         void SDLTrueTypeFont::setRowSpacing(int spacing)
@@ -171,6 +332,7 @@ namespace fcn
         void SDLTrueTypeFont::setGlyphSpacing(int spacing)
         {
             mGlyphSpacing = spacing;
+            invalidateMetrics();
         }
     
         int SDLTrueTypeFont::getGlyphSpacing()
@@ -187,6 +349,183 @@ namespace fcn
         {
             return mAntiAlias;        
         }    
+
+        void SDLTrueTypeFont::setCacheMode(CacheMode mode)
+        {
+            mCacheMode = mode;
+            invalidateMetrics();
+        }
+
+        SDLTrueTypeFont::CacheMode SDLTrueTypeFont::getCacheMode() const
+        {
+            return mCacheMode;
+        }
+
+        void SDLTrueTypeFont::setCacheBudget(unsigned int bytes)
+        {
+            mCacheBudget = bytes;
+            shrinkCache(mCacheBudget);
+        }
+
+        unsigned int SDLTrueTypeFont::getCacheBudget() const
+        {
+            return mCacheBudget;
+        }
+
+        unsigned int SDLTrueTypeFont::getCacheSize() const
+        {
+            return mCacheSize;
+        }
+
+        void SDLTrueTypeFont::clearCache()
+        {
+            CacheList::iterator it;
+            for (it = mCacheList.begin(); it != mCacheList.end(); ++it)
+            {
+                if (it->surface != NULL)
+                {
+                    SDL_FreeSurface(it->surface);
+                }
+            }
+
+            mCacheList.clear();
+            mCacheIndex.clear();
+            mCacheSize = 0;
+        }
+
+        unsigned int SDLTrueTypeFont::getCacheHits() const
+        {
+            return mCacheHits;
+        }
+
+        unsigned int SDLTrueTypeFont::getCacheMisses() const
+        {
+            return mCacheMisses;
+        }
+
+        unsigned int SDLTrueTypeFont::getCacheEvictions() const
+        {
+            return mCacheEvictions;
+        }
+
+        void SDLTrueTypeFont::resetCacheCounters()
+        {
+            mCacheHits = 0;
+            mCacheMisses = 0;
+            mCacheEvictions = 0;
+        }
+
+        bool SDLTrueTypeFont::CacheKey::operator<(const CacheKey& other) const
+        {
+            if (kind != other.kind)
+            {
+                return kind < other.kind;
+            }
+
+            if (color != other.color)
+            {
+                return color < other.color;
+            }
+
+            if (antiAlias != other.antiAlias)
+            {
+                return antiAlias < other.antiAlias;
+            }
+
+            return text < other.text;
+        }
+
+        SDLTrueTypeFont::CacheEntry* SDLTrueTypeFont::findCacheEntry(const CacheKey& key) const
+        {
+            CacheIndex::iterator it = mCacheIndex.find(key);
+
+            if (it == mCacheIndex.end())
+            {
+                ++mCacheMisses;
+                return NULL;
+            }
+
+            ++mCacheHits;
+
+            // Move the entry to the front of the list, the iterators stay valid
+            mCacheList.splice(mCacheList.begin(), mCacheList, it->second);
+
+            return &mCacheList.front();
+        }
+
+        SDLTrueTypeFont::CacheEntry* SDLTrueTypeFont::addCacheEntry(const CacheKey& key,
+                                                                    SDL_Surface* surface,
+                                                                    int x,
+                                                                    int width) const
+        {
+            unsigned int size = sizeof(CacheEntry) + key.text.size();
+
+            if (surface != NULL)
+            {
+                size += sizeof(SDL_Surface) + surface->pitch * surface->h;
+            }
+
+            if (size > mCacheBudget)
+            {
+                return NULL;
+            }
+
+            shrinkCache(mCacheBudget - size);
+
+            CacheEntry entry;
+            entry.key = key;
+            entry.surface = surface;
+            entry.x = x;
+            entry.width = width;
+            entry.size = size;
+
+            mCacheList.push_front(entry);
+            mCacheIndex[key] = mCacheList.begin();
+            mCacheSize += size;
+
+            return &mCacheList.front();
+        }
+
+        void SDLTrueTypeFont::shrinkCache(unsigned int bytes) const
+        {
+            while (mCacheSize > bytes)
+            {
+                CacheEntry& last = mCacheList.back();
+
+                if (last.surface != NULL)
+                {
+                    SDL_FreeSurface(last.surface);
+                }
+
+                mCacheSize -= last.size;
+                mCacheIndex.erase(last.key);
+                mCacheList.pop_back();
+                ++mCacheEvictions;
+            }
+        }
+
+        int SDLTrueTypeFont::getGlyphAdvance(unsigned char glyph) const
+        {
+            CacheKey key;
+            key.kind = GlyphAdvance;
+            key.text = std::string(1, (char)glyph);
+            key.color = 0;
+            key.antiAlias = false;
+
+            CacheEntry* entry = findCacheEntry(key);
+
+            if (entry != NULL)
+            {
+                return entry->width;
+            }
+
+            int advance = 0;
+            TTF_GlyphMetrics(mFont, glyph, NULL, NULL, NULL, NULL, &advance);
+
+            addCacheEntry(key, NULL, 0, advance);
+
+            return advance;
+        }
     }
 }
 
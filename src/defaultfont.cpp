@@ -112,4 +112,14 @@ namespace fcn
 
         return x / 8;
     }
+
+    void DefaultFont::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+    {
+        widths.resize(text.size() + 1);
+
+        for (unsigned int i = 0; i < widths.size(); ++i)
+        {
+            widths[i] = i * 8;
+        }
+    }
 }
@@ -0,0 +1,362 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/filteredlistmodel.hpp"
+
+#include <algorithm>
+
+namespace fcn
+{
+    static inline char toLowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    }
+
+    FilteredListModel::FilteredListModel(ListModel* sourceModel)
+        : mSourceModel(NULL),
+          mMergeTail(0)
+    {
+        setSourceModel(sourceModel);
+    }
+
+    FilteredListModel::~FilteredListModel()
+    {
+        if (mSourceModel != NULL)
+        {
+            mSourceModel->removeListModelListener(this);
+        }
+    }
+
+    void FilteredListModel::setSourceModel(ListModel* sourceModel)
+    {
+        if (mSourceModel != NULL)
+        {
+            mSourceModel->removeListModelListener(this);
+        }
+
+        int removed = mIndices.size();
+        mIndices.clear();
+
+        if (removed > 0)
+        {
+            distributeElementsRemoved(0, removed);
+        }
+
+        mSourceModel = sourceModel;
+
+        if (mSourceModel != NULL)
+        {
+            mSourceModel->addListModelListener(this);
+
+            int elements = mSourceModel->getNumberOfElements();
+            for (int i = 0; i < elements; ++i)
+            {
+                if (matchesSourceElement(i))
+                {
+                    mIndices.push_back(i);
+                }
+            }
+
+            if (!mIndices.empty())
+            {
+                distributeElementsInserted(0, mIndices.size());
+            }
+        }
+    }
+
+    ListModel* FilteredListModel::getSourceModel() const
+    {
+        return mSourceModel;
+    }
+
+    void FilteredListModel::setFilter(const std::string& filter)
+    {
+        if (filter == mFilter)
+        {
+            return;
+        }
+
+        // Elements not matching the old filter can't match an extended
+        // one, so only the matching elements have to be tested.
+        bool extended = filter.find(mFilter) != std::string::npos;
+        mFilter = filter;
+
+        if (mSourceModel == NULL)
+        {
+            return;
+        }
+
+        std::vector<int> indices;
+
+        if (extended)
+        {
+            for (unsigned int i = 0; i < mIndices.size(); ++i)
+            {
+                if (matchesSourceElement(mIndices[i]))
+                {
+                    indices.push_back(mIndices[i]);
+                }
+            }
+        }
+        else
+        {
+            int elements = mSourceModel->getNumberOfElements();
+            for (int i = 0; i < elements; ++i)
+            {
+                if (matchesSourceElement(i))
+                {
+                    indices.push_back(i);
+                }
+            }
+        }
+
+        replaceIndices(0, mIndices.size(), indices);
+    }
+
+    const std::string& FilteredListModel::getFilter() const
+    {
+        return mFilter;
+    }
+
+    int FilteredListModel::getSourceIndex(int i) const
+    {
+        if ((unsigned int)i < mMergedIndices.size())
+        {
+            return mMergedIndices[i];
+        }
+
+        return mIndices[i - mMergedIndices.size() + mMergeTail];
+    }
+
+    bool FilteredListModel::matches(const std::string& element, const std::string& filter) const
+    {
+        if (filter.size() > element.size())
+        {
+            return false;
+        }
+
+        unsigned int last = element.size() - filter.size();
+        for (unsigned int start = 0; start <= last; ++start)
+        {
+            unsigned int i = 0;
+            while (i < filter.size()
+                   && toLowerAscii(element[start + i]) == toLowerAscii(filter[i]))
+            {
+                ++i;
+            }
+
+            if (i == filter.size())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    int FilteredListModel::getNumberOfElements()
+    {
+        return mMergedIndices.size() + mIndices.size() - mMergeTail;
+    }
+
+    std::string FilteredListModel::getElementAt(int i)
+    {
+        return mSourceModel->getElementAt(getSourceIndex(i));
+    }
+
+    const std::string* FilteredListModel::getElementPointer(int i)
+    {
+        return mSourceModel->getElementPointer(getSourceIndex(i));
+    }
+
+    void FilteredListModel::elementsInserted(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        std::vector<int>::iterator position = std::lower_bound(mIndices.begin(), mIndices.end(), first);
+
+        for (std::vector<int>::iterator iter = position; iter != mIndices.end(); ++iter)
+        {
+            *iter += count;
+        }
+
+        std::vector<int> indices;
+        for (int i = first; i < first + count; ++i)
+        {
+            if (matchesSourceElement(i))
+            {
+                indices.push_back(i);
+            }
+        }
+
+        replaceIndices(position - mIndices.begin(), 0, indices);
+    }
+
+    void FilteredListModel::elementsRemoved(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        std::vector<int>::iterator begin = std::lower_bound(mIndices.begin(), mIndices.end(), first);
+        std::vector<int>::iterator end = std::lower_bound(begin, mIndices.end(), first + count);
+
+        for (std::vector<int>::iterator iter = end; iter != mIndices.end(); ++iter)
+        {
+            *iter -= count;
+        }
+
+        replaceIndices(begin - mIndices.begin(), end - begin, std::vector<int>());
+    }
+
+    void FilteredListModel::elementsChanged(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        std::vector<int>::iterator begin = std::lower_bound(mIndices.begin(), mIndices.end(), first);
+        std::vector<int>::iterator end = std::lower_bound(begin, mIndices.end(), first + count);
+
+        std::vector<int> indices;
+        for (int i = first; i < first + count; ++i)
+        {
+            if (matchesSourceElement(i))
+            {
+                indices.push_back(i);
+            }
+        }
+
+        int position = begin - mIndices.begin();
+        int changed = end - begin;
+
+        if (indices.size() == (unsigned int)changed && std::equal(indices.begin(), indices.end(), begin))
+        {
+            if (changed > 0)
+            {
+                distributeElementsChanged(position, changed);
+            }
+        }
+        else
+        {
+            // Elements which still match have changed too.
+            replaceIndices(position, changed, indices);
+
+            if (!indices.empty())
+            {
+                distributeElementsChanged(position, indices.size());
+            }
+        }
+    }
+
+    void FilteredListModel::listModelDeleted(ListModel* model)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        mSourceModel = NULL;
+        replaceIndices(0, mIndices.size(), std::vector<int>());
+    }
+
+    bool FilteredListModel::matchesSourceElement(int index)
+    {
+        if (mFilter.empty())
+        {
+            return true;
+        }
+
+        const std::string* element = mSourceModel->getElementPointer(index);
+
+        if (element == NULL)
+        {
+            mElement = mSourceModel->getElementAt(index);
+            element = &mElement;
+        }
+
+        return matches(*element, mFilter);
+    }
+
+    void FilteredListModel::replaceIndices(int position, int count, const std::vector<int>& indices)
+    {
+        // Merge the old and the new indices into a new vector. The old
+        // indices from mMergeTail on are the ones not merged yet, so the
+        // model reads the state after every run of removed or inserted
+        // elements without reshaping mIndices for each run.
+        unsigned int end = position + count;
+        unsigned int n = 0;
+
+        mMergedIndices.reserve(mIndices.size() - count + indices.size());
+        mMergedIndices.assign(mIndices.begin(), mIndices.begin() + position);
+        mMergeTail = position;
+
+        while (mMergeTail < end || n < indices.size())
+        {
+            if (n == indices.size() || (mMergeTail < end && mIndices[mMergeTail] < indices[n]))
+            {
+                int removed = 0;
+                while (mMergeTail < end
+                       && (n == indices.size() || mIndices[mMergeTail] < indices[n]))
+                {
+                    ++mMergeTail;
+                    ++removed;
+                }
+
+                distributeElementsRemoved(mMergedIndices.size(), removed);
+            }
+            else if (mMergeTail == end || indices[n] < mIndices[mMergeTail])
+            {
+                int inserted = 0;
+                while (n < indices.size()
+                       && (mMergeTail == end || indices[n] < mIndices[mMergeTail]))
+                {
+                    mMergedIndices.push_back(indices[n]);
+                    ++n;
+                    ++inserted;
+                }
+
+                distributeElementsInserted(mMergedIndices.size() - inserted, inserted);
+            }
+            else
+            {
+                mMergedIndices.push_back(indices[n]);
+                ++n;
+                ++mMergeTail;
+            }
+        }
+
+        mMergedIndices.insert(mMergedIndices.end(), mIndices.begin() + mMergeTail, mIndices.end());
+        mIndices.swap(mMergedIndices);
+        std::vector<int>().swap(mMergedIndices);
+        mMergeTail = 0;
+    }
+}
@@ -530,6 +530,9 @@ namespace fcn
     {
         Widget* sourceWidget = focusEvent.getSource();
 
+        // Widgets are drawn differently when focused.
+        sourceWidget->requestRedraw();
+
         std::list<FocusListener*> focusListeners = sourceWidget->_getFocusListeners();
 
         // Send the event to all focus listeners of the widget.
@@ -545,6 +548,9 @@ namespace fcn
     {
         Widget* sourceWidget = focusEvent.getSource();
 
+        // Widgets are drawn differently when focused.
+        sourceWidget->requestRedraw();
+
         std::list<FocusListener*> focusListeners = sourceWidget->_getFocusListeners();
 
         // Send the event to all focus listeners of the widget.
@@ -68,25 +68,44 @@
 
 #include "fifechan/font.hpp"
 
+#include "fifechan/utf8stringeditor.hpp"
+
+#include <algorithm>
 #include <string>
 
 namespace fcn
 {
     int Font::getStringIndexAt(const std::string& text, int x) const
     {
-        unsigned int i;
-        int size = 0;
+        std::vector<int> widths;
+        getPrefixWidths(text, widths);
 
-        for (i = 0; i < text.size(); ++i)
-        {
-            size = getWidth(text.substr(0,i));
+        // The first prefix wider than x, the last entry (the whole
+        // string) is not taken into account.
+        return std::upper_bound(widths.begin(), widths.end() - 1, x) - widths.begin();
+    }
+
+    void Font::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+    {
+        // Only strings which are valid UTF-8 are split at characters,
+        // anything else is treated as one character per byte.
+        bool utf8 = UTF8StringEditor::isValid(text);
 
-            if (size > x)
+        widths.resize(text.size() + 1);
+        widths[0] = getWidth("");
+
+        for (unsigned int i = 1; i <= text.size(); ++i)
+        {
+            // Continuation bytes of UTF-8 characters share the width of
+            // the prefix before the character.
+            if (utf8 && i < text.size() && (text[i] & 0xc0) == 0x80)
             {
-                return i;
+                widths[i] = widths[i - 1];
+            }
+            else
+            {
+                widths[i] = getWidth(text.substr(0, i));
             }
         }
-
-        return text.size();
     }
 }
@@ -0,0 +1,558 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/geometrycache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "fifechan/util/fcn_math.hpp"
+
+namespace fcn
+{
+    GeometryCache::GeometryCache(unsigned int capacity)
+        : mCapacity(capacity),
+          mHits(0),
+          mMisses(0)
+    {
+    }
+
+    GeometryCache::~GeometryCache()
+    {
+    }
+
+    const GeometryCache::Geometry& GeometryCache::getCircle(unsigned int radius)
+    {
+        Key key;
+        key.shape = Circle;
+        key.radius = radius;
+        key.sangle = 0;
+        key.eangle = 0;
+        key.steps = 0;
+
+        return lookup(key);
+    }
+
+    const GeometryCache::Geometry& GeometryCache::getFillCircle(unsigned int radius)
+    {
+        Key key;
+        key.shape = FillCircle;
+        key.radius = radius;
+        key.sangle = 0;
+        key.eangle = 0;
+        key.steps = 0;
+
+        return lookup(key);
+    }
+
+    const GeometryCache::Geometry& GeometryCache::getCircleSegment(unsigned int radius, int sangle, int eangle)
+    {
+        Key key;
+        key.shape = CircleSegment;
+        key.radius = radius;
+        key.sangle = ((sangle % 360) + 360) % 360;
+        key.eangle = key.sangle + eangle - sangle;
+        key.steps = 0;
+
+        return lookup(key);
+    }
+
+    const GeometryCache::Geometry& GeometryCache::getFillCircleSegment(unsigned int radius, int sangle, int eangle)
+    {
+        Key key;
+        key.shape = FillCircleSegment;
+        key.radius = radius;
+        key.sangle = sangle;
+        key.eangle = eangle;
+        key.steps = 0;
+
+        return lookup(key);
+    }
+
+    const GeometryCache::Geometry& GeometryCache::getBezier(const PointVector& points, int steps)
+    {
+        Key key;
+        key.shape = Bezier;
+        key.radius = 0;
+        key.sangle = 0;
+        key.eangle = 0;
+        key.steps = steps;
+        key.points.reserve(points.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            key.points.push_back(points[i] - points[0]);
+        }
+
+        return lookup(key);
+    }
+
+    void GeometryCache::setCapacity(unsigned int capacity)
+    {
+        mCapacity = capacity;
+        shrink(mCapacity);
+    }
+
+    unsigned int GeometryCache::getCapacity() const
+    {
+        return mCapacity;
+    }
+
+    unsigned int GeometryCache::getSize() const
+    {
+        return mEntries.size();
+    }
+
+    void GeometryCache::clear()
+    {
+        mEntries.clear();
+        mIndex.clear();
+    }
+
+    unsigned int GeometryCache::getHits() const
+    {
+        return mHits;
+    }
+
+    unsigned int GeometryCache::getMisses() const
+    {
+        return mMisses;
+    }
+
+    void GeometryCache::resetStatistics()
+    {
+        mHits = 0;
+        mMisses = 0;
+    }
+
+    bool GeometryCache::Key::operator==(const Key& key) const
+    {
+        return shape == key.shape
+            && radius == key.radius
+            && sangle == key.sangle
+            && eangle == key.eangle
+            && steps == key.steps
+            && points == key.points;
+    }
+
+    std::size_t GeometryCache::KeyHash::operator()(const Key& key) const
+    {
+        std::size_t hash = key.shape;
+        hash = hash * 31 + key.radius;
+        hash = hash * 31 + static_cast<std::size_t>(key.sangle);
+        hash = hash * 31 + static_cast<std::size_t>(key.eangle);
+        hash = hash * 31 + static_cast<std::size_t>(key.steps);
+
+        for (unsigned int i = 0; i < key.points.size(); ++i)
+        {
+            hash = hash * 31 + static_cast<std::size_t>(key.points[i].x);
+            hash = hash * 31 + static_cast<std::size_t>(key.points[i].y);
+        }
+
+        return hash;
+    }
+
+    const GeometryCache::Geometry& GeometryCache::lookup(const Key& key)
+    {
+        EntryIndex::iterator it = mIndex.find(key);
+
+        if (it != mIndex.end())
+        {
+            ++mHits;
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            return it->second->second;
+        }
+
+        ++mMisses;
+
+        if (mCapacity == 0)
+        {
+            mUncached = Geometry();
+            tessellate(key, mUncached);
+            return mUncached;
+        }
+
+        shrink(mCapacity - 1);
+        mEntries.push_front(std::make_pair(key, Geometry()));
+        mIndex[key] = mEntries.begin();
+        tessellate(key, mEntries.front().second);
+
+        return mEntries.front().second;
+    }
+
+    void GeometryCache::tessellate(const Key& key, Geometry& geometry) const
+    {
+        int r = key.radius;
+
+        switch (key.shape)
+        {
+          case Circle:
+          {
+              if (r == 0)
+              {
+                  geometry.points.push_back(Point(0, 0));
+                  break;
+              }
+
+              // Midpoint circle, every pixel exactly once
+              int x = r;
+              int y = 0;
+              int err = 1 - x;
+
+              while (x >= y)
+              {
+                  if (y == 0)
+                  {
+                      geometry.points.push_back(Point(x, 0));
+                      geometry.points.push_back(Point(-x, 0));
+                      geometry.points.push_back(Point(0, x));
+                      geometry.points.push_back(Point(0, -x));
+                  }
+                  else if (x == y)
+                  {
+                      geometry.points.push_back(Point(x, y));
+                      geometry.points.push_back(Point(-x, y));
+                      geometry.points.push_back(Point(x, -y));
+                      geometry.points.push_back(Point(-x, -y));
+                  }
+                  else
+                  {
+                      geometry.points.push_back(Point(x, y));
+                      geometry.points.push_back(Point(-x, y));
+                      geometry.points.push_back(Point(x, -y));
+                      geometry.points.push_back(Point(-x, -y));
+                      geometry.points.push_back(Point(y, x));
+                      geometry.points.push_back(Point(-y, x));
+                      geometry.points.push_back(Point(y, -x));
+                      geometry.points.push_back(Point(-y, -x));
+                  }
+
+                  ++y;
+
+                  if (err < 0)
+                  {
+                      err += 2 * y + 1;
+                  }
+                  else
+                  {
+                      --x;
+                      err += 2 * (y - x) + 1;
+                  }
+              }
+              break;
+          }
+
+          case FillCircle:
+          {
+              std::vector<int> halfWidths;
+              getHalfWidths(r, halfWidths);
+
+              geometry.spans.reserve(2 * r + 1);
+
+              for (int dy = -r; dy <= r; ++dy)
+              {
+                  int halfWidth = halfWidths[std::abs(dy)];
+                  Span span = { dy, -halfWidth, halfWidth };
+                  geometry.spans.push_back(span);
+              }
+
+              // One vertex every two pixels of arc length
+              float radius = r + 0.5f;
+              int steps = std::max(8, static_cast<int>(std::ceil(Mathf::twoPi() * radius / 2.0f)));
+              std::vector<float> xs(steps);
+              std::vector<float> ys(steps);
+
+              for (int i = 0; i < steps; ++i)
+              {
+                  float angle = Mathf::twoPi() * i / steps;
+                  xs[i] = Mathf::Cos(angle) * radius;
+                  ys[i] = Mathf::Sin(angle) * radius;
+              }
+
+              addStrip(xs, ys, geometry.strip);
+              break;
+          }
+
+          case CircleSegment:
+          {
+              // Walk the circle like Circle and keep the pixels in the segment
+              const double toDegrees = 180.0 / Mathd::pi();
+              int sweep = key.eangle - key.sangle;
+              int x = r;
+              int y = 0;
+              int err = 1 - x;
+
+              while (x >= y)
+              {
+                  Point offsets[8];
+                  int count = 0;
+
+                  if (y == 0)
+                  {
+                      offsets[0] = Point(x, 0);
+                      offsets[1] = Point(-x, 0);
+                      offsets[2] = Point(0, x);
+                      offsets[3] = Point(0, -x);
+                      count = 4;
+                  }
+                  else if (x == y)
+                  {
+                      offsets[0] = Point(x, y);
+                      offsets[1] = Point(-x, y);
+                      offsets[2] = Point(x, -y);
+                      offsets[3] = Point(-x, -y);
+                      count = 4;
+                  }
+                  else
+                  {
+                      offsets[0] = Point(x, y);
+                      offsets[1] = Point(-x, y);
+                      offsets[2] = Point(x, -y);
+                      offsets[3] = Point(-x, -y);
+                      offsets[4] = Point(y, x);
+                      offsets[5] = Point(-y, x);
+                      offsets[6] = Point(y, -x);
+                      offsets[7] = Point(-y, -x);
+                      count = 8;
+                  }
+
+                  for (int i = 0; i < count; ++i)
+                  {
+                      double angle = std::atan2(static_cast<double>(offsets[i].y),
+                                                static_cast<double>(offsets[i].x)) * toDegrees;
+                      if (angle < 0.0)
+                      {
+                          angle += 360.0;
+                      }
+
+                      double d = angle - key.sangle;
+
+                      if (d < 0.0)
+                      {
+                          d += 360.0;
+                      }
+
+                      if (d <= sweep)
+                      {
+                          geometry.points.push_back(offsets[i]);
+                      }
+                  }
+
+                  ++y;
+
+                  if (err < 0)
+                  {
+                      err += 2 * y + 1;
+                  }
+                  else
+                  {
+                      --x;
+                      err += 2 * (y - x) + 1;
+                  }
+              }
+
+              const double toRadians = Mathd::pi() / 180.0;
+              double s = key.sangle * toRadians;
+              double e = key.eangle * toRadians;
+
+              geometry.start = Point(static_cast<int>(std::floor(std::cos(s) * r + 0.5)),
+                                     static_cast<int>(std::floor(std::sin(s) * r + 0.5)));
+              geometry.end = Point(static_cast<int>(std::floor(std::cos(e) * r + 0.5)),
+                                   static_cast<int>(std::floor(std::sin(e) * r + 0.5)));
+              break;
+          }
+
+          case FillCircleSegment:
+          {
+              int sweep = key.eangle - key.sangle;
+              float radius = r + 0.5f;
+
+              // One arc vertex every two pixels of arc length
+              const float toRadians = Mathf::pi() / 180.0f;
+              int steps = std::max(2, static_cast<int>(std::ceil(sweep * toRadians * radius / 2.0f)));
+
+              // The polygon around the pixel center of the origin
+              std::vector<float> xs(1, 0.0f);
+              std::vector<float> ys(1, 0.0f);
+
+              for (int i = 0; i <= steps; ++i)
+              {
+                  float angle = (key.sangle + sweep * static_cast<float>(i) / steps) * toRadians;
+                  xs.push_back(Mathf::Cos(angle) * radius);
+                  ys.push_back(Mathf::Sin(angle) * radius);
+              }
+
+              geometry.polygon.reserve(2 * xs.size());
+
+              for (unsigned int i = 0; i < xs.size(); ++i)
+              {
+                  geometry.polygon.push_back(xs[i]);
+                  geometry.polygon.push_back(ys[i]);
+              }
+
+              // Segments wider than a half circle are not convex, split
+              // them in pieces of at most a half circle that are.
+              int stepsPerPiece = 180 * steps / sweep;
+              std::vector<float> pxs;
+              std::vector<float> pys;
+
+              for (int first = 1; first <= steps; first += stepsPerPiece)
+              {
+                  int last = std::min(first + stepsPerPiece, steps + 1);
+
+                  pxs.assign(1, 0.0f);
+                  pys.assign(1, 0.0f);
+                  pxs.insert(pxs.end(), xs.begin() + first, xs.begin() + last + 1);
+                  pys.insert(pys.end(), ys.begin() + first, ys.begin() + last + 1);
+                  addStrip(pxs, pys, geometry.strip);
+              }
+              break;
+          }
+
+          case Bezier:
+          {
+              const PointVector& points = key.points;
+              int n = points.size();
+              int samples = key.steps * (n - 1);
+
+              std::vector<double> xs(n);
+              std::vector<double> ys(n);
+              geometry.points.reserve(samples + 1);
+
+              for (int i = 0; i <= samples; ++i)
+              {
+                  double t = static_cast<double>(i) / samples;
+
+                  // De Casteljau
+                  for (int k = 0; k < n; ++k)
+                  {
+                      xs[k] = points[k].x;
+                      ys[k] = points[k].y;
+                  }
+
+                  for (int level = n - 1; level > 0; --level)
+                  {
+                      for (int k = 0; k < level; ++k)
+                      {
+                          xs[k] += (xs[k + 1] - xs[k]) * t;
+                          ys[k] += (ys[k + 1] - ys[k]) * t;
+                      }
+                  }
+
+                  Point p(static_cast<int>(std::floor(xs[0] + 0.5)),
+                          static_cast<int>(std::floor(ys[0] + 0.5)));
+
+                  if (geometry.points.empty() || geometry.points.back() != p)
+                  {
+                      geometry.points.push_back(p);
+                  }
+              }
+
+              if (geometry.points.size() == 1)
+              {
+                  geometry.points.push_back(geometry.points.front());
+              }
+              break;
+          }
+        }
+    }
+
+    void GeometryCache::getHalfWidths(int radius, std::vector<int>& halfWidths)
+    {
+        halfWidths.assign(radius + 1, 0);
+
+        int x = radius;
+        int y = 0;
+        int err = 1 - x;
+
+        while (x >= y)
+        {
+            halfWidths[y] = std::max(halfWidths[y], x);
+            halfWidths[x] = std::max(halfWidths[x], y);
+
+            ++y;
+
+            if (err < 0)
+            {
+                err += 2 * y + 1;
+            }
+            else
+            {
+                --x;
+                err += 2 * (y - x) + 1;
+            }
+        }
+    }
+
+    void GeometryCache::addStrip(const std::vector<float>& xs,
+                                 const std::vector<float>& ys,
+                                 std::vector<float>& strip)
+    {
+        unsigned int n = xs.size();
+
+        if (n < 3)
+        {
+            return;
+        }
+
+        // Join to the previous strip with two degenerate triangles
+        if (!strip.empty())
+        {
+            float lastX = strip[strip.size() - 2];
+            float lastY = strip[strip.size() - 1];
+            strip.push_back(lastX);
+            strip.push_back(lastY);
+            strip.push_back(xs[0]);
+            strip.push_back(ys[0]);
+        }
+
+        // Zig-zag between both ends of the polygon
+        strip.push_back(xs[0]);
+        strip.push_back(ys[0]);
+
+        unsigned int low = 1;
+        unsigned int high = n - 1;
+        bool fromLow = true;
+
+        while (low <= high)
+        {
+            unsigned int i = fromLow ? low++ : high--;
+            strip.push_back(xs[i]);
+            strip.push_back(ys[i]);
+            fromLow = !fromLow;
+        }
+    }
+
+    void GeometryCache::shrink(unsigned int size)
+    {
+        while (mEntries.size() > size)
+        {
+            mIndex.erase(mEntries.back().first);
+            mEntries.pop_back();
+        }
+    }
+}
@@ -0,0 +1,273 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/graphdatasource.hpp"
+
+#include <algorithm>
+
+#include "fifechan/graphdatalistener.hpp"
+
+namespace fcn
+{
+    GraphDataSource::GraphDataSource()
+        : mWindowWidth(0)
+    {
+
+    }
+
+    GraphDataSource::GraphDataSource(const GraphDataSource& other)
+        : mWindowWidth(other.mWindowWidth)
+    {
+
+    }
+
+    GraphDataSource& GraphDataSource::operator=(const GraphDataSource& other)
+    {
+        mWindowWidth = other.mWindowWidth;
+        return *this;
+    }
+
+    GraphDataSource::~GraphDataSource()
+    {
+        // Listeners usually remove themselves when told, so work on a copy.
+        GraphDataListenerList listeners = mGraphDataListeners;
+
+        for (GraphDataListenerIterator iter = listeners.begin(); iter != listeners.end(); ++iter)
+        {
+            (*iter)->graphDataSourceDeleted(this);
+        }
+    }
+
+    void GraphDataSource::setWindowWidth(int width)
+    {
+        mWindowWidth = std::max(width, 0);
+        distributeWindowChanged();
+    }
+
+    int GraphDataSource::getWindowWidth() const
+    {
+        return mWindowWidth;
+    }
+
+    int GraphDataSource::getWindowStart() const
+    {
+        int points = getNumberOfPoints();
+
+        if (points == 0)
+        {
+            return 0;
+        }
+
+        if (mWindowWidth == 0)
+        {
+            return getPoint(0).x;
+        }
+
+        return getPoint(points - 1).x - mWindowWidth + 1;
+    }
+
+    int GraphDataSource::getWindowEnd() const
+    {
+        int points = getNumberOfPoints();
+
+        if (points == 0)
+        {
+            return 0;
+        }
+
+        return getPoint(points - 1).x + 1;
+    }
+
+    void GraphDataSource::getPoints(int startX, int endX, PointVector& points) const
+    {
+        int first = findPoint(startX);
+        int last = findPoint(endX);
+
+        while (first < last)
+        {
+            int column = getPoint(first).x;
+            int next = findPoint(column + 1);
+
+            if (next - first <= 2)
+            {
+                for (int i = first; i < next; ++i)
+                {
+                    points.push_back(getPoint(i));
+                }
+            }
+            else
+            {
+                // Keep the extremes of the column in the order they appear.
+                int min;
+                int max;
+                getExtremes(first, next - first, min, max);
+                points.push_back(getPoint(std::min(min, max)));
+
+                if (min != max)
+                {
+                    points.push_back(getPoint(std::max(min, max)));
+                }
+            }
+
+            first = next;
+        }
+    }
+
+    void GraphDataSource::updateWindowPoints(PointVector& points, int& start, int& end) const
+    {
+        int windowStart = getWindowStart();
+        int windowEnd = getWindowEnd();
+
+        // Columns before the oldest point lost all their points, the
+        // column of the oldest point may have lost some. The last fetched
+        // column may have got new points.
+        int oldest = getNumberOfPoints() > 0 ? getPoint(0).x : windowEnd;
+        int valid = std::max(windowStart, oldest + 1);
+        int validEnd = end - 1;
+
+        if (getNumberOfPoints() == 0
+            || start > windowStart
+            || end > windowEnd
+            || valid >= validEnd)
+        {
+            points.clear();
+            getPoints(windowStart, windowEnd, points);
+            start = windowStart;
+            end = windowEnd;
+            return;
+        }
+
+        PointVector updated;
+        updated.reserve(points.size());
+
+        if (oldest >= windowStart)
+        {
+            getPoints(oldest, valid, updated);
+        }
+
+        for (PointVector::const_iterator iter = points.begin(); iter != points.end(); ++iter)
+        {
+            if (iter->x >= valid && iter->x < validEnd)
+            {
+                updated.push_back(*iter);
+            }
+        }
+
+        getPoints(validEnd, windowEnd, updated);
+
+        points.swap(updated);
+        start = windowStart;
+        end = windowEnd;
+    }
+
+    void GraphDataSource::addGraphDataListener(GraphDataListener* graphDataListener)
+    {
+        mGraphDataListeners.push_back(graphDataListener);
+    }
+
+    void GraphDataSource::removeGraphDataListener(GraphDataListener* graphDataListener)
+    {
+        mGraphDataListeners.remove(graphDataListener);
+    }
+
+    int GraphDataSource::findPoint(int x) const
+    {
+        int first = 0;
+        int count = getNumberOfPoints();
+
+        while (count > 0)
+        {
+            int half = count / 2;
+
+            if (getPoint(first + half).x < x)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        return first;
+    }
+
+    void GraphDataSource::getExtremes(int first, int count, int& min, int& max) const
+    {
+        min = first;
+        max = first;
+        int minY = getPoint(first).y;
+        int maxY = minY;
+
+        for (int i = first + 1; i < first + count; ++i)
+        {
+            int y = getPoint(i).y;
+
+            if (y < minY)
+            {
+                min = i;
+                minY = y;
+            }
+
+            if (y > maxY)
+            {
+                max = i;
+                maxY = y;
+            }
+        }
+    }
+
+    void GraphDataSource::distributePointsAppended(int count)
+    {
+        GraphDataListenerIterator iter;
+
+        for (iter = mGraphDataListeners.begin(); iter != mGraphDataListeners.end(); ++iter)
+        {
+            (*iter)->pointsAppended(this, count);
+        }
+    }
+
+    void GraphDataSource::distributePointsRemoved(int count)
+    {
+        GraphDataListenerIterator iter;
+
+        for (iter = mGraphDataListeners.begin(); iter != mGraphDataListeners.end(); ++iter)
+        {
+            (*iter)->pointsRemoved(this, count);
+        }
+    }
+
+    void GraphDataSource::distributeWindowChanged()
+    {
+        GraphDataListenerIterator iter;
+
+        for (iter = mGraphDataListeners.begin(); iter != mGraphDataListeners.end(); ++iter)
+        {
+            (*iter)->windowChanged(this);
+        }
+    }
+}
@@ -173,4 +173,24 @@ namespace fcn
               throw FCN_EXCEPTION("Unknown alignment.");
         }
     }
+
+    Image* Graphics::createTarget(int width, int height)
+    {
+        return NULL;
+    }
+
+    void Graphics::pushTarget(Image* image)
+    {
+        throw FCN_EXCEPTION("Drawing to images is not supported.");
+    }
+
+    void Graphics::popTarget()
+    {
+        throw FCN_EXCEPTION("Drawing to images is not supported.");
+    }
+
+    void Graphics::copyArea(const Rectangle& area, int dx, int dy)
+    {
+        throw FCN_EXCEPTION("Copying areas is not supported.");
+    }
 }
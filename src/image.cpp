@@ -68,6 +68,7 @@
 
 #include "fifechan/image.hpp"
 
+#include "fifechan/color.hpp"
 #include "fifechan/exception.hpp"
 #include "fifechan/imageloader.hpp"
 
@@ -103,4 +104,20 @@ namespace fcn
 
         return mImageLoader->load(filename, convertToDisplayFormat);
     }
+
+    void Image::readPixels(std::vector<Color>& pixels)
+    {
+        int width = getWidth();
+        int height = getHeight();
+
+        pixels.resize(width * height);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                pixels[x + y * width] = getPixel(x, y);
+            }
+        }
+    }
 }
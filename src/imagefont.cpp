@@ -68,6 +68,7 @@
 
 #include "fifechan/imagefont.hpp"
 
+#include <fstream>
 #include <sstream>
 
 #include "fifechan/color.hpp"
@@ -77,101 +78,77 @@
 
 namespace fcn
 {
-    ImageFont::ImageFont(const std::string& filename,
-                         const std::string& glyphs)
+    /**
+     * Hashes the pixels of a font image and its glyph list with 64 bit
+     * FNV-1a, to validate metrics files.
+     */
+    static unsigned long long hashGlyphSheet(const std::vector<Color>& pixels,
+                                             int width,
+                                             int height,
+                                             const std::vector<unsigned int>& glyphs)
     {
-        mFilename = filename;
-        mImage = Image::load(filename, false);
+        unsigned long long hash = 14695981039346656037ULL;
+        const unsigned long long prime = 1099511628211ULL;
 
-        Color separator = mImage->getPixel(0, 0);
+        hash = (hash ^ (unsigned int)width) * prime;
+        hash = (hash ^ (unsigned int)height) * prime;
 
-        int i = 0;
-        for (i = 0;
-             i < mImage->getWidth() && separator == mImage->getPixel(i, 0);
-             ++i)
+        for (unsigned int i = 0; i < pixels.size(); ++i)
         {
+            const Color& c = pixels[i];
+            hash = (hash ^ (c.r & 0xff)) * prime;
+            hash = (hash ^ (c.g & 0xff)) * prime;
+            hash = (hash ^ (c.b & 0xff)) * prime;
+            hash = (hash ^ (c.a & 0xff)) * prime;
         }
 
-        if (i >= mImage->getWidth())
+        for (unsigned int i = 0; i < glyphs.size(); ++i)
         {
-            throw FCN_EXCEPTION("Corrupt image.");
+            hash = (hash ^ glyphs[i]) * prime;
         }
 
-        int j = 0;
-        for (j = 0; j < mImage->getHeight(); ++j)
-        {
-            if (separator == mImage->getPixel(i, j))
-            {
-                break;
-            }
-        }
+        return hash;
+    }
 
-        mHeight = j;
-        int x = 0, y = 0;
-        unsigned char k;
+    ImageFont::ImageFont(const std::string& filename,
+                         const std::string& glyphs,
+                         const std::string& metricsFilename)
+    {
+        mFilename = filename;
+        mImage = Image::load(filename, false);
 
-        for (i = 0; i < (int)glyphs.size(); ++i)
+        std::vector<unsigned int> codePoints;
+        unsigned int i = 0;
+        while (i < glyphs.size())
         {
-            k = glyphs.at(i);
-            mGlyph[k] = scanForGlyph(k, x, y, separator);
-            // Update x och y with new coordinates.
-            x = mGlyph[k].x + mGlyph[k].width;
-            y =  mGlyph[k].y;
+            codePoints.push_back(decodeGlyph(glyphs, i));
         }
 
-        mImage->convertToDisplayFormat();
+        loadGlyphs(codePoints, metricsFilename);
 
         mRowSpacing = 0;
         mGlyphSpacing = 0;
     }
 
     ImageFont::ImageFont(Image* image,
-                         const std::string& glyphs)
+                         const std::string& glyphs,
+                         const std::string& metricsFilename)
     {
         mFilename = "Image*";
         if (image == NULL)
         {
-                FCN_EXCEPTION("Font image is NULL");
+                throw FCN_EXCEPTION("Font image is NULL");
         }
         mImage = image;
 
-        Color separator = mImage->getPixel(0, 0);
-
-        int i = 0;
-        for (i = 0;
-             i < mImage->getWidth() && separator == mImage->getPixel(i, 0);
-             ++i)
-        {
-        }
-
-        if (i >= mImage->getWidth())
+        std::vector<unsigned int> codePoints;
+        unsigned int i = 0;
+        while (i < glyphs.size())
         {
-            throw FCN_EXCEPTION("Corrupt image.");
+            codePoints.push_back(decodeGlyph(glyphs, i));
         }
 
-        int j = 0;
-        for (j = 0; j < mImage->getHeight(); ++j)
-        {
-            if (separator == mImage->getPixel(i, j))
-            {
-                break;
-            }
-        }
-
-        mHeight = j;
-        int x = 0, y = 0;
-        unsigned char k;
-
-        for (i = 0; i < (int)glyphs.size(); ++i)
-        {
-            k = glyphs.at(i);
-            mGlyph[k] = scanForGlyph(k, x, y, separator);
-            // Update x och y with new coordinates.
-            x = mGlyph[k].x + mGlyph[k].width;
-            y =  mGlyph[k].y;
-        }
-
-        mImage->convertToDisplayFormat();
+        loadGlyphs(codePoints, metricsFilename);
 
         mRowSpacing = 0;
         mGlyphSpacing = 0;
@@ -179,45 +156,19 @@ namespace fcn
 
     ImageFont::ImageFont(const std::string& filename,
                          unsigned char glyphsFrom,
-                         unsigned char glyphsTo)
+                         unsigned char glyphsTo,
+                         const std::string& metricsFilename)
     {
         mFilename = filename;
         mImage = Image::load(filename, false);
 
-        Color separator = mImage->getPixel(0, 0);
-
-        int i = 0;
-        for (i=0; separator == mImage->getPixel(i, 0)
-                 && i < mImage->getWidth(); ++i)
-        {
-        }
-
-        if (i >= mImage->getWidth())
-        {
-            throw FCN_EXCEPTION("Corrupt image.");
-        }
-
-        int j = 0;
-        for (j = 0; j < mImage->getHeight(); ++j)
+        std::vector<unsigned int> codePoints;
+        for (int i = glyphsFrom; i < glyphsTo + 1; i++)
         {
-            if (separator == mImage->getPixel(i, j))
-            {
-                break;
-            }
+            codePoints.push_back(i);
         }
 
-        mHeight = j;
-        int x = 0, y = 0;
-
-        for (i = glyphsFrom; i < glyphsTo + 1; i++)
-        {
-            mGlyph[i] = scanForGlyph(i, x, y, separator);
-            // Update x och y with new coordinates.
-            x = mGlyph[i].x + mGlyph[i].width;
-            y =  mGlyph[i].y;
-        }
-
-        mImage->convertToDisplayFormat();
+        loadGlyphs(codePoints, metricsFilename);
 
         mRowSpacing = 0;
         mGlyphSpacing = 0;
@@ -225,17 +176,24 @@ namespace fcn
 
     ImageFont::~ImageFont()
     {
+        for (unsigned int i = 0; i < mGlyphPages.size(); ++i)
+        {
+            delete[] mGlyphPages[i];
+        }
+
         delete mImage;
     }
 
-    int ImageFont::getWidth(unsigned char glyph) const
+    int ImageFont::getWidth(unsigned int glyph) const
     {
-        if (mGlyph[glyph].width == 0)
+        const Rectangle& area = getGlyph(glyph);
+
+        if (area.width == 0)
         {
             return mGlyph[(int)(' ')].width + mGlyphSpacing;
         }
 
-        return mGlyph[glyph].width + mGlyphSpacing;
+        return area.width + mGlyphSpacing;
     }
 
     int ImageFont::getHeight() const
@@ -244,14 +202,16 @@ namespace fcn
     }
 
     int ImageFont::drawGlyph(Graphics* graphics,
-                             unsigned char glyph,
+                             unsigned int glyph,
                              int x, int y)
     {
         // This is needed for drawing the glyph in the middle
         // if we have spacing.
         int yoffset = getRowSpacing() / 2;
 
-        if (mGlyph[glyph].width == 0)
+        const Rectangle& area = getGlyph(glyph);
+
+        if (area.width == 0)
         {
             graphics->drawRectangle(x,
                                     y + 1 + yoffset,
@@ -262,14 +222,14 @@ namespace fcn
         }
 
         graphics->drawImage(mImage,
-                            mGlyph[glyph].x,
-                            mGlyph[glyph].y,
+                            area.x,
+                            area.y,
                             x,
                             y + yoffset,
-                            mGlyph[glyph].width,
-                            mGlyph[glyph].height);
+                            area.width,
+                            area.height);
 
-        return mGlyph[glyph].width + mGlyphSpacing;
+        return area.width + mGlyphSpacing;
     }
 
     void ImageFont::drawString(Graphics* graphics,
@@ -277,12 +237,11 @@ namespace fcn
                                int x,
                                int y)
     {
-        unsigned int i;
+        unsigned int i = 0;
 
-        for (i = 0; i < text.size(); ++i)
+        while (i < text.size())
         {
-            drawGlyph(graphics, text.at(i), x, y);
-            x += getWidth(text.at(i));
+            x += drawGlyph(graphics, decodeGlyph(text, i), x, y);
         }
     }
 
@@ -299,6 +258,7 @@ namespace fcn
     void ImageFont::setGlyphSpacing(int spacing)
     {
         mGlyphSpacing = spacing;
+        invalidateMetrics();
     }
 
     int ImageFont::getGlyphSpacing()
@@ -306,35 +266,37 @@ namespace fcn
         return mGlyphSpacing;
     }
 
-    Rectangle ImageFont::scanForGlyph(unsigned char glyph,
+    Rectangle ImageFont::scanForGlyph(unsigned int glyph,
                                       int x,
                                       int y,
-                                      const Color& separator)
+                                      const Color& separator,
+                                      const std::vector<Color>& pixels)
     {
+        const int imageWidth = mImage->getWidth();
+        const int imageHeight = mImage->getHeight();
         Color color;
         do
         {
             ++x;
 
-            if (x >= mImage->getWidth())
+            if (x >= imageWidth)
             {
                 y += mHeight + 1;
                 x = 0;
 
-                if (y >= mImage->getHeight())
+                if (y >= imageHeight)
                 {
                     std::string str;
                     std::ostringstream os(str);
                     os << "Image ";
                     os << mFilename;
-                    os << " with font is corrupt near character '";
+                    os << " with font is corrupt near code point ";
                     os << glyph;
-                    os << "'";
                     throw FCN_EXCEPTION(os.str());
                 }
             }
 
-            color = mImage->getPixel(x, y);
+            color = pixels[x + y * imageWidth];
 
         } while (color == separator);
 
@@ -344,33 +306,283 @@ namespace fcn
         {
             ++width;
 
-            if (x + width >= mImage->getWidth())
+            if (x + width >= imageWidth)
             {
                 std::string str;
                 std::ostringstream os(str);
                 os << "Image ";
                 os << mFilename;
-                os << " with font is corrupt near character '";
+                os << " with font is corrupt near code point ";
                 os << glyph;
-                os << "'";
                 throw FCN_EXCEPTION(os.str());
             }
 
-            color = mImage->getPixel(x + width, y);
+            color = pixels[x + width + y * imageWidth];
 
         } while (color != separator);
 
         return Rectangle(x, y, width, mHeight);
     }
 
+    void ImageFont::loadGlyphs(const std::vector<unsigned int>& glyphs,
+                               const std::string& metricsFilename)
+    {
+        // Read all pixels at once, getPixel is slow on most images
+        std::vector<Color> pixels;
+        mImage->readPixels(pixels);
+
+        const int imageWidth = mImage->getWidth();
+        const int imageHeight = mImage->getHeight();
+
+        unsigned long long hash = 0;
+
+        if (!metricsFilename.empty())
+        {
+            hash = hashGlyphSheet(pixels, imageWidth, imageHeight, glyphs);
+
+            if (loadMetrics(metricsFilename, glyphs, hash))
+            {
+                mImage->convertToDisplayFormat();
+                return;
+            }
+        }
+
+        if (pixels.empty())
+        {
+            throw FCN_EXCEPTION("Corrupt image.");
+        }
+
+        Color separator = pixels[0];
+
+        int i = 0;
+        for (i = 0; i < imageWidth && separator == pixels[i]; ++i)
+        {
+        }
+
+        if (i >= imageWidth)
+        {
+            throw FCN_EXCEPTION("Corrupt image.");
+        }
+
+        int j = 0;
+        for (j = 0; j < imageHeight; ++j)
+        {
+            if (separator == pixels[i + j * imageWidth])
+            {
+                break;
+            }
+        }
+
+        mHeight = j;
+        int x = 0, y = 0;
+
+        for (unsigned int k = 0; k < glyphs.size(); ++k)
+        {
+            Rectangle& area = addGlyph(glyphs[k]);
+            area = scanForGlyph(glyphs[k], x, y, separator, pixels);
+            // Update x och y with new coordinates.
+            x = area.x + area.width;
+            y = area.y;
+        }
+
+        if (!metricsFilename.empty())
+        {
+            saveMetrics(metricsFilename, glyphs, hash);
+        }
+
+        mImage->convertToDisplayFormat();
+    }
+
+    bool ImageFont::loadMetrics(const std::string& metricsFilename,
+                                const std::vector<unsigned int>& glyphs,
+                                unsigned long long hash)
+    {
+        std::ifstream in(metricsFilename.c_str());
+
+        if (!in)
+        {
+            return false;
+        }
+
+        std::string magic;
+        int version = 0;
+        unsigned long long fileHash = 0;
+        unsigned int count = 0;
+        int height = 0;
+
+        in >> magic >> version >> std::hex >> fileHash >> std::dec >> height >> count;
+
+        if (!in
+            || magic != "fifechan-imagefont-metrics"
+            || version != 1
+            || fileHash != hash
+            || count != glyphs.size()
+            || height < 0
+            || height > mImage->getHeight())
+        {
+            return false;
+        }
+
+        std::vector<Rectangle> areas(count);
+
+        for (unsigned int k = 0; k < count; ++k)
+        {
+            unsigned int glyph = 0;
+            Rectangle& area = areas[k];
+
+            in >> glyph >> area.x >> area.y >> area.width;
+            area.height = height;
+
+            if (!in
+                || glyph != glyphs[k]
+                || area.x < 0
+                || area.y < 0
+                || area.width < 0
+                || area.x + area.width > mImage->getWidth()
+                || area.y + area.height > mImage->getHeight())
+            {
+                return false;
+            }
+        }
+
+        mHeight = height;
+
+        for (unsigned int k = 0; k < count; ++k)
+        {
+            addGlyph(glyphs[k]) = areas[k];
+        }
+
+        return true;
+    }
+
+    void ImageFont::saveMetrics(const std::string& metricsFilename,
+                                const std::vector<unsigned int>& glyphs,
+                                unsigned long long hash) const
+    {
+        std::ofstream out(metricsFilename.c_str());
+
+        if (!out)
+        {
+            return;
+        }
+
+        out << "fifechan-imagefont-metrics 1\n";
+        out << std::hex << hash << std::dec << "\n";
+        out << mHeight << " " << glyphs.size() << "\n";
+
+        for (unsigned int k = 0; k < glyphs.size(); ++k)
+        {
+            const Rectangle& area = getGlyph(glyphs[k]);
+            out << glyphs[k] << " " << area.x << " " << area.y << " " << area.width << "\n";
+        }
+    }
+
+    const Rectangle& ImageFont::getPagedGlyph(unsigned int glyph) const
+    {
+        static const Rectangle missing;
+
+        unsigned int page = glyph >> 8;
+
+        if (page >= mGlyphPages.size() || mGlyphPages[page] == NULL)
+        {
+            return missing;
+        }
+
+        return mGlyphPages[page][glyph & 0xff];
+    }
+
+    Rectangle& ImageFont::addGlyph(unsigned int glyph)
+    {
+        if (glyph < 256)
+        {
+            return mGlyph[glyph];
+        }
+
+        unsigned int page = glyph >> 8;
+
+        if (page >= mGlyphPages.size())
+        {
+            mGlyphPages.resize(page + 1, NULL);
+        }
+
+        if (mGlyphPages[page] == NULL)
+        {
+            mGlyphPages[page] = new Rectangle[256];
+        }
+
+        return mGlyphPages[page][glyph & 0xff];
+    }
+
+    unsigned int ImageFont::decodeMultiByteGlyph(const std::string& text, unsigned int& index)
+    {
+        // Smallest code point of a sequence of each length, anything below
+        // is an overlong encoding.
+        static const unsigned int minimum[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+        unsigned char c = text[index];
+        unsigned int glyph;
+        unsigned int length;
+
+        if ((c & 0xe0) == 0xc0)
+        {
+            length = 2;
+            glyph = c & 0x1f;
+        }
+        else if ((c & 0xf0) == 0xe0)
+        {
+            length = 3;
+            glyph = c & 0x0f;
+        }
+        else if ((c & 0xf8) == 0xf0)
+        {
+            length = 4;
+            glyph = c & 0x07;
+        }
+        else
+        {
+            ++index;
+            return c;
+        }
+
+        if (index + length > text.size())
+        {
+            ++index;
+            return c;
+        }
+
+        for (unsigned int i = 1; i < length; ++i)
+        {
+            unsigned char d = text[index + i];
+
+            if ((d & 0xc0) != 0x80)
+            {
+                ++index;
+                return c;
+            }
+
+            glyph = (glyph << 6) | (d & 0x3f);
+        }
+
+        if (glyph < minimum[length]
+            || glyph > 0x10ffff
+            || (glyph >= 0xd800 && glyph <= 0xdfff))
+        {
+            ++index;
+            return c;
+        }
+
+        index += length;
+        return glyph;
+    }
+
     int ImageFont::getWidth(const std::string& text) const
     {
-        unsigned int i;
+        unsigned int i = 0;
         int size = 0;
 
-        for (i = 0; i < text.size(); ++i)
+        while (i < text.size())
         {
-            size += getWidth(text.at(i));
+            size += getWidth(decodeGlyph(text, i));
         }
 
         return size - mGlyphSpacing;
@@ -378,19 +590,42 @@ namespace fcn
 
     int ImageFont::getStringIndexAt(const std::string& text, int x) const
     {
-        unsigned int i;
+        unsigned int i = 0;
         int size = 0;
 
-        for (i = 0; i < text.size(); ++i)
+        while (i < text.size())
         {
-            size += getWidth(text.at(i));
+            unsigned int start = i;
+            size += getWidth(decodeGlyph(text, i));
 
             if (size > x)
             {
-                return i;
+                return start;
             }
         }
 
         return text.size();
     }
+
+    void ImageFont::getPrefixWidths(const std::string& text, std::vector<int>& widths) const
+    {
+        unsigned int i = 0;
+        int size = 0;
+
+        widths.resize(text.size() + 1);
+        widths[0] = -mGlyphSpacing;
+
+        while (i < text.size())
+        {
+            unsigned int start = i;
+            size += getWidth(decodeGlyph(text, i));
+
+            for (unsigned int j = start + 1; j < i; ++j)
+            {
+                widths[j] = widths[start];
+            }
+
+            widths[i] = size - mGlyphSpacing;
+        }
+    }
 }
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/listmodel.hpp"
+
+#include "fifechan/listmodellistener.hpp"
+
+namespace fcn
+{
+    ListModel::~ListModel()
+    {
+        // Listeners usually remove themselves when told, so work on a copy.
+        ListModelListenerList listeners = mListModelListeners;
+
+        for (ListModelListenerIterator iter = listeners.begin(); iter != listeners.end(); ++iter)
+        {
+            (*iter)->listModelDeleted(this);
+        }
+    }
+
+    void ListModel::addListModelListener(ListModelListener* listModelListener)
+    {
+        mListModelListeners.push_back(listModelListener);
+    }
+
+    void ListModel::removeListModelListener(ListModelListener* listModelListener)
+    {
+        mListModelListeners.remove(listModelListener);
+    }
+
+    void ListModel::distributeElementsInserted(int first, int count)
+    {
+        ListModelListenerIterator iter;
+
+        for (iter = mListModelListeners.begin(); iter != mListModelListeners.end(); ++iter)
+        {
+            (*iter)->elementsInserted(this, first, count);
+        }
+    }
+
+    void ListModel::distributeElementsRemoved(int first, int count)
+    {
+        ListModelListenerIterator iter;
+
+        for (iter = mListModelListeners.begin(); iter != mListModelListeners.end(); ++iter)
+        {
+            (*iter)->elementsRemoved(this, first, count);
+        }
+    }
+
+    void ListModel::distributeElementsChanged(int first, int count)
+    {
+        ListModelListenerIterator iter;
+
+        for (iter = mListModelListeners.begin(); iter != mListModelListeners.end(); ++iter)
+        {
+            (*iter)->elementsChanged(this, first, count);
+        }
+    }
+}
@@ -0,0 +1,868 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/memory/memorygraphics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/memory/memoryimage.hpp"
+#include "fifechan/memory/memorypixel.hpp"
+#include "fifechan/util/fcn_math.hpp"
+
+namespace fcn
+{
+    namespace
+    {
+        /**
+         * Lines with coordinates up to this magnitude are drawn exactly by
+         * rasterLine, the products of their lengths fit in 64 bits.
+         */
+        const long long MaximumExactCoordinate = 1LL << 29;
+
+        /**
+         * Clips a line against a rectangle using Liang-Barsky.
+         *
+         * @return False if the line misses the rectangle.
+         */
+        bool clipLine(double& x1, double& y1, double& x2, double& y2,
+                      double left, double top, double right, double bottom)
+        {
+            double dx = x2 - x1;
+            double dy = y2 - y1;
+            double p[4] = { -dx, dx, -dy, dy };
+            double q[4] = { x1 - left, right - x1, y1 - top, bottom - y1 };
+            double t1 = 0.0;
+            double t2 = 1.0;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                if (p[i] == 0.0)
+                {
+                    if (q[i] < 0.0)
+                    {
+                        return false;
+                    }
+                }
+                else if (p[i] < 0.0)
+                {
+                    t1 = std::max(t1, q[i] / p[i]);
+                }
+                else
+                {
+                    t2 = std::min(t2, q[i] / p[i]);
+                }
+            }
+
+            if (t1 > t2)
+            {
+                return false;
+            }
+
+            x2 = x1 + t2 * dx;
+            y2 = y1 + t2 * dy;
+            x1 = x1 + t1 * dx;
+            y1 = y1 + t1 * dy;
+
+            return true;
+        }
+    }
+
+    MemoryGraphics::MemoryGraphics()
+    {
+        mTarget = NULL;
+        mPixel = MemoryMapRGBA(mColor);
+        mAlpha = false;
+    }
+
+    MemoryGraphics::MemoryGraphics(MemoryImage* target)
+    {
+        mTarget = target;
+        mPixel = MemoryMapRGBA(mColor);
+        mAlpha = false;
+    }
+
+    MemoryGraphics::~MemoryGraphics()
+    {
+    }
+
+    void MemoryGraphics::setTarget(MemoryImage* target)
+    {
+        mTarget = target;
+    }
+
+    MemoryImage* MemoryGraphics::getTarget() const
+    {
+        return mTarget;
+    }
+
+    void MemoryGraphics::_beginDraw()
+    {
+        if (mTarget == NULL || mTarget->getPixels() == NULL)
+        {
+            throw FCN_EXCEPTION("No target to draw to, perhaps you forgot to call setTarget()?");
+        }
+
+        Rectangle area;
+        area.x = 0;
+        area.y = 0;
+        area.width = mTarget->getWidth();
+        area.height = mTarget->getHeight();
+        pushClipArea(area);
+    }
+
+    void MemoryGraphics::_endDraw()
+    {
+        popClipArea();
+    }
+
+    const ClipRectangle& MemoryGraphics::getTopClipArea() const
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        return mClipStack.top();
+    }
+
+    void MemoryGraphics::plot(int x, int y)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        if (!top.isContaining(x, y))
+        {
+            return;
+        }
+
+        unsigned int* p = mTarget->getPixels() + y * mTarget->getWidth() + x;
+
+        if (mAlpha)
+        {
+            *p = MemoryAlpha32(mPixel, *p, mColor.a);
+        }
+        else
+        {
+            *p = mPixel;
+        }
+    }
+
+    void MemoryGraphics::drawSpan(int x1, int x2, int y)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        if (y < top.y || y >= top.y + top.height)
+        {
+            return;
+        }
+
+        x1 = std::max(x1, top.x);
+        x2 = std::min(x2, top.x + top.width - 1);
+
+        if (x1 > x2)
+        {
+            return;
+        }
+
+        unsigned int* p = mTarget->getPixels() + y * mTarget->getWidth() + x1;
+
+        if (mAlpha)
+        {
+            MemoryBlendSpan(p, x2 - x1 + 1, mPixel, mColor.a);
+        }
+        else
+        {
+            MemoryFillSpan(p, x2 - x1 + 1, mPixel);
+        }
+    }
+
+    void MemoryGraphics::rasterLine(long long x1, long long y1, long long x2, long long y2)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        if (x1 < -MaximumExactCoordinate || x1 > MaximumExactCoordinate
+            || y1 < -MaximumExactCoordinate || y1 > MaximumExactCoordinate
+            || x2 < -MaximumExactCoordinate || x2 > MaximumExactCoordinate
+            || y2 < -MaximumExactCoordinate || y2 > MaximumExactCoordinate)
+        {
+            // Move the far away ends onto the border of the clip area.
+            // The line may be off by a pixel then, which only happens for
+            // lines ending far outside of the target.
+            double fx1 = static_cast<double>(x1);
+            double fy1 = static_cast<double>(y1);
+            double fx2 = static_cast<double>(x2);
+            double fy2 = static_cast<double>(y2);
+
+            if (!clipLine(fx1, fy1, fx2, fy2,
+                          top.x - 1, top.y - 1, top.x + top.width, top.y + top.height))
+            {
+                return;
+            }
+
+            x1 = static_cast<long long>(std::floor(fx1 + 0.5));
+            y1 = static_cast<long long>(std::floor(fy1 + 0.5));
+            x2 = static_cast<long long>(std::floor(fx2 + 0.5));
+            y2 = static_cast<long long>(std::floor(fy2 + 0.5));
+        }
+
+        if (y1 == y2)
+        {
+            if (y1 < top.y || y1 >= top.y + top.height)
+            {
+                return;
+            }
+
+            long long left = std::max(std::min(x1, x2), static_cast<long long>(top.x));
+            long long right = std::min(std::max(x1, x2), static_cast<long long>(top.x + top.width - 1));
+
+            if (left <= right)
+            {
+                drawSpan(static_cast<int>(left), static_cast<int>(right), static_cast<int>(y1));
+            }
+
+            return;
+        }
+
+        // Bresenham takes one step along the major axis per pixel and puts
+        // step i at floor((2 * i * minorLength + majorLength) /
+        // (2 * majorLength)) along the minor axis. That gives the steps
+        // inside the clip area directly, so only those are walked.
+        bool steep = (y2 > y1 ? y2 - y1 : y1 - y2) > (x2 > x1 ? x2 - x1 : x1 - x2);
+
+        long long major1 = steep ? y1 : x1;
+        long long major2 = steep ? y2 : x2;
+        long long minor1 = steep ? x1 : y1;
+        long long minor2 = steep ? x2 : y2;
+        long long majorStep = major1 < major2 ? 1 : -1;
+        long long minorStep = minor1 < minor2 ? 1 : -1;
+        long long majorLength = (major2 - major1) * majorStep;
+        long long minorLength = (minor2 - minor1) * minorStep;
+
+        long long majorLow = steep ? top.y : top.x;
+        long long majorHigh = majorLow + (steep ? top.height : top.width) - 1;
+        long long minorLow = steep ? top.x : top.y;
+        long long minorHigh = minorLow + (steep ? top.width : top.height) - 1;
+
+        // The steps and the minor offsets inside the clip area.
+        long long first = std::max(majorStep > 0 ? majorLow - major1 : major1 - majorHigh, 0LL);
+        long long last = std::min(majorStep > 0 ? majorHigh - major1 : major1 - majorLow, majorLength);
+        long long offsetLow = std::max(minorStep > 0 ? minorLow - minor1 : minor1 - minorHigh, 0LL);
+        long long offsetHigh = std::min(minorStep > 0 ? minorHigh - minor1 : minor1 - minorLow, minorLength);
+
+        if (offsetLow > offsetHigh)
+        {
+            return;
+        }
+
+        if (minorLength > 0)
+        {
+            if (offsetLow > 0)
+            {
+                // The first step reaching offsetLow.
+                first = std::max(first, ((2 * offsetLow - 1) * majorLength + 2 * minorLength - 1) / (2 * minorLength));
+            }
+
+            if (offsetHigh < minorLength)
+            {
+                // The last step before offsetHigh + 1.
+                last = std::min(last, ((2 * offsetHigh + 1) * majorLength - 1) / (2 * minorLength));
+            }
+        }
+
+        if (first > last)
+        {
+            return;
+        }
+
+        long long numerator = 2 * first * minorLength + majorLength;
+        long long offset = numerator / (2 * majorLength);
+        long long err = numerator % (2 * majorLength);
+        long long major = major1 + majorStep * first;
+
+        for (long long i = first; i <= last; ++i)
+        {
+            long long minor = minor1 + minorStep * offset;
+
+            if (steep)
+            {
+                plot(static_cast<int>(minor), static_cast<int>(major));
+            }
+            else
+            {
+                plot(static_cast<int>(major), static_cast<int>(minor));
+            }
+
+            major += majorStep;
+            err += 2 * minorLength;
+
+            if (err >= 2 * majorLength)
+            {
+                err -= 2 * majorLength;
+                ++offset;
+            }
+        }
+    }
+
+    void MemoryGraphics::fillPolygon(const std::vector<float>& xs, const std::vector<float>& ys)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        if (xs.size() < 3 || xs.size() != ys.size())
+        {
+            return;
+        }
+
+        float ymin = *std::min_element(ys.begin(), ys.end());
+        float ymax = *std::max_element(ys.begin(), ys.end());
+
+        // Rows whose pixel centers lie within [ymin, ymax)
+        int row1 = std::max(static_cast<int>(std::ceil(ymin - 0.5f)), top.y);
+        int row2 = std::min(static_cast<int>(std::ceil(ymax - 0.5f)) - 1, top.y + top.height - 1);
+
+        unsigned int n = xs.size();
+
+        for (int row = row1; row <= row2; ++row)
+        {
+            float yc = row + 0.5f;
+
+            mCrossings.clear();
+            for (unsigned int i = 0, j = n - 1; i < n; j = i++)
+            {
+                if ((ys[i] > yc) != (ys[j] > yc))
+                {
+                    mCrossings.push_back(xs[i] + (yc - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i]));
+                }
+            }
+
+            std::sort(mCrossings.begin(), mCrossings.end());
+
+            for (unsigned int i = 0; i + 1 < mCrossings.size(); i += 2)
+            {
+                int x1 = static_cast<int>(std::ceil(mCrossings[i] - 0.5f));
+                int x2 = static_cast<int>(std::ceil(mCrossings[i + 1] - 0.5f)) - 1;
+                drawSpan(x1, x2, row);
+            }
+        }
+    }
+
+    void MemoryGraphics::drawImage(const Image* image,
+                                   int srcX,
+                                   int srcY,
+                                   int dstX,
+                                   int dstY,
+                                   int width,
+                                   int height)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        const MemoryImage* srcImage = dynamic_cast<const MemoryImage*>(image);
+
+        if (srcImage == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw an image of unknown format, must be a MemoryImage.");
+        }
+
+        if (srcImage->getPixels() == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw a freed image.");
+        }
+
+        dstX += top.xOffset;
+        dstY += top.yOffset;
+
+        // Clip the source rectangle against the image
+        if (srcX < 0)
+        {
+            dstX -= srcX;
+            width += srcX;
+            srcX = 0;
+        }
+
+        if (srcY < 0)
+        {
+            dstY -= srcY;
+            height += srcY;
+            srcY = 0;
+        }
+
+        width = std::min(width, srcImage->getWidth() - srcX);
+        height = std::min(height, srcImage->getHeight() - srcY);
+
+        // Clip the destination rectangle against the clip area
+        if (dstX < top.x)
+        {
+            srcX += top.x - dstX;
+            width -= top.x - dstX;
+            dstX = top.x;
+        }
+
+        if (dstY < top.y)
+        {
+            srcY += top.y - dstY;
+            height -= top.y - dstY;
+            dstY = top.y;
+        }
+
+        width = std::min(width, top.x + top.width - dstX);
+        height = std::min(height, top.y + top.height - dstY);
+
+        if (width <= 0 || height <= 0)
+        {
+            return;
+        }
+
+        const unsigned int* src = srcImage->getPixels() + srcY * srcImage->getWidth() + srcX;
+        unsigned int* dst = mTarget->getPixels() + dstY * mTarget->getWidth() + dstX;
+
+        for (int y = 0; y < height; ++y)
+        {
+            if (srcImage->isOpaque())
+            {
+                std::memcpy(dst, src, width * sizeof(unsigned int));
+            }
+            else
+            {
+                MemoryBlitSpan(dst, src, width);
+            }
+
+            src += srcImage->getWidth();
+            dst += mTarget->getWidth();
+        }
+    }
+
+    void MemoryGraphics::drawMask(const unsigned char* mask,
+                                  int pitch,
+                                  int dstX,
+                                  int dstY,
+                                  int width,
+                                  int height)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        if (mColor.a == 0)
+        {
+            return;
+        }
+
+        dstX += top.xOffset;
+        dstY += top.yOffset;
+
+        if (dstX < top.x)
+        {
+            mask += top.x - dstX;
+            width -= top.x - dstX;
+            dstX = top.x;
+        }
+
+        if (dstY < top.y)
+        {
+            mask += (top.y - dstY) * pitch;
+            height -= top.y - dstY;
+            dstY = top.y;
+        }
+
+        width = std::min(width, top.x + top.width - dstX);
+        height = std::min(height, top.y + top.height - dstY);
+
+        if (width <= 0 || height <= 0)
+        {
+            return;
+        }
+
+        unsigned int* dst = mTarget->getPixels() + dstY * mTarget->getWidth() + dstX;
+
+        for (int y = 0; y < height; ++y)
+        {
+            MemoryMaskSpan(dst, mask, width, mPixel, mColor.a);
+
+            mask += pitch;
+            dst += mTarget->getWidth();
+        }
+    }
+
+    void MemoryGraphics::drawPoint(int x, int y)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        plot(x + top.xOffset, y + top.yOffset);
+    }
+
+    void MemoryGraphics::drawLine(int x1, int y1, int x2, int y2)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        rasterLine(static_cast<long long>(x1) + top.xOffset,
+                   static_cast<long long>(y1) + top.yOffset,
+                   static_cast<long long>(x2) + top.xOffset,
+                   static_cast<long long>(y2) + top.yOffset);
+    }
+
+    void MemoryGraphics::drawLine(int x1, int y1, int x2, int y2, unsigned int width)
+    {
+        if (width < 2)
+        {
+            drawLine(x1, y1, x2, y2);
+            return;
+        }
+
+        const ClipRectangle& top = getTopClipArea();
+
+        // Work with pixel centers
+        float fx1 = x1 + top.xOffset + 0.5f;
+        float fy1 = y1 + top.yOffset + 0.5f;
+        float fx2 = x2 + top.xOffset + 0.5f;
+        float fy2 = y2 + top.yOffset + 0.5f;
+
+        float dx = fx2 - fx1;
+        float dy = fy2 - fy1;
+        float length = Mathf::Sqrt(dx * dx + dy * dy);
+
+        // Direction, a point is drawn along the x axis
+        float ux = 1.0f;
+        float uy = 0.0f;
+
+        if (length > 0.0f)
+        {
+            ux = dx / length;
+            uy = dy / length;
+        }
+
+        // Extend both ends by half a pixel so the end pixels are covered
+        float hw = width / 2.0f;
+        float ex = ux * 0.5f;
+        float ey = uy * 0.5f;
+        float nx = -uy * hw;
+        float ny = ux * hw;
+
+        mPolygonX.clear();
+        mPolygonY.clear();
+        mPolygonX.push_back(fx1 - ex + nx);
+        mPolygonY.push_back(fy1 - ey + ny);
+        mPolygonX.push_back(fx2 + ex + nx);
+        mPolygonY.push_back(fy2 + ey + ny);
+        mPolygonX.push_back(fx2 + ex - nx);
+        mPolygonY.push_back(fy2 + ey - ny);
+        mPolygonX.push_back(fx1 - ex - nx);
+        mPolygonY.push_back(fy1 - ey - ny);
+
+        fillPolygon(mPolygonX, mPolygonY);
+    }
+
+    void MemoryGraphics::drawPolyLine(const PointVector& points, unsigned int width)
+    {
+        getTopClipArea();
+
+        if (points.size() < 2)
+        {
+            return;
+        }
+
+        PointVector::const_iterator it = points.begin();
+        Point previous = *it;
+        ++it;
+
+        for (; it != points.end(); ++it)
+        {
+            drawLine(previous.x, previous.y, (*it).x, (*it).y, width);
+            previous = *it;
+        }
+    }
+
+    void MemoryGraphics::drawBezier(const PointVector& points, int steps, unsigned int width)
+    {
+        getTopClipArea();
+
+        if (points.size() < 2 || steps < 1)
+        {
+            return;
+        }
+
+        const GeometryCache::Geometry& geometry = mGeometryCache.getBezier(points, steps);
+
+        mCurve.resize(geometry.points.size());
+
+        for (unsigned int i = 0; i < geometry.points.size(); ++i)
+        {
+            mCurve[i] = points[0] + geometry.points[i];
+        }
+
+        drawPolyLine(mCurve, width);
+    }
+
+    void MemoryGraphics::drawRectangle(const Rectangle& rectangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        if (rectangle.width <= 0 || rectangle.height <= 0)
+        {
+            return;
+        }
+
+        int x1 = rectangle.x + top.xOffset;
+        int y1 = rectangle.y + top.yOffset;
+        int x2 = x1 + rectangle.width - 1;
+        int y2 = y1 + rectangle.height - 1;
+
+        drawSpan(x1, x2, y1);
+
+        if (y2 != y1)
+        {
+            drawSpan(x1, x2, y2);
+        }
+
+        // Leave out the corners so they are not blended twice
+        for (int y = y1 + 1; y < y2; ++y)
+        {
+            plot(x1, y);
+
+            if (x2 != x1)
+            {
+                plot(x2, y);
+            }
+        }
+    }
+
+    void MemoryGraphics::fillRectangle(const Rectangle& rectangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        Rectangle area = rectangle;
+        area.x += top.xOffset;
+        area.y += top.yOffset;
+
+        area = area.intersection(top);
+
+        if (area.isEmpty())
+        {
+            return;
+        }
+
+        unsigned int* p = mTarget->getPixels() + area.y * mTarget->getWidth() + area.x;
+
+        for (int y = 0; y < area.height; ++y)
+        {
+            if (mAlpha)
+            {
+                MemoryBlendSpan(p, area.width, mPixel, mColor.a);
+            }
+            else
+            {
+                MemoryFillSpan(p, area.width, mPixel);
+            }
+
+            p += mTarget->getWidth();
+        }
+    }
+
+    void MemoryGraphics::drawCircle(const Point& p, unsigned int radius)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const PointVector& pixels = mGeometryCache.getCircle(radius).points;
+
+        for (unsigned int i = 0; i < pixels.size(); ++i)
+        {
+            plot(cx + pixels[i].x, cy + pixels[i].y);
+        }
+    }
+
+    void MemoryGraphics::drawFillCircle(const Point& p, unsigned int radius)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const GeometryCache::SpanVector& spans = mGeometryCache.getFillCircle(radius).spans;
+
+        for (unsigned int i = 0; i < spans.size(); ++i)
+        {
+            drawSpan(cx + spans[i].x1, cx + spans[i].x2, cy + spans[i].y);
+        }
+    }
+
+    void MemoryGraphics::drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int sweep = eangle - sangle;
+
+        if (sweep <= 0)
+        {
+            return;
+        }
+
+        if (sweep >= 360)
+        {
+            drawCircle(p, radius);
+            return;
+        }
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const GeometryCache::Geometry& geometry = mGeometryCache.getCircleSegment(radius, sangle, eangle);
+        const PointVector& pixels = geometry.points;
+
+        for (unsigned int i = 0; i < pixels.size(); ++i)
+        {
+            plot(cx + pixels[i].x, cy + pixels[i].y);
+        }
+
+        // The two radii closing the segment
+        rasterLine(cx, cy, cx + geometry.start.x, cy + geometry.start.y);
+        rasterLine(cx, cy, cx + geometry.end.x, cy + geometry.end.y);
+    }
+
+    void MemoryGraphics::drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int sweep = eangle - sangle;
+
+        if (sweep <= 0)
+        {
+            return;
+        }
+
+        if (sweep >= 360)
+        {
+            drawFillCircle(p, radius);
+            return;
+        }
+
+        float cx = p.x + top.xOffset + 0.5f;
+        float cy = p.y + top.yOffset + 0.5f;
+
+        const std::vector<float>& polygon = mGeometryCache.getFillCircleSegment(radius, sangle, eangle).polygon;
+
+        mPolygonX.resize(polygon.size() / 2);
+        mPolygonY.resize(polygon.size() / 2);
+
+        for (unsigned int i = 0; i < mPolygonX.size(); ++i)
+        {
+            mPolygonX[i] = cx + polygon[2 * i];
+            mPolygonY[i] = cy + polygon[2 * i + 1];
+        }
+
+        fillPolygon(mPolygonX, mPolygonY);
+    }
+
+    void MemoryGraphics::setColor(const Color& color)
+    {
+        mColor = color;
+        mPixel = MemoryMapRGBA(color);
+        mAlpha = color.a != 255;
+    }
+
+    const Color& MemoryGraphics::getColor() const
+    {
+        return mColor;
+    }
+
+    Image* MemoryGraphics::createTarget(int width, int height)
+    {
+        return new MemoryImage(width, height);
+    }
+
+    void MemoryGraphics::pushTarget(Image* image)
+    {
+        MemoryImage* target = dynamic_cast<MemoryImage*>(image);
+
+        if (target == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw to an image of unknown format, must be a MemoryImage.");
+        }
+
+        if (target->getPixels() == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw to a freed image.");
+        }
+
+        mTargetStack.push_back(std::make_pair(mTarget, std::stack<ClipRectangle>()));
+        mTargetStack.back().second.swap(mClipStack);
+        mTarget = target;
+
+        pushClipArea(Rectangle(0, 0, target->getWidth(), target->getHeight()));
+    }
+
+    void MemoryGraphics::popTarget()
+    {
+        if (mTargetStack.empty())
+        {
+            throw FCN_EXCEPTION("Tried to pop a target without pushing one.");
+        }
+
+        mTarget = mTargetStack.back().first;
+        mClipStack.swap(mTargetStack.back().second);
+        mTargetStack.pop_back();
+    }
+
+    void MemoryGraphics::copyArea(const Rectangle& area, int dx, int dy)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        Rectangle source = area;
+        source.x += top.xOffset;
+        source.y += top.yOffset;
+        source = source.intersection(top);
+
+        Rectangle destination = source;
+        destination.x += dx;
+        destination.y += dy;
+        destination = destination.intersection(top);
+
+        if (destination.isEmpty())
+        {
+            return;
+        }
+
+        int pitch = mTarget->getWidth();
+        unsigned int* dst = mTarget->getPixels() + destination.y * pitch + destination.x;
+        const unsigned int* src = dst - dy * pitch - dx;
+
+        // Copy the rows in the direction that does not overwrite rows
+        // still to be copied.
+        if (dy > 0)
+        {
+            dst += (destination.height - 1) * pitch;
+            src += (destination.height - 1) * pitch;
+            pitch = -pitch;
+        }
+
+        for (int y = 0; y < destination.height; ++y)
+        {
+            std::memmove(dst, src, destination.width * sizeof(unsigned int));
+            dst += pitch;
+            src += pitch;
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/memory/memoryimage.hpp"
+
+#include <cstring>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/memory/memorypixel.hpp"
+
+namespace fcn
+{
+    MemoryImage::MemoryImage(int width, int height)
+    {
+        if (width < 0 || height < 0)
+        {
+            throw FCN_EXCEPTION("Image dimensions must not be negative.");
+        }
+
+        mWidth = width;
+        mHeight = height;
+        mPixels = new unsigned int[mWidth * mHeight];
+        std::memset(mPixels, 0, sizeof(unsigned int) * mWidth * mHeight);
+        mOpaque = false;
+    }
+
+    MemoryImage::MemoryImage(const unsigned int* pixels,
+                             int width,
+                             int height,
+                             bool convertToDisplayFormat)
+    {
+        if (width < 0 || height < 0)
+        {
+            throw FCN_EXCEPTION("Image dimensions must not be negative.");
+        }
+
+        mWidth = width;
+        mHeight = height;
+        mPixels = new unsigned int[mWidth * mHeight];
+        mOpaque = false;
+
+        const unsigned int magicPink = MemoryMapRGBA(Color(255, 0, 255));
+
+        for (int i = 0; i < mWidth * mHeight; ++i)
+        {
+            // Magic pink to transparent
+            mPixels[i] = pixels[i] == magicPink ? 0x00000000 : pixels[i];
+        }
+
+        if (convertToDisplayFormat)
+        {
+            MemoryImage::convertToDisplayFormat();
+        }
+    }
+
+    MemoryImage::~MemoryImage()
+    {
+        free();
+    }
+
+    unsigned int* MemoryImage::getPixels()
+    {
+        return mPixels;
+    }
+
+    const unsigned int* MemoryImage::getPixels() const
+    {
+        return mPixels;
+    }
+
+    bool MemoryImage::isOpaque() const
+    {
+        return mOpaque;
+    }
+
+    void MemoryImage::free()
+    {
+        delete[] mPixels;
+        mPixels = NULL;
+    }
+
+    int MemoryImage::getWidth() const
+    {
+        return mWidth;
+    }
+
+    int MemoryImage::getHeight() const
+    {
+        return mHeight;
+    }
+
+    Color MemoryImage::getPixel(int x, int y)
+    {
+        if (mPixels == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to get a pixel from a freed image.");
+        }
+
+        if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+        {
+            throw FCN_EXCEPTION("Coordinates outside of the image");
+        }
+
+        return MemoryGetRGBA(mPixels[x + y * mWidth]);
+    }
+
+    void MemoryImage::readPixels(std::vector<Color>& pixels)
+    {
+        if (mPixels == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to get pixels from a freed image.");
+        }
+
+        pixels.resize(mWidth * mHeight);
+
+        for (int i = 0; i < mWidth * mHeight; ++i)
+        {
+            pixels[i] = MemoryGetRGBA(mPixels[i]);
+        }
+    }
+
+    void MemoryImage::putPixel(int x, int y, const Color& color)
+    {
+        if (mPixels == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to put a pixel in a freed image.");
+        }
+
+        if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+        {
+            throw FCN_EXCEPTION("Coordinates outside of the image");
+        }
+
+        if (color.a != 255)
+        {
+            mOpaque = false;
+        }
+
+        mPixels[x + y * mWidth] = MemoryMapRGBA(color);
+    }
+
+    void MemoryImage::convertToDisplayFormat()
+    {
+        if (mPixels == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to convert a freed image to display format.");
+        }
+
+        mOpaque = true;
+
+        for (int i = 0; i < mWidth * mHeight; ++i)
+        {
+            if ((mPixels[i] & MemoryAlphaMask) != MemoryAlphaMask)
+            {
+                mOpaque = false;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/memory/memorytiledgraphics.hpp"
+
+#include "fifechan/exception.hpp"
+#include "fifechan/memory/memorygraphics.hpp"
+#include "fifechan/memory/memoryimage.hpp"
+
+namespace fcn
+{
+    MemoryTiledGraphics::MemoryTiledGraphics()
+    {
+        mTarget = NULL;
+    }
+
+    MemoryTiledGraphics::MemoryTiledGraphics(MemoryImage* target)
+    {
+        mTarget = target;
+    }
+
+    MemoryTiledGraphics::~MemoryTiledGraphics()
+    {
+    }
+
+    void MemoryTiledGraphics::setTarget(MemoryImage* target)
+    {
+        if (target != mTarget)
+        {
+            clearTileGraphics();
+        }
+
+        mTarget = target;
+    }
+
+    MemoryImage* MemoryTiledGraphics::getTarget() const
+    {
+        return mTarget;
+    }
+
+    void MemoryTiledGraphics::_beginDraw()
+    {
+        if (mTarget == NULL)
+        {
+            throw FCN_EXCEPTION("No target to draw to, perhaps you forgot to call setTarget()?");
+        }
+
+        TiledGraphics::_beginDraw();
+    }
+
+    Graphics* MemoryTiledGraphics::createTileGraphics()
+    {
+        return new MemoryGraphics(mTarget);
+    }
+
+    int MemoryTiledGraphics::getTargetWidth() const
+    {
+        return mTarget->getWidth();
+    }
+
+    int MemoryTiledGraphics::getTargetHeight() const
+    {
+        return mTarget->getHeight();
+    }
+}
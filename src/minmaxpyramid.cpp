@@ -0,0 +1,208 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/minmaxpyramid.hpp"
+
+namespace fcn
+{
+    MinMaxPyramid::MinMaxPyramid()
+        : mIndexed(0),
+          mMonotonic(true)
+    {
+
+    }
+
+    void MinMaxPyramid::update(const PointVector& points)
+    {
+        if (points.size() < mIndexed)
+        {
+            clear();
+        }
+
+        for (unsigned int i = mIndexed; i < points.size(); ++i)
+        {
+            if (i > 0 && points[i].x < points[i - 1].x)
+            {
+                mMonotonic = false;
+            }
+
+            insert(points, i);
+        }
+
+        mIndexed = points.size();
+    }
+
+    void MinMaxPyramid::clear()
+    {
+        mLevels.clear();
+        mIndexed = 0;
+        mMonotonic = true;
+    }
+
+    bool MinMaxPyramid::isMonotonic() const
+    {
+        return mMonotonic;
+    }
+
+    bool MinMaxPyramid::decimate(const PointVector& points, PointVector& result) const
+    {
+        if (!mMonotonic || points.size() < 2 || points.size() != mIndexed)
+        {
+            return false;
+        }
+
+        unsigned int columns = points.back().x - points.front().x + 1;
+        unsigned int perColumn = points.size() / columns;
+
+        if (perColumn < 4)
+        {
+            return false;
+        }
+
+        // Use the largest buckets that still fit into a column on average.
+        unsigned int level = 0;
+        while ((2u << level) <= perColumn && level < mLevels.size())
+        {
+            ++level;
+        }
+
+        const std::vector<Node>& nodes = mLevels[level - 1];
+
+        result.clear();
+        result.push_back(points.front());
+
+        unsigned int min = nodes[0].min;
+        unsigned int max = nodes[0].max;
+        int column = points.front().x;
+
+        for (unsigned int i = 1; i <= nodes.size(); ++i)
+        {
+            if (i < nodes.size() && points[i << level].x == column)
+            {
+                if (points[nodes[i].min].y < points[min].y)
+                {
+                    min = nodes[i].min;
+                }
+
+                if (points[nodes[i].max].y > points[max].y)
+                {
+                    max = nodes[i].max;
+                }
+
+                continue;
+            }
+
+            // Add the extremes of the column in the order they appear.
+            unsigned int first = min < max ? min : max;
+            unsigned int second = min < max ? max : min;
+
+            if (first != 0)
+            {
+                result.push_back(points[first]);
+            }
+
+            if (second != first)
+            {
+                result.push_back(points[second]);
+            }
+
+            if (i < nodes.size())
+            {
+                min = nodes[i].min;
+                max = nodes[i].max;
+                column = points[i << level].x;
+            }
+        }
+
+        if (result.back() != points.back())
+        {
+            result.push_back(points.back());
+        }
+
+        return true;
+    }
+
+    void MinMaxPyramid::insert(const PointVector& points, unsigned int index)
+    {
+        for (unsigned int level = 1; ; ++level)
+        {
+            unsigned int below = level == 1 ? index + 1 : mLevels[level - 2].size();
+
+            if (below < 2)
+            {
+                return;
+            }
+
+            if (mLevels.size() < level)
+            {
+                // The level below just got its second bucket, which holds
+                // the new point, so the new level covers every point.
+                Node node;
+
+                if (level == 1)
+                {
+                    node.min = points[1].y < points[0].y ? 1 : 0;
+                    node.max = points[1].y > points[0].y ? 1 : 0;
+                }
+                else
+                {
+                    const Node& left = mLevels[level - 2][0];
+                    const Node& right = mLevels[level - 2][1];
+                    node.min = points[right.min].y < points[left.min].y ? right.min : left.min;
+                    node.max = points[right.max].y > points[left.max].y ? right.max : left.max;
+                }
+
+                mLevels.push_back(std::vector<Node>(1, node));
+                continue;
+            }
+
+            std::vector<Node>& nodes = mLevels[level - 1];
+            unsigned int bucket = index >> level;
+
+            if (bucket == nodes.size())
+            {
+                Node node;
+                node.min = index;
+                node.max = index;
+                nodes.push_back(node);
+            }
+            else
+            {
+                Node& node = nodes[bucket];
+
+                if (points[index].y < points[node.min].y)
+                {
+                    node.min = index;
+                }
+
+                if (points[index].y > points[node.max].y)
+                {
+                    node.max = index;
+                }
+            }
+        }
+    }
+}
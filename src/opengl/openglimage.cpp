@@ -225,6 +225,27 @@ namespace fcn
         return Color(r, g, b, a);
     }
 
+    void OpenGLImage::readPixels(std::vector<Color>& pixels)
+    {
+        if (mPixels == NULL)
+        {
+            throw FCN_EXCEPTION("Image has been converted to display format");
+        }
+
+        pixels.resize(mWidth * mHeight);
+
+        for (int y = 0; y < mHeight; ++y)
+        {
+            const unsigned char* p = (const unsigned char*)(mPixels + y * mTextureWidth);
+
+            // The pixels are RGBA bytes in memory
+            for (int x = 0; x < mWidth; ++x, p += 4)
+            {
+                pixels[x + y * mWidth] = Color(p[0], p[1], p[2], p[3]);
+            }
+        }
+    }
+
     void OpenGLImage::putPixel(int x, int y, const Color& color)
     {
         if (mPixels == NULL)
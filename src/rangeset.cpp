@@ -0,0 +1,275 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/rangeset.hpp"
+
+namespace fcn
+{
+    bool RangeSet::contains(int value) const
+    {
+        std::map<int, int>::const_iterator iter = mRanges.upper_bound(value);
+
+        if (iter == mRanges.begin())
+        {
+            return false;
+        }
+
+        --iter;
+        return value < iter->second;
+    }
+
+    bool RangeSet::intersects(int first, int count) const
+    {
+        if (count <= 0)
+        {
+            return false;
+        }
+
+        // The last range starting inside the given one, or before it.
+        std::map<int, int>::const_iterator iter = mRanges.lower_bound(first + count);
+
+        if (iter == mRanges.begin())
+        {
+            return false;
+        }
+
+        --iter;
+        return iter->second > first;
+    }
+
+    void RangeSet::add(int first, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        int last = first + count;
+        std::map<int, int>::iterator iter = mRanges.upper_bound(first);
+
+        // Merge with a range overlapping or touching the new one from the
+        // left.
+        if (iter != mRanges.begin())
+        {
+            std::map<int, int>::iterator previous = iter;
+            --previous;
+
+            if (previous->second >= first)
+            {
+                first = previous->first;
+                if (previous->second > last)
+                {
+                    last = previous->second;
+                }
+
+                mRanges.erase(previous);
+            }
+        }
+
+        // Merge with the ranges overlapping or touching it from the right.
+        while (iter != mRanges.end() && iter->first <= last)
+        {
+            if (iter->second > last)
+            {
+                last = iter->second;
+            }
+
+            mRanges.erase(iter++);
+        }
+
+        mRanges[first] = last;
+    }
+
+    void RangeSet::remove(int first, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        int last = first + count;
+        std::map<int, int>::iterator iter = mRanges.upper_bound(first);
+
+        // Cut a range starting before the removed one.
+        if (iter != mRanges.begin())
+        {
+            std::map<int, int>::iterator previous = iter;
+            --previous;
+
+            if (previous->second > first)
+            {
+                int end = previous->second;
+
+                if (previous->first == first)
+                {
+                    mRanges.erase(previous);
+                }
+                else
+                {
+                    previous->second = first;
+                }
+
+                if (end > last)
+                {
+                    mRanges[last] = end;
+                    return;
+                }
+            }
+        }
+
+        while (iter != mRanges.end() && iter->first < last)
+        {
+            if (iter->second > last)
+            {
+                mRanges[last] = iter->second;
+            }
+
+            mRanges.erase(iter++);
+        }
+    }
+
+    void RangeSet::toggle(int value)
+    {
+        if (contains(value))
+        {
+            remove(value, 1);
+        }
+        else
+        {
+            add(value, 1);
+        }
+    }
+
+    void RangeSet::clear()
+    {
+        mRanges.clear();
+    }
+
+    bool RangeSet::isEmpty() const
+    {
+        return mRanges.empty();
+    }
+
+    int RangeSet::getSize() const
+    {
+        int size = 0;
+
+        for (const_iterator iter = mRanges.begin(); iter != mRanges.end(); ++iter)
+        {
+            size += iter->second - iter->first;
+        }
+
+        return size;
+    }
+
+    int RangeSet::getNumberOfRanges() const
+    {
+        return mRanges.size();
+    }
+
+    void RangeSet::insertGap(int first, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        // Split a range containing the position, the inserted integers are
+        // not in the set.
+        std::map<int, int>::iterator iter = mRanges.upper_bound(first);
+
+        if (iter != mRanges.begin())
+        {
+            std::map<int, int>::iterator previous = iter;
+            --previous;
+
+            if (previous->first < first && previous->second > first)
+            {
+                int end = previous->second;
+                previous->second = first;
+                mRanges[first] = end;
+            }
+        }
+
+        shift(first, count);
+    }
+
+    void RangeSet::removeGap(int first, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        remove(first, count);
+        shift(first + count, -count);
+
+        // Ranges on both sides of the gap may touch now.
+        std::map<int, int>::iterator iter = mRanges.find(first);
+
+        if (iter != mRanges.end() && iter != mRanges.begin())
+        {
+            std::map<int, int>::iterator previous = iter;
+            --previous;
+
+            if (previous->second == first)
+            {
+                previous->second = iter->second;
+                mRanges.erase(iter);
+            }
+        }
+    }
+
+    RangeSet::const_iterator RangeSet::begin() const
+    {
+        return mRanges.begin();
+    }
+
+    RangeSet::const_iterator RangeSet::end() const
+    {
+        return mRanges.end();
+    }
+
+    void RangeSet::shift(int from, int offset)
+    {
+        std::map<int, int>::iterator iter = mRanges.lower_bound(from);
+
+        if (iter == mRanges.end())
+        {
+            return;
+        }
+
+        std::map<int, int> shifted;
+
+        for (std::map<int, int>::iterator moved = iter; moved != mRanges.end(); ++moved)
+        {
+            shifted.insert(shifted.end(), std::make_pair(moved->first + offset, moved->second + offset));
+        }
+
+        mRanges.erase(iter, mRanges.end());
+        mRanges.insert(shifted.begin(), shifted.end());
+    }
+}
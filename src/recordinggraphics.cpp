@@ -0,0 +1,695 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/recordinggraphics.hpp"
+
+#include <fstream>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/rectangle.hpp"
+
+namespace fcn
+{
+    namespace
+    {
+        // Number of arguments of the commands with a fixed size, -1 for
+        // the commands followed by a point list.
+        const int CommandSizes[] =
+        {
+            0,  // BeginDraw
+            0,  // EndDraw
+            4,  // PushClipArea
+            0,  // PopClipArea
+            7,  // DrawImage
+            2,  // DrawPoint
+            4,  // DrawLine
+            5,  // DrawThickLine
+            -1, // DrawPolyLine
+            -1, // DrawBezier
+            4,  // DrawRectangle
+            4,  // FillRectangle
+            3,  // DrawCircle
+            3,  // DrawFillCircle
+            5,  // DrawCircleSegment
+            5,  // DrawFillCircleSegment
+            1   // SetColor
+        };
+
+        // Header of the binary format, followed by the version, the number
+        // of commands, the size of the command buffer and the number of
+        // images, and then the command buffer. All values are 32 bit
+        // little endian.
+        const char DumpMagic[4] = { 'F', 'C', 'N', 'R' };
+        const unsigned int DumpVersion = 1;
+
+        // Limits of the values in a replayed command buffer. Larger values
+        // don't come up in a user interface but would keep the graphics
+        // drawing for a very long time, so they are treated as corrupt.
+        const int MaximumCoordinate = 1 << 24;
+        const int MaximumRadius = 1 << 16;
+        const int MaximumAngle = 1 << 16;
+        const int MaximumLineWidth = 1 << 10;
+        const long long MaximumBezierSteps = 1 << 20;
+
+        void checkRange(int value, int low, int high)
+        {
+            if (value < low || value > high)
+            {
+                throw FCN_EXCEPTION("Corrupt command buffer, value out of range.");
+            }
+        }
+
+        void checkCoordinates(const int* values, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                checkRange(values[i], -MaximumCoordinate, MaximumCoordinate);
+            }
+        }
+
+        void writeValue(std::ostream& out, unsigned int value)
+        {
+            char bytes[4];
+            bytes[0] = value & 0xff;
+            bytes[1] = (value >> 8) & 0xff;
+            bytes[2] = (value >> 16) & 0xff;
+            bytes[3] = (value >> 24) & 0xff;
+            out.write(bytes, 4);
+        }
+
+        unsigned int readValue(std::istream& in)
+        {
+            unsigned char bytes[4] = { 0, 0, 0, 0 };
+            in.read(reinterpret_cast<char*>(bytes), 4);
+
+            return bytes[0]
+                | (bytes[1] << 8)
+                | (bytes[2] << 16)
+                | (static_cast<unsigned int>(bytes[3]) << 24);
+        }
+    }
+
+    RecordingGraphics::RecordingGraphics()
+    {
+        mTarget = NULL;
+        mWidth = 0;
+        mHeight = 0;
+        mCommandCount = 0;
+    }
+
+    RecordingGraphics::RecordingGraphics(Graphics* target)
+    {
+        mTarget = target;
+        mWidth = 0;
+        mHeight = 0;
+        mCommandCount = 0;
+    }
+
+    RecordingGraphics::~RecordingGraphics()
+    {
+    }
+
+    void RecordingGraphics::setTarget(Graphics* target)
+    {
+        mTarget = target;
+    }
+
+    Graphics* RecordingGraphics::getTarget() const
+    {
+        return mTarget;
+    }
+
+    void RecordingGraphics::setSize(int width, int height)
+    {
+        mWidth = width;
+        mHeight = height;
+    }
+
+    void RecordingGraphics::clear()
+    {
+        mCommands.clear();
+        mImages.clear();
+        mCommandCount = 0;
+    }
+
+    unsigned int RecordingGraphics::getCommandCount() const
+    {
+        return mCommandCount;
+    }
+
+    unsigned int RecordingGraphics::getSize() const
+    {
+        return mCommands.size() * sizeof(int);
+    }
+
+    bool RecordingGraphics::isEqual(const RecordingGraphics& other) const
+    {
+        return mCommands == other.mCommands && mImages == other.mImages;
+    }
+
+    int* RecordingGraphics::append(CommandType type, int size)
+    {
+        unsigned int offset = mCommands.size();
+        mCommands.resize(offset + 1 + size);
+        mCommands[offset] = type;
+        ++mCommandCount;
+
+        return size > 0 ? &mCommands[offset + 1] : NULL;
+    }
+
+    void RecordingGraphics::appendPoints(CommandType type, const PointVector& points, int first, int second)
+    {
+        int* args = append(type, 3 + 2 * points.size());
+        args[0] = first;
+        args[1] = second;
+        args[2] = points.size();
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            args[3 + 2 * i] = points[i].x;
+            args[4 + 2 * i] = points[i].y;
+        }
+    }
+
+    void RecordingGraphics::replay(Graphics* graphics) const
+    {
+        PointVector points;
+        unsigned int size = mCommands.size();
+        unsigned int i = 0;
+
+        while (i < size)
+        {
+            int type = mCommands[i++];
+
+            if (type < 0 || type >= CommandTypeCount)
+            {
+                throw FCN_EXCEPTION("Corrupt command buffer, unknown command.");
+            }
+
+            int count = CommandSizes[type];
+
+            if (count < 0)
+            {
+                if (size - i < 3
+                    || mCommands[i + 2] < 0
+                    || (size - i - 3) / 2 < static_cast<unsigned int>(mCommands[i + 2]))
+                {
+                    throw FCN_EXCEPTION("Corrupt command buffer, truncated point list.");
+                }
+
+                count = 3 + 2 * mCommands[i + 2];
+            }
+            else if (size - i < static_cast<unsigned int>(count))
+            {
+                throw FCN_EXCEPTION("Corrupt command buffer, truncated command.");
+            }
+
+            const int* a = &mCommands[0] + i;
+            i += count;
+
+            switch (type)
+            {
+              case BeginDraw:
+                  graphics->_beginDraw();
+                  break;
+              case EndDraw:
+                  graphics->_endDraw();
+                  break;
+              case PushClipArea:
+                  checkCoordinates(a, 4);
+                  graphics->pushClipArea(Rectangle(a[0], a[1], a[2], a[3]));
+                  break;
+              case PopClipArea:
+                  graphics->popClipArea();
+                  break;
+              case DrawImage:
+                  if (a[0] < 0 || a[0] >= static_cast<int>(mImages.size()))
+                  {
+                      throw FCN_EXCEPTION("Corrupt command buffer, unknown image.");
+                  }
+
+                  checkCoordinates(a + 1, 6);
+
+                  // Images of loaded recordings are unknown
+                  if (mImages[a[0]] != NULL)
+                  {
+                      graphics->drawImage(mImages[a[0]], a[1], a[2], a[3], a[4], a[5], a[6]);
+                  }
+                  break;
+              case DrawPoint:
+                  checkCoordinates(a, 2);
+                  graphics->drawPoint(a[0], a[1]);
+                  break;
+              case DrawLine:
+                  checkCoordinates(a, 4);
+                  graphics->drawLine(a[0], a[1], a[2], a[3]);
+                  break;
+              case DrawThickLine:
+                  checkCoordinates(a, 4);
+                  checkRange(a[4], 0, MaximumLineWidth);
+                  graphics->drawLine(a[0], a[1], a[2], a[3], a[4]);
+                  break;
+              case DrawPolyLine:
+              case DrawBezier:
+                  checkCoordinates(a + 3, 2 * a[2]);
+
+                  if (type == DrawPolyLine)
+                  {
+                      checkRange(a[0], 0, MaximumLineWidth);
+                  }
+                  else
+                  {
+                      checkRange(a[1], 0, MaximumLineWidth);
+
+                      // The steps are taken between every two points.
+                      if (a[0] < 0 || static_cast<long long>(a[0]) * a[2] > MaximumBezierSteps)
+                      {
+                          throw FCN_EXCEPTION("Corrupt command buffer, value out of range.");
+                      }
+                  }
+
+                  points.clear();
+                  for (int k = 0; k < a[2]; ++k)
+                  {
+                      points.push_back(Point(a[3 + 2 * k], a[4 + 2 * k]));
+                  }
+
+                  if (type == DrawPolyLine)
+                  {
+                      graphics->drawPolyLine(points, a[0]);
+                  }
+                  else
+                  {
+                      graphics->drawBezier(points, a[0], a[1]);
+                  }
+                  break;
+              case DrawRectangle:
+                  checkCoordinates(a, 4);
+                  graphics->drawRectangle(Rectangle(a[0], a[1], a[2], a[3]));
+                  break;
+              case FillRectangle:
+                  checkCoordinates(a, 4);
+                  graphics->fillRectangle(Rectangle(a[0], a[1], a[2], a[3]));
+                  break;
+              case DrawCircle:
+                  checkCoordinates(a, 2);
+                  checkRange(a[2], 0, MaximumRadius);
+                  graphics->drawCircle(Point(a[0], a[1]), a[2]);
+                  break;
+              case DrawFillCircle:
+                  checkCoordinates(a, 2);
+                  checkRange(a[2], 0, MaximumRadius);
+                  graphics->drawFillCircle(Point(a[0], a[1]), a[2]);
+                  break;
+              case DrawCircleSegment:
+                  checkCoordinates(a, 2);
+                  checkRange(a[2], 0, MaximumRadius);
+                  checkRange(a[3], -MaximumAngle, MaximumAngle);
+                  checkRange(a[4], -MaximumAngle, MaximumAngle);
+                  graphics->drawCircleSegment(Point(a[0], a[1]), a[2], a[3], a[4]);
+                  break;
+              case DrawFillCircleSegment:
+                  checkCoordinates(a, 2);
+                  checkRange(a[2], 0, MaximumRadius);
+                  checkRange(a[3], -MaximumAngle, MaximumAngle);
+                  checkRange(a[4], -MaximumAngle, MaximumAngle);
+                  graphics->drawFillCircleSegment(Point(a[0], a[1]), a[2], a[3], a[4]);
+                  break;
+              case SetColor:
+              {
+                  unsigned int c = a[0];
+                  graphics->setColor(Color(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24));
+                  break;
+              }
+            }
+        }
+    }
+
+    void RecordingGraphics::save(const std::string& filename) const
+    {
+        std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+
+        if (!out)
+        {
+            throw FCN_EXCEPTION(std::string("Unable to open file for writing: ") + filename);
+        }
+
+        out.write(DumpMagic, 4);
+        writeValue(out, DumpVersion);
+        writeValue(out, mCommandCount);
+        writeValue(out, mCommands.size());
+        writeValue(out, mImages.size());
+
+        for (unsigned int i = 0; i < mCommands.size(); ++i)
+        {
+            writeValue(out, mCommands[i]);
+        }
+
+        if (!out)
+        {
+            throw FCN_EXCEPTION(std::string("Unable to write file: ") + filename);
+        }
+    }
+
+    void RecordingGraphics::load(const std::string& filename)
+    {
+        std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+
+        if (!in)
+        {
+            throw FCN_EXCEPTION(std::string("Unable to open file for reading: ") + filename);
+        }
+
+        char magic[4] = { 0, 0, 0, 0 };
+        in.read(magic, 4);
+
+        if (!in
+            || magic[0] != DumpMagic[0]
+            || magic[1] != DumpMagic[1]
+            || magic[2] != DumpMagic[2]
+            || magic[3] != DumpMagic[3])
+        {
+            throw FCN_EXCEPTION(std::string("Not a recording: ") + filename);
+        }
+
+        if (readValue(in) != DumpVersion)
+        {
+            throw FCN_EXCEPTION(std::string("Unsupported recording version: ") + filename);
+        }
+
+        unsigned int commandCount = readValue(in);
+        unsigned int size = readValue(in);
+        unsigned int images = readValue(in);
+
+        if (!in)
+        {
+            throw FCN_EXCEPTION(std::string("Truncated recording: ") + filename);
+        }
+
+        // Check the counts before allocating anything for them. Every
+        // value takes four bytes of the file, every command at least one
+        // value and every image a DrawImage command of eight values.
+        std::streamoff position = in.tellg();
+        in.seekg(0, std::ios::end);
+        std::streamoff remaining = in.tellg() - position;
+        in.seekg(position);
+
+        if (!in || size > remaining / 4)
+        {
+            throw FCN_EXCEPTION(std::string("Truncated recording: ") + filename);
+        }
+
+        if (commandCount > size || images > size / 8)
+        {
+            throw FCN_EXCEPTION(std::string("Corrupt recording: ") + filename);
+        }
+
+        clear();
+        mCommands.reserve(size);
+
+        for (unsigned int i = 0; i < size && in; ++i)
+        {
+            mCommands.push_back(static_cast<int>(readValue(in)));
+        }
+
+        if (!in)
+        {
+            clear();
+            throw FCN_EXCEPTION(std::string("Truncated recording: ") + filename);
+        }
+
+        mImages.assign(images, static_cast<const Image*>(NULL));
+        mCommandCount = commandCount;
+    }
+
+    void RecordingGraphics::_beginDraw()
+    {
+        if (mTarget != NULL)
+        {
+            mTarget->_beginDraw();
+
+            const ClipRectangle& area = mTarget->getCurrentClipArea();
+            Graphics::pushClipArea(Rectangle(area.x, area.y, area.width, area.height));
+        }
+        else
+        {
+            Graphics::pushClipArea(Rectangle(0, 0, mWidth, mHeight));
+        }
+
+        append(BeginDraw, 0);
+    }
+
+    void RecordingGraphics::_endDraw()
+    {
+        append(EndDraw, 0);
+
+        Graphics::popClipArea();
+
+        if (mTarget != NULL)
+        {
+            mTarget->_endDraw();
+        }
+    }
+
+    bool RecordingGraphics::pushClipArea(Rectangle area)
+    {
+        int* args = append(PushClipArea, 4);
+        args[0] = area.x;
+        args[1] = area.y;
+        args[2] = area.width;
+        args[3] = area.height;
+
+        if (mTarget != NULL)
+        {
+            mTarget->pushClipArea(area);
+        }
+
+        return Graphics::pushClipArea(area);
+    }
+
+    void RecordingGraphics::popClipArea()
+    {
+        Graphics::popClipArea();
+
+        append(PopClipArea, 0);
+
+        if (mTarget != NULL)
+        {
+            mTarget->popClipArea();
+        }
+    }
+
+    void RecordingGraphics::drawImage(const Image* image,
+                                      int srcX,
+                                      int srcY,
+                                      int dstX,
+                                      int dstY,
+                                      int width,
+                                      int height)
+    {
+        int* args = append(DrawImage, 7);
+        args[0] = mImages.size();
+        args[1] = srcX;
+        args[2] = srcY;
+        args[3] = dstX;
+        args[4] = dstY;
+        args[5] = width;
+        args[6] = height;
+        mImages.push_back(image);
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawImage(image, srcX, srcY, dstX, dstY, width, height);
+        }
+    }
+
+    void RecordingGraphics::drawPoint(int x, int y)
+    {
+        int* args = append(DrawPoint, 2);
+        args[0] = x;
+        args[1] = y;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawPoint(x, y);
+        }
+    }
+
+    void RecordingGraphics::drawLine(int x1, int y1, int x2, int y2)
+    {
+        int* args = append(DrawLine, 4);
+        args[0] = x1;
+        args[1] = y1;
+        args[2] = x2;
+        args[3] = y2;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawLine(x1, y1, x2, y2);
+        }
+    }
+
+    void RecordingGraphics::drawLine(int x1, int y1, int x2, int y2, unsigned int width)
+    {
+        int* args = append(DrawThickLine, 5);
+        args[0] = x1;
+        args[1] = y1;
+        args[2] = x2;
+        args[3] = y2;
+        args[4] = width;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawLine(x1, y1, x2, y2, width);
+        }
+    }
+
+    void RecordingGraphics::drawPolyLine(const PointVector& points, unsigned int width)
+    {
+        appendPoints(DrawPolyLine, points, width, 0);
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawPolyLine(points, width);
+        }
+    }
+
+    void RecordingGraphics::drawBezier(const PointVector& points, int steps, unsigned int width)
+    {
+        appendPoints(DrawBezier, points, steps, width);
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawBezier(points, steps, width);
+        }
+    }
+
+    void RecordingGraphics::drawRectangle(const Rectangle& rectangle)
+    {
+        int* args = append(DrawRectangle, 4);
+        args[0] = rectangle.x;
+        args[1] = rectangle.y;
+        args[2] = rectangle.width;
+        args[3] = rectangle.height;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawRectangle(rectangle);
+        }
+    }
+
+    void RecordingGraphics::fillRectangle(const Rectangle& rectangle)
+    {
+        int* args = append(FillRectangle, 4);
+        args[0] = rectangle.x;
+        args[1] = rectangle.y;
+        args[2] = rectangle.width;
+        args[3] = rectangle.height;
+
+        if (mTarget != NULL)
+        {
+            mTarget->fillRectangle(rectangle);
+        }
+    }
+
+    void RecordingGraphics::drawCircle(const Point& p, unsigned int radius)
+    {
+        int* args = append(DrawCircle, 3);
+        args[0] = p.x;
+        args[1] = p.y;
+        args[2] = radius;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawCircle(p, radius);
+        }
+    }
+
+    void RecordingGraphics::drawFillCircle(const Point& p, unsigned int radius)
+    {
+        int* args = append(DrawFillCircle, 3);
+        args[0] = p.x;
+        args[1] = p.y;
+        args[2] = radius;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawFillCircle(p, radius);
+        }
+    }
+
+    void RecordingGraphics::drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        int* args = append(DrawCircleSegment, 5);
+        args[0] = p.x;
+        args[1] = p.y;
+        args[2] = radius;
+        args[3] = sangle;
+        args[4] = eangle;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawCircleSegment(p, radius, sangle, eangle);
+        }
+    }
+
+    void RecordingGraphics::drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        int* args = append(DrawFillCircleSegment, 5);
+        args[0] = p.x;
+        args[1] = p.y;
+        args[2] = radius;
+        args[3] = sangle;
+        args[4] = eangle;
+
+        if (mTarget != NULL)
+        {
+            mTarget->drawFillCircleSegment(p, radius, sangle, eangle);
+        }
+    }
+
+    void RecordingGraphics::setColor(const Color& color)
+    {
+        mColor = color;
+
+        int* args = append(SetColor, 1);
+        args[0] = static_cast<int>((color.r & 0xff)
+                                   | ((color.g & 0xff) << 8)
+                                   | ((color.b & 0xff) << 16)
+                                   | (static_cast<unsigned int>(color.a & 0xff) << 24));
+
+        if (mTarget != NULL)
+        {
+            mTarget->setColor(color);
+        }
+    }
+
+    const Color& RecordingGraphics::getColor() const
+    {
+        return mColor;
+    }
+}
@@ -0,0 +1,264 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/ringbufferdatasource.hpp"
+
+#include "fifechan/exception.hpp"
+
+namespace fcn
+{
+    const unsigned int RingBufferDataSource::None = ~0u;
+
+    RingBufferDataSource::RingBufferDataSource(int capacity)
+        : mFirst(0),
+          mSize(0),
+          mLeaves(1)
+    {
+        if (capacity <= 0)
+        {
+            throw FCN_EXCEPTION("Capacity must be positive.");
+        }
+
+        mPoints.resize(capacity);
+
+        while (mLeaves < mPoints.size())
+        {
+            mLeaves *= 2;
+        }
+
+        mMinTree.resize(2 * mLeaves, None);
+        mMaxTree.resize(2 * mLeaves, None);
+    }
+
+    RingBufferDataSource::~RingBufferDataSource()
+    {
+
+    }
+
+    void RingBufferDataSource::addPoint(const Point& point)
+    {
+        if (mSize > 0 && point.x < getPoint(mSize - 1).x)
+        {
+            throw FCN_EXCEPTION("Points must not go back in x.");
+        }
+
+        if (store(point))
+        {
+            distributePointsRemoved(1);
+        }
+
+        distributePointsAppended(1);
+    }
+
+    void RingBufferDataSource::addPoints(const PointVector& points)
+    {
+        int last = mSize > 0 ? getPoint(mSize - 1).x : 0;
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            if ((mSize > 0 || i > 0) && points[i].x < last)
+            {
+                throw FCN_EXCEPTION("Points must not go back in x.");
+            }
+
+            last = points[i].x;
+        }
+
+        int removed = 0;
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            if (store(points[i]))
+            {
+                ++removed;
+            }
+        }
+
+        if (removed > 0)
+        {
+            distributePointsRemoved(removed);
+        }
+
+        if (!points.empty())
+        {
+            distributePointsAppended(points.size());
+        }
+    }
+
+    void RingBufferDataSource::clear()
+    {
+        int removed = mSize;
+
+        mFirst = 0;
+        mSize = 0;
+        mMinTree.assign(mMinTree.size(), None);
+        mMaxTree.assign(mMaxTree.size(), None);
+
+        if (removed > 0)
+        {
+            distributePointsRemoved(removed);
+        }
+    }
+
+    int RingBufferDataSource::getCapacity() const
+    {
+        return mPoints.size();
+    }
+
+    int RingBufferDataSource::getNumberOfPoints() const
+    {
+        return mSize;
+    }
+
+    Point RingBufferDataSource::getPoint(int index) const
+    {
+        unsigned int slot = mFirst + index;
+
+        if (slot >= mPoints.size())
+        {
+            slot -= mPoints.size();
+        }
+
+        return mPoints[slot];
+    }
+
+    void RingBufferDataSource::getExtremes(int first, int count, int& min, int& max) const
+    {
+        unsigned int slot = mFirst + first;
+
+        if (slot >= mPoints.size())
+        {
+            slot -= mPoints.size();
+        }
+
+        unsigned int minSlot = None;
+        unsigned int maxSlot = None;
+
+        // Points after the end of the buffer continue at its start.
+        if (slot + count <= mPoints.size())
+        {
+            query(slot, slot + count, minSlot, maxSlot);
+        }
+        else
+        {
+            query(slot, mPoints.size(), minSlot, maxSlot);
+            query(0, slot + count - mPoints.size(), minSlot, maxSlot);
+        }
+
+        min = minSlot >= mFirst ? minSlot - mFirst : minSlot + mPoints.size() - mFirst;
+        max = maxSlot >= mFirst ? maxSlot - mFirst : maxSlot + mPoints.size() - mFirst;
+    }
+
+    bool RingBufferDataSource::store(const Point& point)
+    {
+        unsigned int slot;
+        bool removed = mSize == mPoints.size();
+
+        if (removed)
+        {
+            slot = mFirst;
+            mFirst = mFirst + 1 == mPoints.size() ? 0 : mFirst + 1;
+        }
+        else
+        {
+            slot = mFirst + mSize;
+
+            if (slot >= mPoints.size())
+            {
+                slot -= mPoints.size();
+            }
+
+            ++mSize;
+        }
+
+        mPoints[slot] = point;
+
+        unsigned int node = mLeaves + slot;
+        mMinTree[node] = slot;
+        mMaxTree[node] = slot;
+
+        for (node /= 2; node > 0; node /= 2)
+        {
+            mMinTree[node] = lower(mMinTree[2 * node], mMinTree[2 * node + 1]);
+            mMaxTree[node] = higher(mMaxTree[2 * node], mMaxTree[2 * node + 1]);
+        }
+
+        return removed;
+    }
+
+    unsigned int RingBufferDataSource::lower(unsigned int a, unsigned int b) const
+    {
+        if (a == None)
+        {
+            return b;
+        }
+
+        if (b == None)
+        {
+            return a;
+        }
+
+        return mPoints[b].y < mPoints[a].y ? b : a;
+    }
+
+    unsigned int RingBufferDataSource::higher(unsigned int a, unsigned int b) const
+    {
+        if (a == None)
+        {
+            return b;
+        }
+
+        if (b == None)
+        {
+            return a;
+        }
+
+        return mPoints[b].y > mPoints[a].y ? b : a;
+    }
+
+    void RingBufferDataSource::query(unsigned int first,
+                                     unsigned int last,
+                                     unsigned int& min,
+                                     unsigned int& max) const
+    {
+        for (first += mLeaves, last += mLeaves; first < last; first /= 2, last /= 2)
+        {
+            if (first & 1)
+            {
+                min = lower(min, mMinTree[first]);
+                max = higher(max, mMaxTree[first]);
+                ++first;
+            }
+
+            if (last & 1)
+            {
+                --last;
+                min = lower(min, mMinTree[last]);
+                max = higher(max, mMaxTree[last]);
+            }
+        }
+    }
+}
@@ -206,15 +206,12 @@ namespace fcn
             int y1 = area.y > top.y ? area.y : top.y;
             int x2 = area.x + area.width < top.x + top.width ? area.x + area.width : top.x + top.width;
             int y2 = area.y + area.height < top.y + top.height ? area.y + area.height : top.y + top.height;
-            int x, y;
+            int y;
 
             SDL_LockSurface(mTarget);
             for (y = y1; y < y2; y++)
             {
-                for (x = x1; x < x2; x++)
-                {
-                    SDLputPixelAlpha(mTarget, x, y, mColor);
-                }
+                SDLputSpanAlpha(mTarget, x1, y, x2 - x1, mColor);
             }
             SDL_UnlockSurface(mTarget);
 
@@ -306,6 +303,12 @@ namespace fcn
             x2 = top.x + top.width -1;
         }
 
+        if (mAlpha)
+        {
+            SDLputSpanAlpha(mTarget, x1, y, x2 - x1 + 1, mColor);
+            return;
+        }
+
         int bpp = mTarget->format->BytesPerPixel;
 
         SDL_LockSurface(mTarget);
@@ -362,15 +365,7 @@ namespace fcn
                 Uint32* q = (Uint32*)p;
                 for (;x1 <= x2; ++x1)
                 {
-                    if (mAlpha)
-                    {
-                        *q = SDLAlpha32(pixel,*q,mColor.a);
-                        q++;
-                    }
-                    else
-                    {
-                        *(q++) = pixel;
-                    }
+                    *(q++) = pixel;
                 }
                 break;
             }
@@ -446,7 +441,14 @@ namespace fcn
           case 2:
               for (;y1 <= y2; ++y1)
               {
-                  *(Uint16*)p = pixel;
+                  if (mAlpha)
+                  {
+                      *(Uint16*)p = SDLAlpha16(pixel,*(Uint16*)p,mColor.a,mTarget->format);
+                  }
+                  else
+                  {
+                      *(Uint16*)p = pixel;
+                  }
                   p += mTarget->pitch;
               }
               break;
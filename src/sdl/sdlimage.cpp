@@ -123,6 +123,16 @@ namespace fcn
 		return SDLgetPixel(mSurface, x, y);
 	}
 
+	void SDLImage::readPixels(std::vector<Color>& pixels)
+	{
+		if (mSurface == NULL)
+		{
+			throw FCN_EXCEPTION("Trying to get pixels from a non loaded image.");
+		}
+
+		SDLgetPixels(mSurface, pixels);
+	}
+
 	void SDLImage::putPixel(int x, int y, const Color& color)
 	{
 		if (mSurface == NULL)
@@ -0,0 +1,619 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/sdl/sdlrenderergraphics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/image.hpp"
+#include "fifechan/rectangle.hpp"
+#include "fifechan/sdl/sdltextureimage.hpp"
+#include "fifechan/util/fcn_math.hpp"
+
+namespace fcn
+{
+    SDLRendererGraphics::SDLRendererGraphics()
+    {
+        mRenderer = NULL;
+        mBlendMode = SDL_BLENDMODE_BLEND;
+    }
+
+    SDLRendererGraphics::SDLRendererGraphics(SDL_Renderer* renderer)
+    {
+        mRenderer = renderer;
+        mBlendMode = SDL_BLENDMODE_BLEND;
+    }
+
+    SDLRendererGraphics::~SDLRendererGraphics()
+    {
+    }
+
+    void SDLRendererGraphics::setRenderer(SDL_Renderer* renderer)
+    {
+        mRenderer = renderer;
+    }
+
+    SDL_Renderer* SDLRendererGraphics::getRenderer() const
+    {
+        return mRenderer;
+    }
+
+    void SDLRendererGraphics::setBlendMode(SDL_BlendMode mode)
+    {
+        if (mode == mBlendMode)
+        {
+            return;
+        }
+
+        flush();
+        mBlendMode = mode;
+
+        if (!mClipStack.empty())
+        {
+            SDL_SetRenderDrawBlendMode(mRenderer, mBlendMode);
+        }
+    }
+
+    SDL_BlendMode SDLRendererGraphics::getBlendMode() const
+    {
+        return mBlendMode;
+    }
+
+    void SDLRendererGraphics::_beginDraw()
+    {
+        if (mRenderer == NULL)
+        {
+            throw FCN_EXCEPTION("No renderer to draw with, perhaps you forgot to call setRenderer()?");
+        }
+
+        int width = 0;
+        int height = 0;
+        SDL_Texture* target = SDL_GetRenderTarget(mRenderer);
+
+        if (target != NULL)
+        {
+            SDL_QueryTexture(target, NULL, NULL, &width, &height);
+        }
+        else
+        {
+            SDL_GetRendererOutputSize(mRenderer, &width, &height);
+        }
+
+        // The application might have changed the renderer state since the
+        // last frame.
+        SDL_SetRenderDrawColor(mRenderer, mColor.r, mColor.g, mColor.b, mColor.a);
+        SDL_SetRenderDrawBlendMode(mRenderer, mBlendMode);
+
+        Rectangle area;
+        area.x = 0;
+        area.y = 0;
+        area.width = width;
+        area.height = height;
+        pushClipArea(area);
+    }
+
+    void SDLRendererGraphics::_endDraw()
+    {
+        popClipArea();
+        SDL_RenderSetClipRect(mRenderer, NULL);
+    }
+
+    bool SDLRendererGraphics::pushClipArea(Rectangle area)
+    {
+        flush();
+
+        bool result = Graphics::pushClipArea(area);
+        updateClipRect();
+
+        return result;
+    }
+
+    void SDLRendererGraphics::popClipArea()
+    {
+        flush();
+
+        Graphics::popClipArea();
+
+        if (mClipStack.empty())
+        {
+            return;
+        }
+
+        updateClipRect();
+    }
+
+    const ClipRectangle& SDLRendererGraphics::getTopClipArea() const
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        return mClipStack.top();
+    }
+
+    void SDLRendererGraphics::updateClipRect()
+    {
+        const ClipRectangle& carea = mClipStack.top();
+
+        SDL_Rect rect;
+        rect.x = carea.x;
+        rect.y = carea.y;
+        rect.w = carea.width;
+        rect.h = carea.height;
+
+        SDL_RenderSetClipRect(mRenderer, &rect);
+    }
+
+    void SDLRendererGraphics::flush()
+    {
+        if (mRects.empty())
+        {
+            return;
+        }
+
+        SDL_RenderFillRects(mRenderer, &mRects[0], mRects.size());
+        mRects.clear();
+    }
+
+    void SDLRendererGraphics::batchRect(int x, int y, int width, int height)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        int x1 = std::max(x, top.x);
+        int y1 = std::max(y, top.y);
+        int x2 = std::min(x + width, top.x + top.width);
+        int y2 = std::min(y + height, top.y + top.height);
+
+        if (x1 >= x2 || y1 >= y2)
+        {
+            return;
+        }
+
+        SDL_Rect rect;
+        rect.x = x1;
+        rect.y = y1;
+        rect.w = x2 - x1;
+        rect.h = y2 - y1;
+        mRects.push_back(rect);
+    }
+
+    void SDLRendererGraphics::batchSpan(int x1, int x2, int y)
+    {
+        batchRect(x1, y, x2 - x1 + 1, 1);
+    }
+
+    void SDLRendererGraphics::fillPolygon(const std::vector<float>& xs, const std::vector<float>& ys)
+    {
+        const ClipRectangle& top = mClipStack.top();
+
+        if (xs.size() < 3 || xs.size() != ys.size())
+        {
+            return;
+        }
+
+        float ymin = *std::min_element(ys.begin(), ys.end());
+        float ymax = *std::max_element(ys.begin(), ys.end());
+
+        // Rows whose pixel centers lie within [ymin, ymax)
+        int row1 = std::max(static_cast<int>(std::ceil(ymin - 0.5f)), top.y);
+        int row2 = std::min(static_cast<int>(std::ceil(ymax - 0.5f)) - 1, top.y + top.height - 1);
+
+        unsigned int n = xs.size();
+
+        for (int row = row1; row <= row2; ++row)
+        {
+            float yc = row + 0.5f;
+
+            mCrossings.clear();
+            for (unsigned int i = 0, j = n - 1; i < n; j = i++)
+            {
+                if ((ys[i] > yc) != (ys[j] > yc))
+                {
+                    mCrossings.push_back(xs[i] + (yc - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i]));
+                }
+            }
+
+            std::sort(mCrossings.begin(), mCrossings.end());
+
+            for (unsigned int i = 0; i + 1 < mCrossings.size(); i += 2)
+            {
+                int x1 = static_cast<int>(std::ceil(mCrossings[i] - 0.5f));
+                int x2 = static_cast<int>(std::ceil(mCrossings[i + 1] - 0.5f)) - 1;
+                batchSpan(x1, x2, row);
+            }
+        }
+    }
+
+    void SDLRendererGraphics::drawImage(const Image* image,
+                                        int srcX,
+                                        int srcY,
+                                        int dstX,
+                                        int dstY,
+                                        int width,
+                                        int height)
+    {
+        getTopClipArea();
+
+        const SDLTextureImage* srcImage = dynamic_cast<const SDLTextureImage*>(image);
+
+        if (srcImage == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw an image of unknown format, must be an SDLTextureImage.");
+        }
+
+        if (srcImage->getTexture() == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to draw an image which has not been converted to display format.");
+        }
+
+        SDL_Rect source;
+        source.x = srcX;
+        source.y = srcY;
+        source.w = width;
+        source.h = height;
+
+        SDL_Rect destination;
+        destination.x = dstX;
+        destination.y = dstY;
+        destination.w = width;
+        destination.h = height;
+
+        drawSDLTexture(srcImage->getTexture(), source, destination);
+    }
+
+    void SDLRendererGraphics::drawSDLTexture(SDL_Texture* texture,
+                                             SDL_Rect source,
+                                             SDL_Rect destination)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        if (top.isEmpty())
+        {
+            return;
+        }
+
+        destination.x += top.xOffset;
+        destination.y += top.yOffset;
+
+        flush();
+        SDL_RenderCopy(mRenderer, texture, &source, &destination);
+    }
+
+    void SDLRendererGraphics::drawPoint(int x, int y)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        batchRect(x + top.xOffset, y + top.yOffset, 1, 1);
+    }
+
+    void SDLRendererGraphics::drawLine(int x1, int y1, int x2, int y2)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        x1 += top.xOffset;
+        y1 += top.yOffset;
+        x2 += top.xOffset;
+        y2 += top.yOffset;
+
+        // Axis aligned lines join the batch
+        if (x1 == x2)
+        {
+            batchRect(x1, std::min(y1, y2), 1, std::abs(y2 - y1) + 1);
+            return;
+        }
+
+        if (y1 == y2)
+        {
+            batchRect(std::min(x1, x2), y1, std::abs(x2 - x1) + 1, 1);
+            return;
+        }
+
+        if (top.isEmpty())
+        {
+            return;
+        }
+
+        flush();
+        SDL_RenderDrawLine(mRenderer, x1, y1, x2, y2);
+    }
+
+    void SDLRendererGraphics::drawLine(int x1, int y1, int x2, int y2, unsigned int width)
+    {
+        if (width < 2)
+        {
+            drawLine(x1, y1, x2, y2);
+            return;
+        }
+
+        const ClipRectangle& top = getTopClipArea();
+
+        // Work with pixel centers
+        float fx1 = x1 + top.xOffset + 0.5f;
+        float fy1 = y1 + top.yOffset + 0.5f;
+        float fx2 = x2 + top.xOffset + 0.5f;
+        float fy2 = y2 + top.yOffset + 0.5f;
+
+        float dx = fx2 - fx1;
+        float dy = fy2 - fy1;
+        float length = Mathf::Sqrt(dx * dx + dy * dy);
+
+        // Direction, a point is drawn along the x axis
+        float ux = 1.0f;
+        float uy = 0.0f;
+
+        if (length > 0.0f)
+        {
+            ux = dx / length;
+            uy = dy / length;
+        }
+
+        // Extend both ends by half a pixel so the end pixels are covered
+        float hw = width / 2.0f;
+        float ex = ux * 0.5f;
+        float ey = uy * 0.5f;
+        float nx = -uy * hw;
+        float ny = ux * hw;
+
+        mPolygonX.clear();
+        mPolygonY.clear();
+        mPolygonX.push_back(fx1 - ex + nx);
+        mPolygonY.push_back(fy1 - ey + ny);
+        mPolygonX.push_back(fx2 + ex + nx);
+        mPolygonY.push_back(fy2 + ey + ny);
+        mPolygonX.push_back(fx2 + ex - nx);
+        mPolygonY.push_back(fy2 + ey - ny);
+        mPolygonX.push_back(fx1 - ex - nx);
+        mPolygonY.push_back(fy1 - ey - ny);
+
+        fillPolygon(mPolygonX, mPolygonY);
+    }
+
+    void SDLRendererGraphics::drawPolyLine(const PointVector& points, unsigned int width)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        if (points.size() < 2)
+        {
+            return;
+        }
+
+        if (width < 2)
+        {
+            if (top.isEmpty())
+            {
+                return;
+            }
+
+            mLinePoints.resize(points.size());
+
+            for (unsigned int i = 0; i < points.size(); ++i)
+            {
+                mLinePoints[i].x = points[i].x + top.xOffset;
+                mLinePoints[i].y = points[i].y + top.yOffset;
+            }
+
+            flush();
+            SDL_RenderDrawLines(mRenderer, &mLinePoints[0], mLinePoints.size());
+            return;
+        }
+
+        PointVector::const_iterator it = points.begin();
+        Point previous = *it;
+        ++it;
+
+        for (; it != points.end(); ++it)
+        {
+            drawLine(previous.x, previous.y, (*it).x, (*it).y, width);
+            previous = *it;
+        }
+    }
+
+    void SDLRendererGraphics::drawBezier(const PointVector& points, int steps, unsigned int width)
+    {
+        getTopClipArea();
+
+        if (points.size() < 2 || steps < 1)
+        {
+            return;
+        }
+
+        const GeometryCache::Geometry& geometry = mGeometryCache.getBezier(points, steps);
+
+        mCurve.resize(geometry.points.size());
+
+        for (unsigned int i = 0; i < geometry.points.size(); ++i)
+        {
+            mCurve[i] = points[0] + geometry.points[i];
+        }
+
+        drawPolyLine(mCurve, width);
+    }
+
+    void SDLRendererGraphics::drawRectangle(const Rectangle& rectangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        if (rectangle.width <= 0 || rectangle.height <= 0)
+        {
+            return;
+        }
+
+        int x1 = rectangle.x + top.xOffset;
+        int y1 = rectangle.y + top.yOffset;
+        int x2 = x1 + rectangle.width - 1;
+        int y2 = y1 + rectangle.height - 1;
+
+        batchSpan(x1, x2, y1);
+
+        if (y2 != y1)
+        {
+            batchSpan(x1, x2, y2);
+        }
+
+        // Leave out the corners so they are not blended twice
+        if (y2 - y1 > 1)
+        {
+            batchRect(x1, y1 + 1, 1, y2 - y1 - 1);
+
+            if (x2 != x1)
+            {
+                batchRect(x2, y1 + 1, 1, y2 - y1 - 1);
+            }
+        }
+    }
+
+    void SDLRendererGraphics::fillRectangle(const Rectangle& rectangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        batchRect(rectangle.x + top.xOffset,
+                  rectangle.y + top.yOffset,
+                  rectangle.width,
+                  rectangle.height);
+    }
+
+    void SDLRendererGraphics::drawCircle(const Point& p, unsigned int radius)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const PointVector& pixels = mGeometryCache.getCircle(radius).points;
+
+        for (unsigned int i = 0; i < pixels.size(); ++i)
+        {
+            batchRect(cx + pixels[i].x, cy + pixels[i].y, 1, 1);
+        }
+    }
+
+    void SDLRendererGraphics::drawFillCircle(const Point& p, unsigned int radius)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const GeometryCache::SpanVector& spans = mGeometryCache.getFillCircle(radius).spans;
+
+        for (unsigned int i = 0; i < spans.size(); ++i)
+        {
+            batchSpan(cx + spans[i].x1, cx + spans[i].x2, cy + spans[i].y);
+        }
+    }
+
+    void SDLRendererGraphics::drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int sweep = eangle - sangle;
+
+        if (sweep <= 0)
+        {
+            return;
+        }
+
+        if (sweep >= 360)
+        {
+            drawCircle(p, radius);
+            return;
+        }
+
+        int cx = p.x + top.xOffset;
+        int cy = p.y + top.yOffset;
+
+        const GeometryCache::Geometry& geometry = mGeometryCache.getCircleSegment(radius, sangle, eangle);
+        const PointVector& pixels = geometry.points;
+
+        for (unsigned int i = 0; i < pixels.size(); ++i)
+        {
+            batchRect(cx + pixels[i].x, cy + pixels[i].y, 1, 1);
+        }
+
+        // The two radii closing the segment
+        drawLine(p.x, p.y, p.x + geometry.start.x, p.y + geometry.start.y);
+        drawLine(p.x, p.y, p.x + geometry.end.x, p.y + geometry.end.y);
+    }
+
+    void SDLRendererGraphics::drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        const ClipRectangle& top = getTopClipArea();
+
+        int sweep = eangle - sangle;
+
+        if (sweep <= 0)
+        {
+            return;
+        }
+
+        if (sweep >= 360)
+        {
+            drawFillCircle(p, radius);
+            return;
+        }
+
+        float cx = p.x + top.xOffset + 0.5f;
+        float cy = p.y + top.yOffset + 0.5f;
+
+        const std::vector<float>& polygon = mGeometryCache.getFillCircleSegment(radius, sangle, eangle).polygon;
+
+        mPolygonX.resize(polygon.size() / 2);
+        mPolygonY.resize(polygon.size() / 2);
+
+        for (unsigned int i = 0; i < mPolygonX.size(); ++i)
+        {
+            mPolygonX[i] = cx + polygon[2 * i];
+            mPolygonY[i] = cy + polygon[2 * i + 1];
+        }
+
+        fillPolygon(mPolygonX, mPolygonY);
+    }
+
+    void SDLRendererGraphics::setColor(const Color& color)
+    {
+        if (color == mColor)
+        {
+            return;
+        }
+
+        flush();
+        mColor = color;
+
+        if (!mClipStack.empty())
+        {
+            SDL_SetRenderDrawColor(mRenderer, mColor.r, mColor.g, mColor.b, mColor.a);
+        }
+    }
+
+    const Color& SDLRendererGraphics::getColor() const
+    {
+        return mColor;
+    }
+}
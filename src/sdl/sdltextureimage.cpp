@@ -0,0 +1,184 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/sdl/sdltextureimage.hpp"
+
+#include "fifechan/exception.hpp"
+#include "fifechan/sdl/sdlpixel.hpp"
+
+namespace fcn
+{
+    SDLTextureImage::SDLTextureImage(SDL_Renderer* renderer, SDL_Surface* surface, bool autoFree)
+    {
+        mRenderer = renderer;
+        mSurface = surface;
+        mTexture = NULL;
+        mBlendMode = SDL_BLENDMODE_BLEND;
+        mWidth = surface != NULL ? surface->w : 0;
+        mHeight = surface != NULL ? surface->h : 0;
+        mAutoFree = autoFree;
+    }
+
+    SDLTextureImage::SDLTextureImage(SDL_Texture* texture, bool autoFree)
+    {
+        mRenderer = NULL;
+        mSurface = NULL;
+        mTexture = texture;
+        mBlendMode = SDL_BLENDMODE_BLEND;
+        mWidth = 0;
+        mHeight = 0;
+        mAutoFree = autoFree;
+
+        if (mTexture != NULL)
+        {
+            SDL_QueryTexture(mTexture, NULL, NULL, &mWidth, &mHeight);
+            SDL_GetTextureBlendMode(mTexture, &mBlendMode);
+        }
+    }
+
+    SDLTextureImage::~SDLTextureImage()
+    {
+        if (mAutoFree)
+        {
+            free();
+        }
+    }
+
+    SDL_Texture* SDLTextureImage::getTexture() const
+    {
+        return mTexture;
+    }
+
+    SDL_Surface* SDLTextureImage::getSurface() const
+    {
+        return mSurface;
+    }
+
+    void SDLTextureImage::setBlendMode(SDL_BlendMode mode)
+    {
+        mBlendMode = mode;
+
+        if (mTexture != NULL)
+        {
+            SDL_SetTextureBlendMode(mTexture, mBlendMode);
+        }
+    }
+
+    SDL_BlendMode SDLTextureImage::getBlendMode() const
+    {
+        return mBlendMode;
+    }
+
+    int SDLTextureImage::getWidth() const
+    {
+        if (mSurface == NULL && mTexture == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to get the width of a non loaded image.");
+        }
+
+        return mWidth;
+    }
+
+    int SDLTextureImage::getHeight() const
+    {
+        if (mSurface == NULL && mTexture == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to get the height of a non loaded image.");
+        }
+
+        return mHeight;
+    }
+
+    Color SDLTextureImage::getPixel(int x, int y)
+    {
+        if (mSurface == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to get a pixel from a non loaded image.");
+        }
+
+        return SDLgetPixel(mSurface, x, y);
+    }
+
+    void SDLTextureImage::putPixel(int x, int y, const Color& color)
+    {
+        if (mSurface == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to put a pixel in a non loaded image.");
+        }
+
+        SDLputPixel(mSurface, x, y, color);
+    }
+
+    void SDLTextureImage::convertToDisplayFormat()
+    {
+        if (mSurface == NULL)
+        {
+            if (mTexture != NULL)
+            {
+                // Already in display format
+                return;
+            }
+
+            throw FCN_EXCEPTION("Trying to convert a non loaded image to display format.");
+        }
+
+        if (mRenderer == NULL)
+        {
+            throw FCN_EXCEPTION("Trying to convert an image without a renderer to display format.");
+        }
+
+        // Magic pink to transparent
+        SDL_SetColorKey(mSurface, SDL_TRUE, SDL_MapRGB(mSurface->format, 255, 0, 255));
+
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, mSurface);
+
+        if (texture == NULL)
+        {
+            throw FCN_EXCEPTION(std::string("Unable to convert image to display format: ") + SDL_GetError());
+        }
+
+        SDL_SetTextureBlendMode(texture, mBlendMode);
+
+        SDL_FreeSurface(mSurface);
+        mSurface = NULL;
+        mTexture = texture;
+    }
+
+    void SDLTextureImage::free()
+    {
+        if (mSurface != NULL)
+        {
+            SDL_FreeSurface(mSurface);
+            mSurface = NULL;
+        }
+
+        if (mTexture != NULL)
+        {
+            SDL_DestroyTexture(mTexture);
+            mTexture = NULL;
+        }
+    }
+}
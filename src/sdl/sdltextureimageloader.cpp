@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/sdl/sdltextureimageloader.hpp"
+
+#include "fifechan/exception.hpp"
+#include "fifechan/sdl/sdltextureimage.hpp"
+
+namespace fcn
+{
+    SDLTextureImageLoader::SDLTextureImageLoader(SDL_Renderer* renderer)
+    {
+        mRenderer = renderer;
+    }
+
+    void SDLTextureImageLoader::setRenderer(SDL_Renderer* renderer)
+    {
+        mRenderer = renderer;
+    }
+
+    SDL_Renderer* SDLTextureImageLoader::getRenderer() const
+    {
+        return mRenderer;
+    }
+
+    Image* SDLTextureImageLoader::load(const std::string& filename,
+                                       bool convertToDisplayFormat)
+    {
+        SDL_Surface *loadedSurface = loadSDLSurface(filename);
+
+        if (loadedSurface == NULL)
+        {
+            throw FCN_EXCEPTION(
+                    std::string("Unable to load image file: ") + filename);
+        }
+
+        SDL_Surface *surface = convertToStandardFormat(loadedSurface);
+        SDL_FreeSurface(loadedSurface);
+
+        if (surface == NULL)
+        {
+            throw FCN_EXCEPTION(
+                    std::string("Not enough memory to load: ") + filename);
+        }
+
+        Image *image = new SDLTextureImage(mRenderer, surface, true);
+
+        if (convertToDisplayFormat)
+        {
+            image->convertToDisplayFormat();
+        }
+
+        return image;
+    }
+}
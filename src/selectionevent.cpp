@@ -71,7 +71,17 @@
 namespace fcn
 {
     SelectionEvent::SelectionEvent(Widget* source)
-            :Event(source)
+            :Event(source),
+             mFirstChanged(-1),
+             mNumberOfChanged(0)
+    {
+
+    }
+
+    SelectionEvent::SelectionEvent(Widget* source, int first, int count)
+            :Event(source),
+             mFirstChanged(first),
+             mNumberOfChanged(count)
     {
 
     }
@@ -80,5 +90,15 @@ namespace fcn
     {
 
     }
+
+    int SelectionEvent::getFirstChanged() const
+    {
+        return mFirstChanged;
+    }
+
+    int SelectionEvent::getNumberOfChanged() const
+    {
+        return mNumberOfChanged;
+    }
 }
 
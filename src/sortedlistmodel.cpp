@@ -0,0 +1,529 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/sortedlistmodel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <typeinfo>
+
+namespace fcn
+{
+    namespace
+    {
+        /**
+         * Orders indices by the elements they refer to, as compared by
+         * the lessThan of a model.
+         */
+        class ElementOrder
+        {
+        public:
+            ElementOrder(const SortedListModel* model, const std::vector<std::string>& elements)
+                : mModel(model),
+                  mElements(elements)
+            {
+            }
+
+            bool operator()(int a, int b) const
+            {
+                return mModel->lessThan(mElements[a], mElements[b]);
+            }
+
+        private:
+            const SortedListModel* mModel;
+            const std::vector<std::string>& mElements;
+        };
+
+        /**
+         * Orders indices by the elements they refer to, as compared by
+         * the default lessThan. Doesn't need a model, so it is safe to use
+         * on the worker thread.
+         */
+        class DefaultElementOrder
+        {
+        public:
+            DefaultElementOrder(const std::vector<std::string>& elements)
+                : mElements(elements)
+            {
+            }
+
+            bool operator()(int a, int b) const
+            {
+                return mElements[a] < mElements[b];
+            }
+
+        private:
+            const std::vector<std::string>& mElements;
+        };
+
+        template <class Order>
+        void sortIndices(const std::vector<std::string>& elements,
+                         std::vector<int>& indices,
+                         const Order& order)
+        {
+            indices.resize(elements.size());
+            for (unsigned int i = 0; i < indices.size(); ++i)
+            {
+                indices[i] = i;
+            }
+
+            // Stable, so equal elements keep the order of the source model.
+            std::stable_sort(indices.begin(), indices.end(), order);
+        }
+    }
+
+    class SortedListModel::SortTask
+    {
+    public:
+        SortTask(int revision)
+            : mRevision(revision),
+              mFinished(false)
+        {
+        }
+
+        void start()
+        {
+            mThread = std::thread(&SortTask::run, this);
+        }
+
+        void run()
+        {
+            sortIndices(mElements, mIndices, DefaultElementOrder(mElements));
+            mFinished = true;
+        }
+
+        int mRevision;
+        std::vector<std::string> mElements;
+        std::vector<int> mIndices;
+        std::atomic<bool> mFinished;
+        std::thread mThread;
+    };
+
+    SortedListModel::SortedListModel(ListModel* sourceModel)
+        : mSourceModel(NULL),
+          mMergeTail(0),
+          mAsynchronousThreshold(10000),
+          mRevision(0),
+          mSortTask(NULL)
+    {
+        setSourceModel(sourceModel);
+    }
+
+    SortedListModel::~SortedListModel()
+    {
+        cancelSort();
+
+        if (mSourceModel != NULL)
+        {
+            mSourceModel->removeListModelListener(this);
+        }
+    }
+
+    void SortedListModel::setSourceModel(ListModel* sourceModel)
+    {
+        cancelSort();
+
+        if (mSourceModel != NULL)
+        {
+            mSourceModel->removeListModelListener(this);
+        }
+
+        int removed = mIndices.size();
+        mIndices.clear();
+        ++mRevision;
+
+        if (removed > 0)
+        {
+            distributeElementsRemoved(0, removed);
+        }
+
+        mSourceModel = sourceModel;
+
+        if (mSourceModel == NULL)
+        {
+            return;
+        }
+
+        mSourceModel->addListModelListener(this);
+
+        // Show the elements in source order until they are sorted.
+        int elements = mSourceModel->getNumberOfElements();
+        for (int i = 0; i < elements; ++i)
+        {
+            mIndices.push_back(i);
+        }
+
+        if (elements > 0)
+        {
+            distributeElementsInserted(0, elements);
+        }
+
+        sort();
+    }
+
+    ListModel* SortedListModel::getSourceModel() const
+    {
+        return mSourceModel;
+    }
+
+    void SortedListModel::setAsynchronousThreshold(int threshold)
+    {
+        mAsynchronousThreshold = threshold;
+    }
+
+    int SortedListModel::getAsynchronousThreshold() const
+    {
+        return mAsynchronousThreshold;
+    }
+
+    void SortedListModel::sort()
+    {
+        if (mSourceModel == NULL)
+        {
+            return;
+        }
+
+        // The running sort is outdated, update() starts a new one when it
+        // is finished.
+        if (mSortTask != NULL)
+        {
+            ++mRevision;
+            return;
+        }
+
+        int elements = mSourceModel->getNumberOfElements();
+
+        // The worker thread only compares with the default lessThan, as
+        // calling an overridden one would race with the destruction of
+        // the subclass. Subclasses are always sorted on this thread.
+        if (mAsynchronousThreshold > 0
+            && elements >= mAsynchronousThreshold
+            && typeid(*this) == typeid(SortedListModel))
+        {
+            mSortTask = new SortTask(mRevision);
+            mSortTask->mElements.resize(elements);
+
+            for (int i = 0; i < elements; ++i)
+            {
+                mSortTask->mElements[i] = getSourceElement(i, mSortTask->mElements[i]);
+            }
+
+            mSortTask->start();
+            return;
+        }
+
+        std::vector<std::string> copies(elements);
+        for (int i = 0; i < elements; ++i)
+        {
+            copies[i] = getSourceElement(i, copies[i]);
+        }
+
+        sortIndices(copies, mIndices, ElementOrder(this, copies));
+
+        if (elements > 0)
+        {
+            distributeElementsChanged(0, elements);
+        }
+    }
+
+    bool SortedListModel::isSorting() const
+    {
+        return mSortTask != NULL;
+    }
+
+    bool SortedListModel::update()
+    {
+        if (mSortTask == NULL || !mSortTask->mFinished)
+        {
+            return false;
+        }
+
+        mSortTask->mThread.join();
+
+        bool current = mSortTask->mRevision == mRevision;
+        if (current)
+        {
+            mIndices.swap(mSortTask->mIndices);
+        }
+
+        delete mSortTask;
+        mSortTask = NULL;
+
+        if (!current)
+        {
+            sort();
+            return false;
+        }
+
+        if (!mIndices.empty())
+        {
+            distributeElementsChanged(0, mIndices.size());
+        }
+
+        return true;
+    }
+
+    int SortedListModel::getSourceIndex(int i) const
+    {
+        if ((unsigned int)i < mMergedIndices.size())
+        {
+            return mMergedIndices[i];
+        }
+
+        return mIndices[i - mMergedIndices.size() + mMergeTail];
+    }
+
+    bool SortedListModel::lessThan(const std::string& a, const std::string& b) const
+    {
+        return a < b;
+    }
+
+    int SortedListModel::getNumberOfElements()
+    {
+        return mMergedIndices.size() + mIndices.size() - mMergeTail;
+    }
+
+    std::string SortedListModel::getElementAt(int i)
+    {
+        return mSourceModel->getElementAt(getSourceIndex(i));
+    }
+
+    const std::string* SortedListModel::getElementPointer(int i)
+    {
+        return mSourceModel->getElementPointer(getSourceIndex(i));
+    }
+
+    void SortedListModel::elementsInserted(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        ++mRevision;
+
+        for (unsigned int i = 0; i < mIndices.size(); ++i)
+        {
+            if (mIndices[i] >= first)
+            {
+                mIndices[i] += count;
+            }
+        }
+
+        if (count > MaximumIncrementalChanges || mSortTask != NULL)
+        {
+            int position = mIndices.size();
+
+            for (int i = first; i < first + count; ++i)
+            {
+                mIndices.push_back(i);
+            }
+
+            distributeElementsInserted(position, count);
+            sort();
+        }
+        else
+        {
+            for (int i = first; i < first + count; ++i)
+            {
+                insertSorted(i);
+            }
+        }
+    }
+
+    void SortedListModel::elementsRemoved(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        ++mRevision;
+        removeRange(first, count, true);
+
+        // A running sort is outdated, so start a new one.
+        if (mSortTask != NULL)
+        {
+            sort();
+        }
+    }
+
+    void SortedListModel::elementsChanged(ListModel* model, int first, int count)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        ++mRevision;
+
+        if (count > MaximumIncrementalChanges || mSortTask != NULL)
+        {
+            sort();
+
+            // The changed elements stay where they are until the sort is
+            // published, but their contents are new.
+            if (mSortTask != NULL && !mIndices.empty())
+            {
+                distributeElementsChanged(0, mIndices.size());
+            }
+        }
+        else
+        {
+            removeRange(first, count, false);
+
+            for (int i = first; i < first + count; ++i)
+            {
+                insertSorted(i);
+            }
+        }
+    }
+
+    void SortedListModel::listModelDeleted(ListModel* model)
+    {
+        if (model != mSourceModel)
+        {
+            return;
+        }
+
+        cancelSort();
+        mSourceModel = NULL;
+
+        int removed = mIndices.size();
+        mIndices.clear();
+
+        if (removed > 0)
+        {
+            distributeElementsRemoved(0, removed);
+        }
+    }
+
+    void SortedListModel::insertSorted(int index)
+    {
+        std::string elementCopy;
+        std::string otherCopy;
+        const std::string& element = getSourceElement(index, elementCopy);
+
+        // Find the first element that comes after the new one, equal
+        // elements are ordered by their source indices.
+        int low = 0;
+        int high = mIndices.size();
+
+        while (low < high)
+        {
+            int middle = (low + high) / 2;
+            const std::string& other = getSourceElement(mIndices[middle], otherCopy);
+
+            bool after = lessThan(element, other)
+                || (!lessThan(other, element) && index < mIndices[middle]);
+
+            if (after)
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+
+        mIndices.insert(mIndices.begin() + low, index);
+        distributeElementsInserted(low, 1);
+    }
+
+    void SortedListModel::removeRange(int first, int count, bool shift)
+    {
+        // Mark the removed elements and shift the others first, so the
+        // old indices not looked at yet are valid during every
+        // notification.
+        std::vector<bool> removed(mIndices.size());
+
+        for (unsigned int i = 0; i < mIndices.size(); ++i)
+        {
+            int index = mIndices[i];
+
+            if (index >= first && index < first + count)
+            {
+                removed[i] = true;
+            }
+            else if (shift && index >= first + count)
+            {
+                mIndices[i] = index - count;
+            }
+        }
+
+        mMergedIndices.reserve(mIndices.size());
+        mMergeTail = 0;
+
+        while (mMergeTail < mIndices.size())
+        {
+            if (removed[mMergeTail])
+            {
+                int run = 0;
+                while (mMergeTail < mIndices.size() && removed[mMergeTail])
+                {
+                    ++mMergeTail;
+                    ++run;
+                }
+
+                distributeElementsRemoved(mMergedIndices.size(), run);
+            }
+            else
+            {
+                mMergedIndices.push_back(mIndices[mMergeTail]);
+                ++mMergeTail;
+            }
+        }
+
+        mIndices.swap(mMergedIndices);
+        std::vector<int>().swap(mMergedIndices);
+        mMergeTail = 0;
+    }
+
+    const std::string& SortedListModel::getSourceElement(int index, std::string& element)
+    {
+        const std::string* pointer = mSourceModel->getElementPointer(index);
+
+        if (pointer != NULL)
+        {
+            return *pointer;
+        }
+
+        element = mSourceModel->getElementAt(index);
+        return element;
+    }
+
+    void SortedListModel::cancelSort()
+    {
+        if (mSortTask != NULL)
+        {
+            mSortTask->mThread.join();
+            delete mSortTask;
+            mSortTask = NULL;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/tablecellrenderer.hpp"
+
+#include "fifechan/font.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/widgets/table.hpp"
+
+namespace fcn
+{
+    void TableCellRenderer::drawCell(Graphics* graphics,
+                                     Table* table,
+                                     const std::string& element,
+                                     int row,
+                                     int column,
+                                     int width,
+                                     int height,
+                                     bool selected)
+    {
+        graphics->setColor(table->getForegroundColor());
+        graphics->drawText(element, 2, (height - table->getFont()->getHeight()) / 2);
+    }
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/tablemodel.hpp"
+
+#include "fifechan/tablemodellistener.hpp"
+
+namespace fcn
+{
+    TableModel::~TableModel()
+    {
+        // Listeners usually remove themselves when told, so work on a copy.
+        TableModelListenerList listeners = mTableModelListeners;
+
+        for (TableModelListenerIterator iter = listeners.begin(); iter != listeners.end(); ++iter)
+        {
+            (*iter)->tableModelDeleted(this);
+        }
+    }
+
+    void TableModel::addTableModelListener(TableModelListener* tableModelListener)
+    {
+        mTableModelListeners.push_back(tableModelListener);
+    }
+
+    void TableModel::removeTableModelListener(TableModelListener* tableModelListener)
+    {
+        mTableModelListeners.remove(tableModelListener);
+    }
+
+    void TableModel::distributeRowsInserted(int first, int count)
+    {
+        TableModelListenerIterator iter;
+
+        for (iter = mTableModelListeners.begin(); iter != mTableModelListeners.end(); ++iter)
+        {
+            (*iter)->rowsInserted(this, first, count);
+        }
+    }
+
+    void TableModel::distributeRowsRemoved(int first, int count)
+    {
+        TableModelListenerIterator iter;
+
+        for (iter = mTableModelListeners.begin(); iter != mTableModelListeners.end(); ++iter)
+        {
+            (*iter)->rowsRemoved(this, first, count);
+        }
+    }
+
+    void TableModel::distributeRowsChanged(int first, int count)
+    {
+        TableModelListenerIterator iter;
+
+        for (iter = mTableModelListeners.begin(); iter != mTableModelListeners.end(); ++iter)
+        {
+            (*iter)->rowsChanged(this, first, count);
+        }
+    }
+
+    void TableModel::distributeColumnsChanged()
+    {
+        TableModelListenerIterator iter;
+
+        for (iter = mTableModelListeners.begin(); iter != mTableModelListeners.end(); ++iter)
+        {
+            (*iter)->columnsChanged(this);
+        }
+    }
+}
@@ -71,36 +71,32 @@
 #include "fifechan/exception.hpp"
 #include "fifechan/font.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace fcn
 {
     Text::Text()
         :mCaretPosition(0),
          mCaretRow(0),
-         mCaretColumn(0)
+         mCaretColumn(0),
+         mRowWidthsFont(NULL),
+         mRowWidthsRevision(0),
+         mRowIndexBase(0),
+         mRowIndexInvalid(true)
     {
     }
 
     Text::Text(const std::string& content)
         :mCaretPosition(0),
          mCaretRow(0),
-         mCaretColumn(0)
+         mCaretColumn(0),
+         mRowWidthsFont(NULL),
+         mRowWidthsRevision(0),
+         mRowIndexBase(0),
+         mRowIndexInvalid(true)
     {
-        std::string::size_type pos, lastPos = 0;
-        int length;
-        do
-        {
-            pos = content.find("\n", lastPos);
-
-            if (pos != std::string::npos)
-                length = pos - lastPos;
-            else
-                length = content.size() - lastPos;
-
-            std::string sub = content.substr(lastPos, length);
-            mRows.push_back(sub);
-            lastPos = pos + 1;
-        }
-        while (pos != std::string::npos);
+        setContent(content);
     }
 
     Text::~Text()
@@ -116,22 +112,16 @@ namespace fcn
         mCaretColumn = 0;
       
         mRows.clear();
+
         std::string::size_type pos, lastPos = 0;
-        int length;
-        do
+        while ((pos = content.find('\n', lastPos)) != std::string::npos)
         {
-            pos = content.find("\n", lastPos);
-
-            if (pos != std::string::npos)
-                length = pos - lastPos;
-            else
-                length = content.size() - lastPos;
-
-            std::string sub = content.substr(lastPos, length);
-            mRows.push_back(sub);
+            mRows.push_back(content.substr(lastPos, pos - lastPos));
             lastPos = pos + 1;
         }
-        while (pos != std::string::npos);
+
+        mRows.push_back(content.substr(lastPos));
+        invalidateRows();
     }
 
     std::string Text::getContent() const
@@ -140,11 +130,17 @@ namespace fcn
             return std::string("");
 
         std::string result;
+        // Leave out the line feed of the last row.
+        result.reserve(getNumberOfCharacters() - 1);
+
         unsigned int i;
         for (i = 0; i < mRows.size() - 1; ++i)
-            result = result + mRows[i] + "\n";
+        {
+            result += mRows[i];
+            result += '\n';
+        }
 
-        result = result + mRows[i];
+        result += mRows[i];
 
         return result;
     }
@@ -155,6 +151,7 @@ namespace fcn
             throw FCN_EXCEPTION("Row out of bounds!");
 
         mRows[row] = content;
+        invalidateRow(row);
     }
 
     void Text::addRow(const std::string& row)
@@ -167,6 +164,7 @@ namespace fcn
         }
 
         mRows.push_back(row);
+        rowsInserted(mRows.size() - 1, 1);
     }
     
     void Text::insertRow(const std::string& row, unsigned int position)
@@ -194,6 +192,7 @@ namespace fcn
         }
 
         mRows.insert(mRows.begin() + position, row);
+        rowsInserted(position, 1);
     }
     
     void Text::eraseRow(unsigned int row)
@@ -202,9 +201,79 @@ namespace fcn
             throw FCN_EXCEPTION("Row to be erased out of bounds!");
         
         mRows.erase(mRows.begin() + row);
+        rowsErased(row, 1);
+    }
+
+    void Text::eraseFirstRows(unsigned int count)
+    {
+        if (count > mRows.size())
+            count = mRows.size();
+
+        if (count == 0)
+            return;
+
+        // Bring the index up to date while the changed rows are still
+        // numbered from the old first row.
+        updateRowIndex();
+
+        for (unsigned int i = 0; i < count; ++i)
+            mRows.pop_front();
+
+        if (mRowWidths.size() == mRows.size() + count)
+            mRowWidths.erase(mRowWidths.begin(), mRowWidths.begin() + count);
+
+        // The slots of the erased rows are kept, which makes erasing a
+        // row constant time. Once they outnumber the rows the index is
+        // built again, which amortizes to constant time as well.
+        mRowIndexBase += count;
+        if (mRowIndexBase > mRows.size())
+            mRowIndexInvalid = true;
+
+        std::vector<unsigned int> watchedRows;
+        for (unsigned int i = 0; i < mWatchedRows.size(); ++i)
+        {
+            if (mWatchedRows[i] >= count)
+                watchedRows.push_back(mWatchedRows[i] - count);
+        }
+        mWatchedRows.swap(watchedRows);
+
+        if (mCaretRow >= count)
+        {
+            mCaretRow -= count;
+        }
+        else
+        {
+            mCaretRow = 0;
+            mCaretColumn = 0;
+        }
+
+        calculateCaretPositionFromRowAndColumn();
     }
 
     std::string& Text::getRow(unsigned int row)
+    {
+        if (row >= mRows.size())
+            throw FCN_EXCEPTION("Row out of bounds!");
+
+        invalidateRow(row);
+
+        if (std::find(mWatchedRows.begin(), mWatchedRows.end(), row) == mWatchedRows.end())
+        {
+            // Checking too many rows on every update would cost more
+            // than building the index again.
+            if (mWatchedRows.size() == 16)
+            {
+                mWatchedRows.clear();
+                mRowIndexInvalid = true;
+            }
+
+            mWatchedRows.push_back(row);
+        }
+
+        return mRows[row];
+    }
+
+    const std::string& Text::getRow(unsigned int row) const
     {
         if (row >= mRows.size())
             throw FCN_EXCEPTION("Row out of bounds!");
@@ -222,6 +291,8 @@ namespace fcn
                  mRows.push_back("");
              else
                  mRows.push_back(std::string(1, c));
+
+             invalidateRows();
         }
         else
         {
@@ -230,14 +301,65 @@ namespace fcn
                 mRows.insert(mRows.begin() + mCaretRow + 1,
                              mRows[mCaretRow].substr(mCaretColumn, mRows[mCaretRow].size() - mCaretColumn));
                 mRows[mCaretRow].resize(mCaretColumn);
+                rowsInserted(mCaretRow + 1, 1);
+                invalidateRow(mCaretRow);
             }
             else
+            {
                 mRows[mCaretRow].insert(mCaretColumn, std::string(1, c));
+                invalidateRow(mCaretRow);
+            }
         }
 
         setCaretPosition(getCaretPosition() + 1);
     }
 
+    void Text::insert(const std::string& text)
+    {
+        if (text.empty())
+            return;
+
+        if (mRows.empty())
+        {
+            mRows.push_back("");
+            invalidateRows();
+        }
+
+        std::string::size_type pos = text.find('\n');
+
+        if (pos == std::string::npos)
+        {
+            mRows[mCaretRow].insert(mCaretColumn, text);
+            invalidateRow(mCaretRow);
+        }
+        else
+        {
+            std::string tail = mRows[mCaretRow].substr(mCaretColumn);
+            mRows[mCaretRow].resize(mCaretColumn);
+            mRows[mCaretRow].append(text, 0, pos);
+
+            std::vector<std::string> rows;
+            rows.reserve(std::count(text.begin() + pos, text.end(), '\n'));
+
+            std::string::size_type lastPos = pos + 1;
+            while ((pos = text.find('\n', lastPos)) != std::string::npos)
+            {
+                rows.push_back(text.substr(lastPos, pos - lastPos));
+                lastPos = pos + 1;
+            }
+
+            rows.push_back(text.substr(lastPos) + tail);
+
+            mRows.insert(mRows.begin() + mCaretRow + 1,
+                         std::make_move_iterator(rows.begin()),
+                         std::make_move_iterator(rows.end()));
+            rowsInserted(mCaretRow + 1, rows.size());
+            invalidateRow(mCaretRow);
+        }
+
+        setCaretPosition(getCaretPosition() + text.size());
+    }
+
     void Text::remove(int numberOfCharacters)
     {
         if (mRows.empty() || numberOfCharacters == 0)
@@ -260,12 +382,15 @@ namespace fcn
                 {
                     mRows[mCaretRow - 1] += mRows[mCaretRow];
                     mRows.erase(mRows.begin() + mCaretRow);
+                    rowsErased(mCaretRow, 1);
+                    invalidateRow(mCaretRow - 1);
                     setCaretRow(mCaretRow - 1);
                     setCaretColumn(getNumberOfCharacters(mCaretRow));
                 }
                 else
                 {
                     mRows[mCaretRow].erase(mCaretColumn - 1, 1);
+                    invalidateRow(mCaretRow);
                     setCaretPosition(mCaretPosition - 1);
                 }
 
@@ -290,10 +415,13 @@ namespace fcn
                 {
                     mRows[mCaretRow] += mRows[mCaretRow + 1];
                     mRows.erase(mRows.begin() + mCaretRow + 1);
+                    rowsErased(mCaretRow + 1, 1);
+                    invalidateRow(mCaretRow);
                 }
                 else
                 {
                     mRows[mCaretRow].erase(mCaretColumn, 1);
+                    invalidateRow(mCaretRow);
                 }
 
                 numberOfCharacters--;
@@ -316,30 +444,19 @@ namespace fcn
             return;
         }
 
-        // Loop through all rows until we find the
-        // position of the caret.
-        unsigned int i;
-        unsigned int total = 0;
-        for (i = 0; i < mRows.size(); i++)
+        // The position is beyond the content.
+        if (position >= (int)getNumberOfCharacters())
         {
-            if (position <= (int)(total + mRows[i].size()))
-            {
-                mCaretRow = i;
-                mCaretColumn = position - total;
-                mCaretPosition = position;
-                return;
-            }
-
-            // Add one for the line feed.
-            total += mRows[i].size() + 1;
+            // Remove one as the last line doesn't have a line feed.
+            mCaretPosition = getNumberOfCharacters() - 1;
+            mCaretRow = mRows.size() - 1;
+            mCaretColumn = mRows[mCaretRow].size();
+            return;
         }
 
-        // The position is beyond the content.
-
-        // Remove one as the last line doesn't have a line feed.
-        mCaretPosition = total - 1;
-        mCaretRow = mRows.size() - 1;
-        mCaretColumn = mRows[mCaretRow].size();
+        mCaretRow = getRowAt(position);
+        mCaretColumn = position - getRowPosition(mCaretRow);
+        mCaretPosition = position;
     }
 
     void Text::setCaretPosition(int x, int y, Font* font)
@@ -348,7 +465,17 @@ namespace fcn
             return;
 
         setCaretRow(y / font->getHeight());
-        setCaretColumn(font->getStringIndexAt(mRows[mCaretRow], x));
+
+        // Find the character under x. Bytes of a character share the
+        // width of the prefix before it, so the first of the bytes is
+        // taken.
+        const std::vector<int>& widths = getRowWidths(mCaretRow, font);
+        std::vector<int>::const_iterator it = std::upper_bound(widths.begin(), widths.end(), x);
+
+        if (it == widths.begin())
+            setCaretColumn(0);
+        else
+            setCaretColumn(std::lower_bound(widths.begin(), it, *(it - 1)) - widths.begin());
     }
 
     int Text::getCaretColumn() const
@@ -390,7 +517,9 @@ namespace fcn
         if (mRows.empty())
             return 0;
 
-        return font->getWidth(mRows[mCaretRow].substr(0, mCaretColumn));
+        const std::vector<int>& widths = getRowWidths(mCaretRow, font);
+
+        return widths[std::min<unsigned int>(mCaretColumn, widths.size() - 1)];
     }
 
     int Text::getCaretY(Font* font) const
@@ -421,7 +550,7 @@ namespace fcn
     Rectangle Text::getCaretDimension(Font* font) const
     {
         Rectangle dim;
-        dim.x = !mRows.empty() ? font->getWidth(mRows[mCaretRow].substr(0, mCaretColumn)) : 0;
+        dim.x = getCaretX(font);
         dim.y = font->getHeight() * mCaretRow;
         dim.width = font->getWidth(" ");
         // We add two for some extra spacing to be sure the whole caret is visible.
@@ -431,7 +560,10 @@ namespace fcn
 
     int Text::getWidth(int row, Font* font) const
     {
-        return 0;
+        if (row < 0 || row >= (int)mRows.size())
+            return 0;
+
+        return getRowWidths(row, font).back();
     }
 
     unsigned int Text::getMaximumCaretRow() const
@@ -446,12 +578,7 @@ namespace fcn
 
     unsigned int Text::getNumberOfCharacters() const
     {
-        unsigned int result = 0;
-        unsigned int i;
-        for (i = 0; i < mRows.size(); ++i)
-            result += mRows[i].size() + 1;
-
-        return result;
+        return getRowPosition(mRows.size());
     }
 
     unsigned int Text::getNumberOfRows() const
@@ -468,13 +595,256 @@ namespace fcn
     }
 
     void Text::calculateCaretPositionFromRowAndColumn()
+    {
+        mCaretPosition = getRowPosition(mCaretRow) + mCaretColumn;
+    }
+
+    unsigned int Text::getRowPosition(unsigned int row) const
+    {
+        updateRowIndex();
+
+        return getIndexSum(mRowIndexBase + row) - getIndexSum(mRowIndexBase);
+    }
+
+    unsigned int Text::getRowAt(unsigned int position) const
+    {
+        updateRowIndex();
+
+        // Slots before the base belong to erased rows.
+        position += getIndexSum(mRowIndexBase);
+
+        unsigned int step = 1;
+        while (step * 2 <= mRowIndex.size())
+            step *= 2;
+
+        // Descend the tree to the last slot starting at or before the
+        // position.
+        unsigned int slot = 0;
+        for (; step > 0; step /= 2)
+        {
+            if (slot + step <= mRowIndex.size() && mRowIndex[slot + step - 1] <= position)
+            {
+                slot += step;
+                position -= mRowIndex[slot - 1];
+            }
+        }
+
+        return slot - mRowIndexBase;
+    }
+
+    unsigned int Text::getIndexSum(unsigned int slots) const
+    {
+        unsigned int sum = 0;
+        for (unsigned int node = slots; node > 0; node -= node & -node)
+            sum += mRowIndex[node - 1];
+
+        return sum;
+    }
+
+    void Text::updateRowIndex() const
     {
         unsigned int i;
-        unsigned int total = 0;
-        for (i = 0; i < mCaretRow; i++)
-            // Add one for the line feed.
-            total += mRows[i].size() + 1;
 
-        mCaretPosition = total + mCaretColumn;
+        if (mRowIndexInvalid || mRowLengths.size() != mRowIndexBase + mRows.size())
+        {
+            unsigned int size = mRows.size();
+            mRowLengths.resize(size);
+            mRowIndex.resize(size);
+            mRowIndexBase = 0;
+
+            for (i = 0; i < size; ++i)
+            {
+                // Add one for the line feed.
+                mRowLengths[i] = mRows[i].size() + 1;
+                mRowIndex[i] = mRowLengths[i];
+            }
+
+            // Build the Fenwick tree in place, every node adds itself to
+            // its parent.
+            for (i = 1; i <= size; ++i)
+            {
+                unsigned int parent = i + (i & -i);
+                if (parent <= size)
+                    mRowIndex[parent - 1] += mRowIndex[i - 1];
+            }
+
+            mChangedRows.clear();
+            mRowIndexInvalid = false;
+            return;
+        }
+
+        mChangedRows.insert(mChangedRows.end(), mWatchedRows.begin(), mWatchedRows.end());
+
+        for (i = 0; i < mChangedRows.size(); ++i)
+        {
+            unsigned int row = mChangedRows[i];
+            if (row >= mRows.size())
+                continue;
+
+            unsigned int slot = mRowIndexBase + row;
+            unsigned int length = mRows[row].size() + 1;
+            if (length == mRowLengths[slot])
+                continue;
+
+            // Unsigned arithmetic wraps around, so this also works for
+            // rows which got shorter.
+            unsigned int delta = length - mRowLengths[slot];
+            for (unsigned int node = slot + 1; node <= mRowIndex.size(); node += node & -node)
+                mRowIndex[node - 1] += delta;
+
+            mRowLengths[slot] = length;
+        }
+
+        mChangedRows.clear();
+    }
+
+    void Text::buildRowIndex(unsigned int slot)
+    {
+        // A node covers its own slot and the slots of the nodes
+        // node - 1, node - 2, node - 4 ... below it. The nodes up to the
+        // slot only cover unchanged slots, the ones after it are built
+        // in order so their children are up to date.
+        for (unsigned int node = slot + 1; node <= mRowIndex.size(); ++node)
+        {
+            unsigned int sum = mRowLengths[node - 1];
+            for (unsigned int step = 1; step < (node & -node); step <<= 1)
+                sum += mRowIndex[node - step - 1];
+
+            mRowIndex[node - 1] = sum;
+        }
+    }
+
+    const std::vector<int>& Text::getRowWidths(unsigned int row, Font* font) const
+    {
+        if (font != mRowWidthsFont
+            || font->getRevision() != mRowWidthsRevision
+            || mRowWidths.size() != mRows.size())
+        {
+            mRowWidths.clear();
+            mRowWidths.resize(mRows.size());
+            mRowWidthsFont = font;
+            mRowWidthsRevision = font->getRevision();
+        }
+
+        std::vector<int>& widths = mRowWidths[row];
+
+        if (widths.empty())
+            font->getPrefixWidths(mRows[row], widths);
+
+        return widths;
+    }
+
+    void Text::invalidateRow(unsigned int row)
+    {
+        if (row < mRowWidths.size())
+            mRowWidths[row].clear();
+
+        if (mRowIndexInvalid)
+            return;
+
+        // Building the index again is cheaper than updating it for a
+        // lot of rows.
+        if (mChangedRows.size() == 64)
+        {
+            mChangedRows.clear();
+            mRowIndexInvalid = true;
+        }
+        else
+        {
+            mChangedRows.push_back(row);
+        }
+    }
+
+    void Text::invalidateRows()
+    {
+        mRowWidths.clear();
+        mChangedRows.clear();
+        mWatchedRows.clear();
+        mRowIndexInvalid = true;
+    }
+
+    void Text::rowsInserted(unsigned int row, unsigned int count)
+    {
+        unsigned int i;
+
+        if (mRowWidths.size() == mRows.size() - count)
+            mRowWidths.insert(mRowWidths.begin() + row, count, std::vector<int>());
+        else
+            mRowWidths.clear();
+
+        // The rows after the inserted ones move down, and so do their
+        // pending changes.
+        for (i = 0; i < mChangedRows.size(); ++i)
+        {
+            if (mChangedRows[i] >= row)
+                mChangedRows[i] += count;
+        }
+
+        for (i = 0; i < mWatchedRows.size(); ++i)
+        {
+            if (mWatchedRows[i] >= row)
+                mWatchedRows[i] += count;
+        }
+
+        if (mRowIndexInvalid || mRowLengths.size() != mRowIndexBase + mRows.size() - count)
+        {
+            mRowIndexInvalid = true;
+            return;
+        }
+
+        // Only the nodes from the first inserted slot on are built
+        // again. That is constant time for rows appended at the end,
+        // but still linear in the number of rows after the inserted
+        // ones, just like inserting them into the rows.
+        unsigned int slot = mRowIndexBase + row;
+        mRowLengths.insert(mRowLengths.begin() + slot, count, 0);
+        for (i = 0; i < count; ++i)
+            mRowLengths[slot + i] = mRows[row + i].size() + 1;
+
+        mRowIndex.resize(mRowLengths.size());
+        buildRowIndex(slot);
+    }
+
+    void Text::rowsErased(unsigned int row, unsigned int count)
+    {
+        unsigned int i;
+
+        if (mRowWidths.size() == mRows.size() + count)
+            mRowWidths.erase(mRowWidths.begin() + row, mRowWidths.begin() + row + count);
+        else
+            mRowWidths.clear();
+
+        // Pending changes of the erased rows are dropped, the ones of
+        // the rows after them move up.
+        std::vector<unsigned int> changedRows;
+        for (i = 0; i < mChangedRows.size(); ++i)
+        {
+            if (mChangedRows[i] < row)
+                changedRows.push_back(mChangedRows[i]);
+            else if (mChangedRows[i] >= row + count)
+                changedRows.push_back(mChangedRows[i] - count);
+        }
+        mChangedRows.swap(changedRows);
+
+        std::vector<unsigned int> watchedRows;
+        for (i = 0; i < mWatchedRows.size(); ++i)
+        {
+            if (mWatchedRows[i] < row)
+                watchedRows.push_back(mWatchedRows[i]);
+            else if (mWatchedRows[i] >= row + count)
+                watchedRows.push_back(mWatchedRows[i] - count);
+        }
+        mWatchedRows.swap(watchedRows);
+
+        if (mRowIndexInvalid || mRowLengths.size() != mRowIndexBase + mRows.size() + count)
+        {
+            mRowIndexInvalid = true;
+            return;
+        }
+
+        unsigned int slot = mRowIndexBase + row;
+        mRowLengths.erase(mRowLengths.begin() + slot, mRowLengths.begin() + slot + count);
+        mRowIndex.resize(mRowLengths.size());
+        buildRowIndex(slot);
     }
 }
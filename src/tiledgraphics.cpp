@@ -0,0 +1,840 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/tiledgraphics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include "fifechan/exception.hpp"
+#include "fifechan/image.hpp"
+
+namespace fcn
+{
+    /**
+     * A pool of threads rasterizing the active tiles of a TiledGraphics.
+     * The thread calling run() takes part as worker 0.
+     */
+    class TiledGraphics::WorkerPool
+    {
+    public:
+        WorkerPool(TiledGraphics* owner, int size)
+            : mOwner(owner),
+              mGeneration(0),
+              mQuit(false),
+              mTiles(0),
+              mNext(0),
+              mBusy(0),
+              mFailed(false)
+        {
+            for (int i = 1; i < size; ++i)
+            {
+                mThreads.push_back(std::thread(&WorkerPool::loop, this, i));
+            }
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQuit = true;
+            }
+            mStart.notify_all();
+
+            for (unsigned int i = 0; i < mThreads.size(); ++i)
+            {
+                mThreads[i].join();
+            }
+        }
+
+        int getSize() const
+        {
+            return mThreads.size() + 1;
+        }
+
+        void run(int tiles)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mTiles = tiles;
+                mNext = 0;
+                mBusy = mThreads.size();
+                mFailed = false;
+                ++mGeneration;
+            }
+            mStart.notify_all();
+
+            work(0);
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mBusy > 0)
+            {
+                mDone.wait(lock);
+            }
+
+            if (mFailed)
+            {
+                throw mException;
+            }
+        }
+
+    private:
+        void loop(int worker)
+        {
+            unsigned int generation = 0;
+
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    while (!mQuit && generation == mGeneration)
+                    {
+                        mStart.wait(lock);
+                    }
+
+                    if (mQuit)
+                    {
+                        return;
+                    }
+
+                    generation = mGeneration;
+                }
+
+                work(worker);
+
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    --mBusy;
+                }
+                mDone.notify_one();
+            }
+        }
+
+        void work(int worker)
+        {
+            try
+            {
+                for (int i = mNext++; i < mTiles; i = mNext++)
+                {
+                    mOwner->renderTile(worker, mOwner->mActiveTiles[i]);
+                }
+            }
+            catch (const Exception& e)
+            {
+                fail(e);
+            }
+            catch (const std::exception& e)
+            {
+                fail(Exception(e.what()));
+            }
+        }
+
+        void fail(const Exception& e)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            if (!mFailed)
+            {
+                mFailed = true;
+                mException = e;
+            }
+
+            // Let the other workers run out of tiles
+            mNext = mTiles;
+        }
+
+        TiledGraphics* mOwner;
+        std::vector<std::thread> mThreads;
+        std::mutex mMutex;
+        std::condition_variable mStart;
+        std::condition_variable mDone;
+        unsigned int mGeneration;
+        bool mQuit;
+        int mTiles;
+        std::atomic<int> mNext;
+        int mBusy;
+        bool mFailed;
+        Exception mException;
+    };
+
+    TiledGraphics::TiledGraphics()
+    {
+        mThreads = 0;
+        mTileWidth = 128;
+        mTileHeight = 128;
+        mTilesX = 0;
+        mTilesY = 0;
+        mPool = NULL;
+    }
+
+    TiledGraphics::~TiledGraphics()
+    {
+        delete mPool;
+        clearTileGraphics();
+    }
+
+    void TiledGraphics::setThreadCount(int threads)
+    {
+        mThreads = threads < 0 ? 0 : threads;
+    }
+
+    int TiledGraphics::getThreadCount() const
+    {
+        return mThreads;
+    }
+
+    void TiledGraphics::setTileSize(int width, int height)
+    {
+        if (width < 1 || height < 1)
+        {
+            throw FCN_EXCEPTION("Tile size must be at least 1x1.");
+        }
+
+        mTileWidth = width;
+        mTileHeight = height;
+    }
+
+    int TiledGraphics::getTileWidth() const
+    {
+        return mTileWidth;
+    }
+
+    int TiledGraphics::getTileHeight() const
+    {
+        return mTileHeight;
+    }
+
+    void TiledGraphics::clearTileGraphics()
+    {
+        for (unsigned int i = 0; i < mTileGraphics.size(); ++i)
+        {
+            delete mTileGraphics[i];
+        }
+
+        mTileGraphics.clear();
+        mTilePoints.clear();
+    }
+
+    void TiledGraphics::_beginDraw()
+    {
+        mTilesX = (getTargetWidth() + mTileWidth - 1) / mTileWidth;
+        mTilesY = (getTargetHeight() + mTileHeight - 1) / mTileHeight;
+        mTiles.resize(mTilesX * mTilesY);
+
+        Rectangle area;
+        area.x = 0;
+        area.y = 0;
+        area.width = getTargetWidth();
+        area.height = getTargetHeight();
+        pushClipArea(area);
+    }
+
+    void TiledGraphics::_endDraw()
+    {
+        popClipArea();
+
+        mActiveTiles.clear();
+        for (unsigned int i = 0; i < mTiles.size(); ++i)
+        {
+            if (!mTiles[i].empty())
+            {
+                mActiveTiles.push_back(i);
+            }
+        }
+
+        int threads = mThreads;
+        if (threads == 0)
+        {
+            threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        if (mPool != NULL && mPool->getSize() != threads)
+        {
+            delete mPool;
+            mPool = NULL;
+        }
+
+        // The workers get their graphics here as creating them might not
+        // be thread safe.
+        int workers = mActiveTiles.size() > 1 ? threads : mActiveTiles.size();
+        while (static_cast<int>(mTileGraphics.size()) < workers)
+        {
+            mTileGraphics.push_back(createTileGraphics());
+            mTilePoints.push_back(PointVector());
+        }
+
+        try
+        {
+            if (workers == 1)
+            {
+                for (unsigned int i = 0; i < mActiveTiles.size(); ++i)
+                {
+                    renderTile(0, mActiveTiles[i]);
+                }
+            }
+            else if (workers > 1)
+            {
+                if (mPool == NULL)
+                {
+                    mPool = new WorkerPool(this, threads);
+                }
+
+                mPool->run(mActiveTiles.size());
+            }
+        }
+        catch (...)
+        {
+            for (unsigned int i = 0; i < mActiveTiles.size(); ++i)
+            {
+                mTiles[mActiveTiles[i]].clear();
+            }
+            mCommands.clear();
+            mPoints.clear();
+            throw;
+        }
+
+        for (unsigned int i = 0; i < mActiveTiles.size(); ++i)
+        {
+            mTiles[mActiveTiles[i]].clear();
+        }
+        mCommands.clear();
+        mPoints.clear();
+    }
+
+    TiledGraphics::Command* TiledGraphics::record(CommandType type, const Rectangle& bounds)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        const ClipRectangle& top = mClipStack.top();
+
+        Rectangle area = bounds.intersection(top);
+
+        if (area.isEmpty())
+        {
+            return NULL;
+        }
+
+        unsigned int index = mCommands.size();
+
+        Command command;
+        command.type = type;
+        command.image = NULL;
+        command.color = mColor;
+        command.clip = Rectangle(top.x, top.y, top.width, top.height);
+        command.firstPoint = 0;
+        command.pointCount = 0;
+        mCommands.push_back(command);
+
+        int tx1 = area.x / mTileWidth;
+        int ty1 = area.y / mTileHeight;
+        int tx2 = std::min((area.x + area.width - 1) / mTileWidth, mTilesX - 1);
+        int ty2 = std::min((area.y + area.height - 1) / mTileHeight, mTilesY - 1);
+
+        for (int ty = ty1; ty <= ty2; ++ty)
+        {
+            for (int tx = tx1; tx <= tx2; ++tx)
+            {
+                mTiles[ty * mTilesX + tx].push_back(index);
+            }
+        }
+
+        return &mCommands.back();
+    }
+
+    void TiledGraphics::renderTile(int worker, int tile)
+    {
+        Graphics* graphics = mTileGraphics[worker];
+        PointVector& points = mTilePoints[worker];
+        const std::vector<unsigned int>& commands = mTiles[tile];
+
+        Rectangle tileArea((tile % mTilesX) * mTileWidth,
+                           (tile / mTilesX) * mTileHeight,
+                           mTileWidth,
+                           mTileHeight);
+
+        graphics->_beginDraw();
+
+        Rectangle clip;
+        bool pushed = false;
+
+        for (unsigned int i = 0; i < commands.size(); ++i)
+        {
+            const Command& command = mCommands[commands[i]];
+            Rectangle area = command.clip.intersection(tileArea);
+
+            if (!pushed
+                || area.x != clip.x
+                || area.y != clip.y
+                || area.width != clip.width
+                || area.height != clip.height)
+            {
+                if (pushed)
+                {
+                    graphics->popClipArea();
+                }
+
+                graphics->pushClipArea(area);
+                clip = area;
+                pushed = true;
+            }
+
+            if (i == 0 || graphics->getColor() != command.color)
+            {
+                graphics->setColor(command.color);
+            }
+
+            // Commands are stored in target space, the clip area offset
+            // is the top left corner of the clip area.
+            int ox = clip.x;
+            int oy = clip.y;
+            const int* a = command.args;
+
+            switch (command.type)
+            {
+              case DrawImage:
+                  graphics->drawImage(command.image, a[0], a[1], a[2] - ox, a[3] - oy, a[4], a[5]);
+                  break;
+              case DrawPoint:
+                  graphics->drawPoint(a[0] - ox, a[1] - oy);
+                  break;
+              case DrawLine:
+                  graphics->drawLine(a[0] - ox, a[1] - oy, a[2] - ox, a[3] - oy);
+                  break;
+              case DrawThickLine:
+                  graphics->drawLine(a[0] - ox, a[1] - oy, a[2] - ox, a[3] - oy, a[4]);
+                  break;
+              case DrawPolyLine:
+              case DrawBezier:
+                  points.clear();
+                  for (unsigned int k = 0; k < command.pointCount; ++k)
+                  {
+                      const Point& p = mPoints[command.firstPoint + k];
+                      points.push_back(Point(p.x - ox, p.y - oy));
+                  }
+
+                  if (command.type == DrawPolyLine)
+                  {
+                      graphics->drawPolyLine(points, a[0]);
+                  }
+                  else
+                  {
+                      graphics->drawBezier(points, a[1], a[0]);
+                  }
+                  break;
+              case DrawRectangle:
+                  graphics->drawRectangle(Rectangle(a[0] - ox, a[1] - oy, a[2], a[3]));
+                  break;
+              case FillRectangle:
+                  graphics->fillRectangle(Rectangle(a[0] - ox, a[1] - oy, a[2], a[3]));
+                  break;
+              case DrawCircle:
+                  graphics->drawCircle(Point(a[0] - ox, a[1] - oy), a[2]);
+                  break;
+              case DrawFillCircle:
+                  graphics->drawFillCircle(Point(a[0] - ox, a[1] - oy), a[2]);
+                  break;
+              case DrawCircleSegment:
+                  graphics->drawCircleSegment(Point(a[0] - ox, a[1] - oy), a[2], a[3], a[4]);
+                  break;
+              case DrawFillCircleSegment:
+                  graphics->drawFillCircleSegment(Point(a[0] - ox, a[1] - oy), a[2], a[3], a[4]);
+                  break;
+            }
+        }
+
+        if (pushed)
+        {
+            graphics->popClipArea();
+        }
+
+        graphics->_endDraw();
+    }
+
+    void TiledGraphics::drawImage(const Image* image,
+                                  int srcX,
+                                  int srcY,
+                                  int dstX,
+                                  int dstY,
+                                  int width,
+                                  int height)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        dstX += mClipStack.top().xOffset;
+        dstY += mClipStack.top().yOffset;
+
+        Command* command = record(DrawImage, Rectangle(dstX, dstY, width, height));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->image = image;
+        command->args[0] = srcX;
+        command->args[1] = srcY;
+        command->args[2] = dstX;
+        command->args[3] = dstY;
+        command->args[4] = width;
+        command->args[5] = height;
+    }
+
+    void TiledGraphics::drawPoint(int x, int y)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        x += mClipStack.top().xOffset;
+        y += mClipStack.top().yOffset;
+
+        Command* command = record(DrawPoint, Rectangle(x, y, 1, 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x;
+        command->args[1] = y;
+    }
+
+    void TiledGraphics::drawLine(int x1, int y1, int x2, int y2)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        const ClipRectangle& top = mClipStack.top();
+        x1 += top.xOffset;
+        y1 += top.yOffset;
+        x2 += top.xOffset;
+        y2 += top.yOffset;
+
+        Command* command = record(DrawLine, Rectangle(std::min(x1, x2),
+                                                      std::min(y1, y2),
+                                                      std::abs(x2 - x1) + 1,
+                                                      std::abs(y2 - y1) + 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x1;
+        command->args[1] = y1;
+        command->args[2] = x2;
+        command->args[3] = y2;
+    }
+
+    void TiledGraphics::drawLine(int x1, int y1, int x2, int y2, unsigned int width)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        const ClipRectangle& top = mClipStack.top();
+        x1 += top.xOffset;
+        y1 += top.yOffset;
+        x2 += top.xOffset;
+        y2 += top.yOffset;
+
+        int border = width / 2 + 1;
+        Command* command = record(DrawThickLine, Rectangle(std::min(x1, x2) - border,
+                                                           std::min(y1, y2) - border,
+                                                           std::abs(x2 - x1) + 1 + 2 * border,
+                                                           std::abs(y2 - y1) + 1 + 2 * border));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x1;
+        command->args[1] = y1;
+        command->args[2] = x2;
+        command->args[3] = y2;
+        command->args[4] = width;
+    }
+
+    void TiledGraphics::drawPolyLine(const PointVector& points, unsigned int width)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        if (points.empty())
+        {
+            return;
+        }
+
+        const ClipRectangle& top = mClipStack.top();
+
+        int minX = points[0].x, minY = points[0].y;
+        int maxX = minX, maxY = minY;
+        for (unsigned int i = 1; i < points.size(); ++i)
+        {
+            minX = std::min(minX, points[i].x);
+            minY = std::min(minY, points[i].y);
+            maxX = std::max(maxX, points[i].x);
+            maxY = std::max(maxY, points[i].y);
+        }
+
+        int border = width / 2 + 1;
+        Command* command = record(DrawPolyLine, Rectangle(minX + top.xOffset - border,
+                                                          minY + top.yOffset - border,
+                                                          maxX - minX + 1 + 2 * border,
+                                                          maxY - minY + 1 + 2 * border));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = width;
+        command->firstPoint = mPoints.size();
+        command->pointCount = points.size();
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            mPoints.push_back(Point(points[i].x + top.xOffset, points[i].y + top.yOffset));
+        }
+    }
+
+    void TiledGraphics::drawBezier(const PointVector& points, int steps, unsigned int width)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        if (points.empty())
+        {
+            return;
+        }
+
+        const ClipRectangle& top = mClipStack.top();
+
+        // A bezier curve lies within the convex hull of its points
+        int minX = points[0].x, minY = points[0].y;
+        int maxX = minX, maxY = minY;
+        for (unsigned int i = 1; i < points.size(); ++i)
+        {
+            minX = std::min(minX, points[i].x);
+            minY = std::min(minY, points[i].y);
+            maxX = std::max(maxX, points[i].x);
+            maxY = std::max(maxY, points[i].y);
+        }
+
+        int border = width / 2 + 1;
+        Command* command = record(DrawBezier, Rectangle(minX + top.xOffset - border,
+                                                        minY + top.yOffset - border,
+                                                        maxX - minX + 1 + 2 * border,
+                                                        maxY - minY + 1 + 2 * border));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = width;
+        command->args[1] = steps;
+        command->firstPoint = mPoints.size();
+        command->pointCount = points.size();
+
+        for (unsigned int i = 0; i < points.size(); ++i)
+        {
+            mPoints.push_back(Point(points[i].x + top.xOffset, points[i].y + top.yOffset));
+        }
+    }
+
+    void TiledGraphics::drawRectangle(const Rectangle& rectangle)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        Rectangle area = rectangle;
+        area.x += mClipStack.top().xOffset;
+        area.y += mClipStack.top().yOffset;
+
+        Command* command = record(DrawRectangle, area);
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = area.x;
+        command->args[1] = area.y;
+        command->args[2] = area.width;
+        command->args[3] = area.height;
+    }
+
+    void TiledGraphics::fillRectangle(const Rectangle& rectangle)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        Rectangle area = rectangle;
+        area.x += mClipStack.top().xOffset;
+        area.y += mClipStack.top().yOffset;
+
+        Command* command = record(FillRectangle, area);
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = area.x;
+        command->args[1] = area.y;
+        command->args[2] = area.width;
+        command->args[3] = area.height;
+    }
+
+    void TiledGraphics::drawCircle(const Point& p, unsigned int radius)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        int x = p.x + mClipStack.top().xOffset;
+        int y = p.y + mClipStack.top().yOffset;
+        int r = radius + 1;
+
+        Command* command = record(DrawCircle, Rectangle(x - r, y - r, 2 * r + 1, 2 * r + 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x;
+        command->args[1] = y;
+        command->args[2] = radius;
+    }
+
+    void TiledGraphics::drawFillCircle(const Point& p, unsigned int radius)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        int x = p.x + mClipStack.top().xOffset;
+        int y = p.y + mClipStack.top().yOffset;
+        int r = radius + 1;
+
+        Command* command = record(DrawFillCircle, Rectangle(x - r, y - r, 2 * r + 1, 2 * r + 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x;
+        command->args[1] = y;
+        command->args[2] = radius;
+    }
+
+    void TiledGraphics::drawCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        int x = p.x + mClipStack.top().xOffset;
+        int y = p.y + mClipStack.top().yOffset;
+        int r = radius + 1;
+
+        Command* command = record(DrawCircleSegment, Rectangle(x - r, y - r, 2 * r + 1, 2 * r + 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x;
+        command->args[1] = y;
+        command->args[2] = radius;
+        command->args[3] = sangle;
+        command->args[4] = eangle;
+    }
+
+    void TiledGraphics::drawFillCircleSegment(const Point& p, unsigned int radius, int sangle, int eangle)
+    {
+        if (mClipStack.empty())
+        {
+            throw FCN_EXCEPTION("Clip stack is empty, perhaps you called a draw funtion outside of _beginDraw() and _endDraw()?");
+        }
+
+        int x = p.x + mClipStack.top().xOffset;
+        int y = p.y + mClipStack.top().yOffset;
+        int r = radius + 1;
+
+        Command* command = record(DrawFillCircleSegment, Rectangle(x - r, y - r, 2 * r + 1, 2 * r + 1));
+
+        if (command == NULL)
+        {
+            return;
+        }
+
+        command->args[0] = x;
+        command->args[1] = y;
+        command->args[2] = radius;
+        command->args[3] = sangle;
+        command->args[4] = eangle;
+    }
+
+    void TiledGraphics::setColor(const Color& color)
+    {
+        mColor = color;
+    }
+
+    const Color& TiledGraphics::getColor() const
+    {
+        return mColor;
+    }
+}
@@ -21,10 +21,117 @@
 
 #include <fifechan/utf8stringeditor.hpp>
 #include <fifechan/util/utf8/utf8.hpp>
+#include <algorithm>
 #include <iostream>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FCN_UTF8_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace fcn {
 
+	/**
+	 * Skips ASCII characters, which are one byte each and always valid.
+	 * Tests 16 bytes at a time when the compiler targets SSE2.
+	 *
+	 * @param cur The first byte to test.
+	 * @param end The end of the bytes to test.
+	 * @return The first byte which is not ASCII, or end.
+	 */
+	static const char* skipAscii(const char* cur, const char* end)
+	{
+#if defined(FCN_UTF8_SSE2)
+		for (; end - cur >= 16; cur += 16)
+		{
+			int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)cur));
+
+			if (mask != 0)
+			{
+				// Step to the first byte with the high bit set.
+				while ((mask & 1) == 0)
+				{
+					mask >>= 1;
+					++cur;
+				}
+
+				return cur;
+			}
+		}
+#endif
+
+		while (cur != end && (unsigned char)*cur < 0x80)
+		{
+			++cur;
+		}
+
+		return cur;
+	}
+
+	/**
+	 * Counts the characters in a range of bytes.
+	 *
+	 * @param cur The first byte of the range.
+	 * @param end The end of the range.
+	 * @return Number of characters.
+	 */
+	static int countBetween(const char* cur, const char* end)
+	{
+		int count = 0;
+
+		while (cur != end)
+		{
+			const char* ascii = skipAscii(cur, end);
+			count += ascii - cur;
+			cur = ascii;
+
+			if (cur != end)
+			{
+				utf8::next(cur, end);
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	/**
+	 * Steps over characters, stopping at the end of the text.
+	 *
+	 * @param cur The first byte of a character, moved past the characters.
+	 * @param end The end of the text.
+	 * @param count Number of characters to step over.
+	 * @return Number of characters stepped over.
+	 */
+	static int skipChars(const char*& cur, const char* end, int count)
+	{
+		int i = 0;
+
+		while (i < count && cur != end)
+		{
+			// Don't skip past the character we are looking for.
+			const char* last = end - cur > count - i ? cur + (count - i) : end;
+			const char* ascii = skipAscii(cur, last);
+			i += ascii - cur;
+			cur = ascii;
+
+			if (i < count && cur != end)
+			{
+				utf8::next(cur, end);
+				++i;
+			}
+		}
+
+		return i;
+	}
+
+	UTF8StringEditor::UTF8StringEditor()
+		: mIndexedText(NULL),
+		  mIndexedSize(0),
+		  mIndexedChars(0)
+	{
+	}
+
 	int UTF8StringEditor::nextChar(const std::string & text, int byteOffset)
 	{
 		std::string::const_iterator c, e;
@@ -33,7 +140,7 @@ namespace fcn {
 		e = text.end();
 
 		utf8::next(c, e);
-		return std::string(text.begin(), c).size();
+		return c - text.begin();
 	}
 
 	int UTF8StringEditor::prevChar(const std::string & text, int byteOffset)
@@ -44,7 +151,7 @@ namespace fcn {
 		b = text.begin();
 
 		utf8::prior(c, b);
-		return std::string(b, c).size();
+		return c - b;
 	}
 
 	int UTF8StringEditor::eraseChar(std::string & text, int byteOffset)
@@ -54,52 +161,160 @@ namespace fcn {
 		cur = begin;
 		utf8::next(cur, text.end());
 
-		text = std::string(text.begin(), begin) + std::string(cur, text.end());
+		text.erase(begin, cur);
 		return byteOffset; // this shouldn't change!
 	}
 
 	int UTF8StringEditor::insertChar(std::string & text, int byteOffset, int ch)
 	{
-		std::string newText;
-		std::string::iterator cut;
-		int newOffset;
+		// A character takes at most 4 bytes.
+		char buffer[4];
+		char* end = utf8::append(ch, buffer);
 
-		// make a temp string from left part of the caret (+6 extra chars)
-		newText = text.substr(0, byteOffset) + "        ";
-		// append character
-		utf8::append(ch, newText.begin() + byteOffset);
-		// calculate newText real length
-		cut = newText.begin() + byteOffset;
-		utf8::next(cut, newText.end());
-		// cut the string to real length
-		newText = std::string(newText.begin(), cut);
-		newOffset = newText.size();
-		// make new text
-		text = newText + text.substr(byteOffset);
+		text.insert(byteOffset, buffer, end - buffer);
 
-		return newOffset;
+		return byteOffset + (end - buffer);
 	}
 
 	int UTF8StringEditor::countChars(const std::string & text, int byteOffset)
 	{
-		return utf8::distance(text.begin(), text.begin() + byteOffset);
+		return countBetween(text.data(), text.data() + byteOffset);
 	}
 
 	int UTF8StringEditor::getOffset(const std::string & text, int charIndex)
 	{
-		std::string::const_iterator cur, end;
-		int bytes = 0, i;
+		const char* cur = text.data();
+
+		if (charIndex < 0) return 0;
+
+		skipChars(cur, text.data() + text.size(), charIndex);
+		return cur - text.data();
+	}
+
+	bool UTF8StringEditor::isValid(const std::string & text)
+	{
+		const char* cur = text.data();
+		const char* end = cur + text.size();
+
+		while (cur != end)
+		{
+			cur = skipAscii(cur, end);
+
+			if (cur != end && utf8::internal::validate_next(cur, end) != utf8::internal::UTF8_OK)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	int UTF8StringEditor::countCharsIndexed(const std::string & text, int byteOffset)
+	{
+		updateIndex(text);
+
+		// The last checkpoint at or before byteOffset.
+		std::vector<int>::const_iterator checkpoint =
+			std::upper_bound(mCheckpoints.begin(), mCheckpoints.end(), byteOffset) - 1;
+		int chars = (checkpoint - mCheckpoints.begin()) * CheckpointInterval;
+
+		return chars + countBetween(text.data() + *checkpoint, text.data() + byteOffset);
+	}
 
+	int UTF8StringEditor::getOffsetIndexed(const std::string & text, int charIndex)
+	{
 		if (charIndex < 0) return 0;
 
-		cur = text.begin();
-		end = text.end();
+		updateIndex(text);
+
+		unsigned int checkpoint = std::min<unsigned int>(charIndex / CheckpointInterval,
+			mCheckpoints.size() - 1);
+		const char* cur = text.data() + mCheckpoints[checkpoint];
+
+		skipChars(cur, text.data() + text.size(), charIndex - checkpoint * CheckpointInterval);
+		return cur - text.data();
+	}
 
-		for(i = 0; i < charIndex && cur != end; i++) {
-			utf8::next(cur, end);
+	int UTF8StringEditor::insertCharIndexed(std::string & text, int byteOffset, int ch)
+	{
+		updateIndex(text);
+
+		int next = insertChar(text, byteOffset, ch);
+		int length = next - byteOffset;
+
+		// The characters behind the new one moved up by one, so a
+		// checkpoint behind it lands on the character before its old one.
+		for (int i = mCheckpoints.size() - 1; i >= 0 && mCheckpoints[i] > byteOffset; --i)
+		{
+			mCheckpoints[i] = prevChar(text, mCheckpoints[i] + length);
+		}
+
+		++mIndexedChars;
+		if ((int)mCheckpoints.size() * CheckpointInterval == mIndexedChars)
+		{
+			mCheckpoints.push_back(text.size());
 		}
 
-		return std::string(text.begin(), cur).size();
+		mIndexedSize = text.size();
+		return next;
+	}
+
+	int UTF8StringEditor::eraseCharIndexed(std::string & text, int byteOffset)
+	{
+		updateIndex(text);
+
+		int length = nextChar(text, byteOffset) - byteOffset;
+		eraseChar(text, byteOffset);
+
+		--mIndexedChars;
+		if ((int)(mCheckpoints.size() - 1) * CheckpointInterval > mIndexedChars)
+		{
+			mCheckpoints.pop_back();
+		}
+
+		// The characters behind the erased one moved down by one, so a
+		// checkpoint behind it lands on the character after its old one.
+		for (int i = mCheckpoints.size() - 1; i >= 0 && mCheckpoints[i] > byteOffset; --i)
+		{
+			mCheckpoints[i] = nextChar(text, mCheckpoints[i] - length);
+		}
+
+		mIndexedSize = text.size();
+		return byteOffset;
+	}
+
+	void UTF8StringEditor::invalidateIndex()
+	{
+		mIndexedText = NULL;
+	}
+
+	void UTF8StringEditor::updateIndex(const std::string & text)
+	{
+		if (mIndexedText == &text && mIndexedSize == text.size())
+		{
+			return;
+		}
+
+		const char* cur = text.data();
+		const char* end = cur + text.size();
+
+		mIndexedText = &text;
+		mIndexedSize = text.size();
+		mIndexedChars = 0;
+		mCheckpoints.assign(1, 0);
+
+		while (true)
+		{
+			int chars = skipChars(cur, end, CheckpointInterval);
+			mIndexedChars += chars;
+
+			if (chars < CheckpointInterval)
+			{
+				break;
+			}
+
+			mCheckpoints.push_back(cur - text.data());
+		}
 	}
 };
 
@@ -119,6 +119,7 @@ namespace fcn
               mTabIn(true),
               mTabOut(true),
               mEnabled(true),
+              mRedrawRequesting(false),
               mCurrentFont(NULL),
               mMinSize(0, 0),
               mMaxSize(50000, 50000),
@@ -450,6 +451,7 @@ namespace fcn
     void Widget::setOutlineSize(unsigned int size)
     {
         mOutlineSize = size;
+        requestRedraw();
     }
 
     unsigned int Widget::getOutlineSize() const
@@ -460,6 +462,7 @@ namespace fcn
     void Widget::setBorderSize(unsigned int size)
     {
         mBorderSize = size;
+        requestRedraw();
     }
 
     unsigned int Widget::getBorderSize() const
@@ -624,6 +627,33 @@ namespace fcn
             mParent->moveToBottom(this);
     }
 
+    void Widget::requestRedraw()
+    {
+        if (mParent != NULL)
+            mParent->redrawChild(this);
+    }
+
+    void Widget::setRedrawRequesting(bool requesting)
+    {
+        mRedrawRequesting = requesting;
+        requestRedraw();
+    }
+
+    bool Widget::isRedrawRequesting() const
+    {
+        if (!mRedrawRequesting)
+            return false;
+
+        std::list<Widget*>::const_iterator iter;
+        for (iter = mChildren.begin(); iter != mChildren.end(); ++iter)
+        {
+            if (!(*iter)->isRedrawRequesting())
+                return false;
+        }
+
+        return true;
+    }
+
     void Widget::setVisible(bool visible)
     {   
         VisibilityEventHandler *visibilityEventHandler = _getVisibilityEventHandler();
@@ -659,6 +689,7 @@ namespace fcn
         }
         
         mVisible = visible;
+        requestRedraw();
     }
 
     bool Widget::isVisible() const
@@ -676,6 +707,7 @@ namespace fcn
     void Widget::setBaseColor(const Color& color)
     {
         mBaseColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getBaseColor() const
@@ -686,6 +718,7 @@ namespace fcn
     void Widget::setForegroundColor(const Color& color)
     {
         mForegroundColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getForegroundColor() const
@@ -696,6 +729,7 @@ namespace fcn
     void Widget::setBackgroundColor(const Color& color)
     {
         mBackgroundColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getBackgroundColor() const
@@ -706,6 +740,7 @@ namespace fcn
     void Widget::setSelectionColor(const Color& color)
     {
         mSelectionColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getSelectionColor() const
@@ -716,6 +751,7 @@ namespace fcn
     void Widget::setOutlineColor(const Color& color)
     {
         mOutlineColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getOutlineColor() const
@@ -726,6 +762,7 @@ namespace fcn
     void Widget::setBorderColor(const Color& color)
     {
         mBorderColor = color;
+        requestRedraw();
     }
 
     const Color& Widget::getBorderColor() const
@@ -736,6 +773,7 @@ namespace fcn
     void Widget::setSelectionMode(SelectionMode mode)
     {
         mSelectionMode = mode;
+        requestRedraw();
     }
     
     Widget::SelectionMode Widget::getSelectionMode() const
@@ -907,6 +945,7 @@ namespace fcn
     {
         mCurrentFont = font;
         fontChanged();
+        requestRedraw();
     }
 
     bool Widget::widgetExists(const Widget* widget)
@@ -953,6 +992,7 @@ namespace fcn
     void Widget::setEnabled(bool enabled)
     {
         mEnabled = enabled;
+        requestRedraw();
     }
 
     bool Widget::isEnabled() const
@@ -1402,6 +1442,12 @@ namespace fcn
         mChildren.push_front(widget);
     }
 
+    void Widget::redrawChild(Widget* widget)
+    {
+        if (mParent != NULL)
+            mParent->redrawChild(this);
+    }
+
     void Widget::focusNext()
     {
         std::list<Widget*>::const_iterator iter;
@@ -1479,20 +1525,25 @@ namespace fcn
         draw(graphics);
 
         if (!mChildren.empty()) {
-            const Rectangle& childrenArea = getChildrenArea();
-            graphics->pushClipArea(childrenArea);
+            drawChildren(graphics);
+        }
+        graphics->popClipArea();
+    }
 
-            std::list<Widget*>::const_iterator iter;
-            for (iter = mChildren.begin(); iter != mChildren.end(); iter++)
-            {
-                Widget* widget = (*iter);
-                // Only draw a widget if it's visible and if it visible
-                // inside the children area.
-                //if (widget->isVisible() && childrenArea.isIntersecting(widget->getDimension()))
-                if (widget->isVisible())
-                    widget->_draw(graphics);
-            }
-            graphics->popClipArea();
+    void Widget::drawChildren(Graphics* graphics)
+    {
+        const Rectangle& childrenArea = getChildrenArea();
+        graphics->pushClipArea(childrenArea);
+
+        std::list<Widget*>::const_iterator iter;
+        for (iter = mChildren.begin(); iter != mChildren.end(); iter++)
+        {
+            Widget* widget = (*iter);
+            // Only draw a widget if it's visible and if it visible
+            // inside the children area.
+            //if (widget->isVisible() && childrenArea.isIntersecting(widget->getDimension()))
+            if (widget->isVisible())
+                widget->_draw(graphics);
         }
         graphics->popClipArea();
     }
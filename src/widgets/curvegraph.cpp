@@ -22,6 +22,7 @@
 #include <algorithm>
 
 #include <fifechan/exception.hpp>
+#include <fifechan/graphdatasource.hpp>
 #include <fifechan/graphics.hpp>
 #include <fifechan/util/fcn_math.hpp>
 #include <fifechan/widgets/curvegraph.hpp>
@@ -33,21 +34,39 @@ namespace fcn {
         m_opaque(false),
         m_acp(true),
         m_needUpdate(false),
+        m_decimation(true),
         m_thickness(1),
-        m_data() {
+        m_data(),
+        m_tessellatedPoints(0),
+        m_source(NULL),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
     }
 
     CurveGraph::CurveGraph(const PointVector& data):
         m_opaque(false),
         m_acp(true),
         m_needUpdate(true),
+        m_decimation(true),
         m_thickness(1),
-        m_data(data) {
+        m_data(data),
+        m_tessellatedPoints(0),
+        m_source(NULL),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
+    }
+
+    CurveGraph::~CurveGraph() {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
     }
 
     void CurveGraph::setPointVector(const PointVector& data) {
         m_needUpdate = true;
+        m_tessellatedPoints = 0;
         m_data = data;
+        m_pyramid.clear();
     }
 
     const PointVector& CurveGraph::getPointVector() const {
@@ -56,11 +75,38 @@ namespace fcn {
 
     void CurveGraph::resetPointVector() {
         m_needUpdate = true;
+        m_tessellatedPoints = 0;
         m_data.clear();
+        m_pyramid.clear();
+    }
+
+    void CurveGraph::addPoint(const Point& point) {
+        m_needUpdate = true;
+        m_data.push_back(point);
+    }
+
+    void CurveGraph::setDataSource(GraphDataSource* source) {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
+        m_needUpdate = true;
+        m_tessellatedPoints = 0;
+        m_source = source;
+        m_sourceStart = 0;
+        m_sourceEnd = 0;
+        m_sourceData.clear();
+        if (m_source) {
+            m_source->addGraphDataListener(this);
+        }
+    }
+
+    GraphDataSource* CurveGraph::getDataSource() const {
+        return m_source;
     }
 
     void CurveGraph::setThickness(unsigned int thickness) {
         m_needUpdate = true;
+        m_tessellatedPoints = 0;
         m_thickness = thickness;
     }
 
@@ -70,6 +116,8 @@ namespace fcn {
 
     void CurveGraph::setAutomaticControllPoints(bool acp) {
         m_needUpdate = true;
+        m_tessellatedPoints = 0;
+
         m_acp = acp;
     }
 
@@ -77,6 +125,16 @@ namespace fcn {
         return m_acp;
     }
 
+    void CurveGraph::setDecimationEnabled(bool decimation) {
+        m_needUpdate = true;
+        m_tessellatedPoints = 0;
+        m_decimation = decimation;
+    }
+
+    bool CurveGraph::isDecimationEnabled() const {
+        return m_decimation;
+    }
+
     void CurveGraph::setOpaque(bool opaque) {
         m_opaque = opaque;
     }
@@ -119,175 +177,172 @@ namespace fcn {
     }
 
     void CurveGraph::update() {
-        // calc steps and bezier points
-        m_curveData.clear();
-        if (m_data.size() < 2) {
-            return;
-        }
-        float distance = 0;
-        PointVector newPoints;
-        if (m_acp) {
-            addControlPoints(m_data, newPoints);
-        } else {
-            newPoints = m_data;
-        }
-        int elements = newPoints.size();
-
-        std::vector<Point>::const_iterator it = newPoints.begin();
-        Point old = *it;
-        ++it;
-        for (; it != newPoints.end(); ++it) {
-            const Point& next = *it;
-            float rx = static_cast<float>(old.x - next.x);
-            float ry = static_cast<float>(old.y - next.y);
-            old = next;
-            distance += Mathf::Sqrt(rx*rx + ry*ry);
+        const PointVector* data = &m_data;
+        PointVector window;
+        if (m_source) {
+            // a data source is drawn from the start of its window
+            m_source->updateWindowPoints(m_sourceData, m_sourceStart, m_sourceEnd);
+            window.reserve(m_sourceData.size());
+            for (PointVector::const_iterator it = m_sourceData.begin(); it != m_sourceData.end(); ++it) {
+                window.push_back(Point((*it).x - m_sourceStart, (*it).y));
+            }
+            data = &window;
+        } else if (m_decimation && m_data.size() >= 2) {
+            // with many points per pixel column the curve is fitted through
+            // the extremes only
+            m_pyramid.update(m_data);
+            if (m_pyramid.decimate(m_data, m_decimated)) {
+                data = &m_decimated;
+            }
         }
-
-        int lines = static_cast<int>(ceil((distance / elements) / m_thickness));
-        if (lines < 2) {
-            lines = 2;
+        if (data->size() < 2) {
+            m_curveData.clear();
+            m_segmentStarts.clear();
+            m_tessellatedPoints = 0;
+            return;
         }
-
-        float step = 1.0f / static_cast<float>(lines-1);
-        float t = 0.0;
-        m_curveData.push_back(getBezierPoint(newPoints, newPoints.size()+1, t));
-        for (int i = 0; i <= (elements*lines); ++i) {
-            t += step;
-            m_curveData.push_back(getBezierPoint(newPoints, newPoints.size(), t));
+        // appended points only change the segments at the end, a
+        // catmull-rom segment depends on the two points after its start
+        unsigned int firstSegment = 0;
+        bool appended = data == &m_data && m_tessellatedPoints >= 2 && m_data.size() >= m_tessellatedPoints;
+        if (appended) {
+            firstSegment = m_acp ? m_tessellatedPoints - 2 : (m_tessellatedPoints - 1) / 3;
         }
+        tessellate(*data, firstSegment);
+        m_tessellatedPoints = data == &m_data ? m_data.size() : 0;
         m_needUpdate = false;
     }
 
-    Point CurveGraph::getBezierPoint(const PointVector& points, int elements, float t) {
-        if (t < 0.0) {
-            return points[0];
-        } else if (t >= static_cast<double>(elements)) {
-            return points.back();
-        }
-
-        // Interpolate
-        double px = 0.0;
-        double py = 0.0;
-        int n = elements - 1;
-        double muk = 1.0;
-        double mu = static_cast<double>(t) / static_cast<double>(elements);
-        double munk = Mathd::Pow(1.0 - mu, static_cast<double>(n));
-        for (int i = 0; i <= n; ++i) {
-            int tmpn = n;
-            int tmpi = i;
-            int diffn = n - i;
-            double blend = muk * munk;
-            muk *= mu;
-            munk /= 1.0 - mu;
-            while (tmpn) {
-                blend *= static_cast<double>(tmpn);
-                tmpn--;
-                if (tmpi > 1) {
-                    blend /= static_cast<double>(tmpi);
-                    tmpi--;
-                }
-                if (diffn > 1) {
-                    blend /= static_cast<double>(diffn);
-                    diffn--;
-                }
-            }
-            px += static_cast<double>(points[i].x) * blend;
-            py += static_cast<double>(points[i].y) * blend;
-        }
+    void CurveGraph::pointsAppended(GraphDataSource* source, int count) {
+        m_needUpdate = true;
+    }
 
-        return Point(static_cast<int>(px), static_cast<int>(py));
+    void CurveGraph::pointsRemoved(GraphDataSource* source, int count) {
+        m_needUpdate = true;
     }
 
-    void CurveGraph::addControlPoints(const PointVector& points, PointVector& newPoints) {
-        if (points.empty()) {
-            return;
-        }
+    void CurveGraph::windowChanged(GraphDataSource* source) {
+        m_needUpdate = true;
+    }
 
-        int n = points.size() - 1;
-        // min 2 points
-        if (n < 1) {
-            return;
+    void CurveGraph::graphDataSourceDeleted(GraphDataSource* source) {
+        if (source == m_source) {
+            m_needUpdate = true;
+            m_source = NULL;
+            m_sourceData.clear();
         }
+    }
 
-        Point p;
-        // straight line
-        if (n == 1) {
-            newPoints.push_back(points[0]);
-            p.x = (2 * points[0].x + points[1].x) / 3;
-            p.y = (2 * points[0].y + points[1].y) / 3;
-            newPoints.push_back(p);
-            p.x = 2 * p.x - points[0].x;
-            p.y = 2 * p.y - points[0].y;
-            newPoints.push_back(p);
-            newPoints.push_back(points[1]);
-            return;
+    void CurveGraph::tessellate(const PointVector& points, unsigned int firstSegment) {
+        if (firstSegment < m_segmentStarts.size()) {
+            m_curveData.resize(m_segmentStarts[firstSegment]);
+            m_segmentStarts.resize(firstSegment);
+        } else if (firstSegment == 0 || firstSegment > m_segmentStarts.size()) {
+            firstSegment = 0;
+            m_curveData.clear();
+            m_segmentStarts.clear();
         }
 
-        // calculate x and y values
-        float* xrhs = new float[n];
-        float* yrhs = new float[n];
-        // first
-        xrhs[0] = static_cast<float>(points[0].x + 2 * points[1].x);
-        yrhs[0] = static_cast<float>(points[0].y + 2 * points[1].y);
-        // last
-        xrhs[n - 1] = static_cast<float>((8 * points[n - 1].x + points[n].x) / 2.0f);
-        yrhs[n - 1] = static_cast<float>((8 * points[n - 1].y + points[n].y) / 2.0f);
-        // rest
-        for (int i = 1; i < n - 1; ++i) {
-            xrhs[i] = static_cast<float>(4 * points[i].x + 2 * points[i + 1].x);
-            yrhs[i] = static_cast<float>(4 * points[i].y + 2 * points[i + 1].y);
+        int n = points.size();
+        double x[4];
+        double y[4];
+        if (m_acp) {
+            // catmull-rom segment from point i to i + 1, as a cubic bezier,
+            // with the end points repeated
+            for (int i = firstSegment; i < n - 1; ++i) {
+                const Point& p0 = points[std::max(i - 1, 0)];
+                const Point& p1 = points[i];
+                const Point& p2 = points[i + 1];
+                const Point& p3 = points[std::min(i + 2, n - 1)];
+                x[0] = p1.x;
+                y[0] = p1.y;
+                x[1] = p1.x + (p2.x - p0.x) / 6.0;
+                y[1] = p1.y + (p2.y - p0.y) / 6.0;
+                x[2] = p2.x - (p3.x - p1.x) / 6.0;
+                y[2] = p2.y - (p3.y - p1.y) / 6.0;
+                x[3] = p2.x;
+                y[3] = p2.y;
+                m_segmentStarts.push_back(m_curveData.size());
+                addSegment(x, y, i == 0);
+            }
+        } else {
+            // bezier segments from point 3i to 3i + 3, a shorter last
+            // segment is raised to a cubic one
+            for (int i = 3 * firstSegment; i < n - 1; i += 3) {
+                int rest = std::min(n - 1 - i, 3);
+                const Point& p0 = points[i];
+                const Point& p1 = points[i + 1];
+                const Point& pn = points[i + rest];
+                x[0] = p0.x;
+                y[0] = p0.y;
+                x[3] = pn.x;
+                y[3] = pn.y;
+                if (rest == 3) {
+                    x[1] = p1.x;
+                    y[1] = p1.y;
+                    x[2] = points[i + 2].x;
+                    y[2] = points[i + 2].y;
+                } else if (rest == 2) {
+                    x[1] = p0.x + 2.0 * (p1.x - p0.x) / 3.0;
+                    y[1] = p0.y + 2.0 * (p1.y - p0.y) / 3.0;
+                    x[2] = pn.x + 2.0 * (p1.x - pn.x) / 3.0;
+                    y[2] = pn.y + 2.0 * (p1.y - pn.y) / 3.0;
+                } else {
+                    x[1] = p0.x + (pn.x - p0.x) / 3.0;
+                    y[1] = p0.y + (pn.y - p0.y) / 3.0;
+                    x[2] = p0.x + 2.0 * (pn.x - p0.x) / 3.0;
+                    y[2] = p0.y + 2.0 * (pn.y - p0.y) / 3.0;
+                }
+                m_segmentStarts.push_back(m_curveData.size());
+                addSegment(x, y, i == 0);
+            }
         }
+    }
 
-        float* x = new float[n];
-        float* y = new float[n];
-        float* xtmp = new float[n];
-        float* ytmp = new float[n];
-        float xb = 2.0;
-        float yb = 2.0;
-        x[0] = xrhs[0] / xb;
-        y[0] = yrhs[0] / yb;
-        // Decomposition and forward substitution.
-        for (int i = 1; i < n; i++) {
-            xtmp[i] = 1 / xb;
-            ytmp[i] = 1 / yb;
-            xb = (i < n - 1 ? 4.0f : 3.5f) - xtmp[i];
-            yb = (i < n - 1 ? 4.0f : 3.5f) - ytmp[i];
-            x[i] = (xrhs[i] - x[i - 1]) / xb;
-            y[i] = (yrhs[i] - y[i - 1]) / yb;
+    void CurveGraph::addSegment(const double* x, const double* y, bool first) {
+        // about one line per two pixels of the control polygon per thickness
+        double length = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            double rx = x[i + 1] - x[i];
+            double ry = y[i + 1] - y[i];
+            length += Mathd::Sqrt(rx*rx + ry*ry);
         }
-        // Backward substitution
-        for (int i = 1; i < n; i++) {
-            x[n - i - 1] -= xtmp[n - i] * x[n - i];
-            y[n - i - 1] -= ytmp[n - i] * y[n - i];
+        int steps = static_cast<int>(ceil(length / (2.0 * std::max(m_thickness, 1u))));
+        steps = std::max(1, std::min(steps, 256));
+
+        // power basis coefficients, p(t) = a*t^3 + b*t^2 + c*t + d
+        double h = 1.0 / steps;
+        double h2 = h * h;
+        double h3 = h2 * h;
+        double fx = x[0];
+        double fy = y[0];
+        double ax = -x[0] + 3.0 * x[1] - 3.0 * x[2] + x[3];
+        double ay = -y[0] + 3.0 * y[1] - 3.0 * y[2] + y[3];
+        double bx = 3.0 * x[0] - 6.0 * x[1] + 3.0 * x[2];
+        double by = 3.0 * y[0] - 6.0 * y[1] + 3.0 * y[2];
+        double cx = 3.0 * (x[1] - x[0]);
+        double cy = 3.0 * (y[1] - y[0]);
+        // forward differences
+        double dx = ax * h3 + bx * h2 + cx * h;
+        double dy = ay * h3 + by * h2 + cy * h;
+        double ddx = 6.0 * ax * h3 + 2.0 * bx * h2;
+        double ddy = 6.0 * ay * h3 + 2.0 * by * h2;
+        double dddx = 6.0 * ax * h3;
+        double dddy = 6.0 * ay * h3;
+
+        if (first) {
+            m_curveData.push_back(Point(static_cast<int>(floor(fx + 0.5)), static_cast<int>(floor(fy + 0.5))));
         }
-
-        // start point
-        newPoints.push_back(points[0]);
-        for (int i = 0; i < n - 1; ++i) {
-            p.x = static_cast<int>(x[i]);
-            p.y = static_cast<int>(y[i]);
-            newPoints.push_back(p);
-            p.x = static_cast<int>(2 * points[i + 1].x - x[i + 1]);
-            p.y = static_cast<int>(2 * points[i + 1].y - y[i + 1]);
-            newPoints.push_back(p);
-
-            newPoints.push_back(points[i+1]);
+        for (int i = 1; i < steps; ++i) {
+            fx += dx;
+            fy += dy;
+            dx += ddx;
+            dy += ddy;
+            ddx += dddx;
+            ddy += dddy;
+            m_curveData.push_back(Point(static_cast<int>(floor(fx + 0.5)), static_cast<int>(floor(fy + 0.5))));
         }
-        p.x = static_cast<int>(x[n - 1]);
-        p.y = static_cast<int>(y[n - 1]);
-        newPoints.push_back(p);
-        p.x = static_cast<int>((points[n].x + x[n - 1]) / 2);
-        p.y = static_cast<int>((points[n].y + y[n - 1]) / 2);
-        newPoints.push_back(p);
-        // end point
-        newPoints.push_back(points[n]);
-
-        delete[] xrhs;
-        delete[] yrhs;
-        delete[] x;
-        delete[] y;
-        delete[] xtmp;
-        delete[] ytmp;
+        // end exactly at the last control point
+        m_curveData.push_back(Point(static_cast<int>(floor(x[3] + 0.5)), static_cast<int>(floor(y[3] + 0.5))));
     }
 };
\ No newline at end of file
@@ -64,17 +64,35 @@
 
 #include "fifechan/widgets/dropdown.hpp"
 
+#include <algorithm>
+
 #include "fifechan/exception.hpp"
 #include "fifechan/font.hpp"
 #include "fifechan/graphics.hpp"
 #include "fifechan/key.hpp"
 #include "fifechan/listmodel.hpp"
 #include "fifechan/mouseinput.hpp"
+#include "fifechan/util/utf8/utf8.hpp"
 #include "fifechan/widgets/listbox.hpp"
 #include "fifechan/widgets/scrollarea.hpp"
 
 namespace fcn
 {
+    static std::string toLowerAscii(const std::string& text)
+    {
+        std::string lower(text);
+
+        for (unsigned int i = 0; i < lower.size(); ++i)
+        {
+            if (lower[i] >= 'A' && lower[i] <= 'Z')
+            {
+                lower[i] = lower[i] - 'A' + 'a';
+            }
+        }
+
+        return lower;
+    }
+
     DropDown::DropDown(ListModel *listModel,
                        ScrollArea *scrollArea,
                        ListBox *listBox)
@@ -84,6 +102,8 @@ namespace fcn
         mDroppedDown = false;
         mPushed = false;
         mIsDragged = false;
+        mTypeAheadModel = NULL;
+        mPrefixIndexInvalid = true;
 
         setInternalFocusHandler(&mInternalFocusHandler);
 
@@ -125,6 +145,11 @@ namespace fcn
 
     DropDown::~DropDown()
     {
+        if (mTypeAheadModel != NULL)
+        {
+            mTypeAheadModel->removeListModelListener(this);
+        }
+
         if (widgetExists(mListBox))
         {
             mListBox->removeActionListener(this);
@@ -323,13 +348,120 @@ namespace fcn
         else if (key.getValue() == Key::Up)
         {
             setSelected(getSelected() - 1);
+            mTypeAheadPrefix.clear();
             keyEvent.consume();
         }
         else if (key.getValue() == Key::Down)
         {
             setSelected(getSelected() + 1);
+            mTypeAheadPrefix.clear();
             keyEvent.consume();
         }
+        else if (key.isCharacter() && key.getValue() != Key::Tab)
+        {
+            std::string text;
+            utf8::append(key.getValue(), std::back_inserter(text));
+            typeAhead(text);
+            keyEvent.consume();
+        }
+    }
+
+    void DropDown::typeAhead(const std::string& text)
+    {
+        if (getListModel() == NULL)
+        {
+            return;
+        }
+
+        updatePrefixIndex();
+
+        typedef std::vector<std::pair<std::string, int> >::iterator IndexIterator;
+
+        std::string character = toLowerAscii(text);
+        std::string prefix = mTypeAheadPrefix + character;
+        IndexIterator match = std::lower_bound(mPrefixIndex.begin(),
+                                               mPrefixIndex.end(),
+                                               std::make_pair(prefix, -1));
+
+        if (match == mPrefixIndex.end() || match->first.compare(0, prefix.size(), prefix) != 0)
+        {
+            prefix = character;
+            match = std::lower_bound(mPrefixIndex.begin(),
+                                     mPrefixIndex.end(),
+                                     std::make_pair(prefix, -1));
+
+            if (match == mPrefixIndex.end() || match->first.compare(0, prefix.size(), prefix) != 0)
+            {
+                mTypeAheadPrefix.clear();
+                return;
+            }
+
+            // Typing the same character again moves to the next item
+            // starting with it.
+            if (mTypeAheadPrefix == character && getSelected() >= 0)
+            {
+                std::pair<std::string, int> selected(toLowerAscii(getListModel()->getElementAt(getSelected())),
+                                                     getSelected());
+                IndexIterator next = std::upper_bound(mPrefixIndex.begin(), mPrefixIndex.end(), selected);
+
+                if (next != mPrefixIndex.end() && next->first.compare(0, prefix.size(), prefix) == 0)
+                {
+                    match = next;
+                }
+            }
+        }
+
+        mTypeAheadPrefix = prefix;
+        setSelected(match->second);
+    }
+
+    void DropDown::updatePrefixIndex()
+    {
+        ListModel* listModel = getListModel();
+        int elements = listModel->getNumberOfElements();
+
+        // Models which don't send notifications still change size.
+        if (!mPrefixIndexInvalid && (int)mPrefixIndex.size() == elements)
+        {
+            return;
+        }
+
+        mPrefixIndex.resize(elements);
+
+        for (int i = 0; i < elements; ++i)
+        {
+            const std::string* element = listModel->getElementPointer(i);
+            mPrefixIndex[i].first = toLowerAscii(element != NULL ? *element : listModel->getElementAt(i));
+            mPrefixIndex[i].second = i;
+        }
+
+        std::sort(mPrefixIndex.begin(), mPrefixIndex.end());
+        mPrefixIndexInvalid = false;
+    }
+
+    void DropDown::elementsInserted(ListModel* model, int first, int count)
+    {
+        mPrefixIndexInvalid = true;
+    }
+
+    void DropDown::elementsRemoved(ListModel* model, int first, int count)
+    {
+        mPrefixIndexInvalid = true;
+    }
+
+    void DropDown::elementsChanged(ListModel* model, int first, int count)
+    {
+        mPrefixIndexInvalid = true;
+    }
+
+    void DropDown::listModelDeleted(ListModel* model)
+    {
+        if (model == mTypeAheadModel)
+        {
+            mTypeAheadModel = NULL;
+        }
+
+        mPrefixIndexInvalid = true;
     }
 
     void DropDown::mousePressed(MouseEvent& mouseEvent)
@@ -410,6 +542,20 @@ namespace fcn
 
     void DropDown::setListModel(ListModel *listModel)
     {
+        if (mTypeAheadModel != NULL)
+        {
+            mTypeAheadModel->removeListModelListener(this);
+        }
+
+        mTypeAheadModel = listModel;
+        mTypeAheadPrefix.clear();
+        mPrefixIndexInvalid = true;
+
+        if (mTypeAheadModel != NULL)
+        {
+            mTypeAheadModel->addListModelListener(this);
+        }
+
         mListBox->setListModel(listModel);
 
         adjustHeight();
@@ -509,7 +655,9 @@ namespace fcn
 
     void DropDown::focusLost(const Event& event)
     {
+        mTypeAheadPrefix.clear();
         foldUp();
+
         mInternalFocusHandler.focusNone();
     }
 
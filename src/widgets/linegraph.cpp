@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 #include <fifechan/exception.hpp>
+#include <fifechan/graphdatasource.hpp>
 #include <fifechan/graphics.hpp>
 #include <fifechan/widgets/linegraph.hpp>
 
@@ -28,18 +29,35 @@ namespace fcn {
 
     LineGraph::LineGraph():
         m_opaque(false),
+        m_decimation(true),
         m_thickness(1),
-        m_data() {
+        m_data(),
+        m_source(NULL),
+        m_sourceChanged(false),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
     }
 
     LineGraph::LineGraph(const PointVector& data):
         m_opaque(false),
+        m_decimation(true),
         m_thickness(1),
-        m_data(data) {
+        m_data(data),
+        m_source(NULL),
+        m_sourceChanged(false),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
+    }
+
+    LineGraph::~LineGraph() {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
     }
 
     void LineGraph::setPointVector(const PointVector& data) {
         m_data = data;
+        m_pyramid.clear();
     }
 
     const PointVector& LineGraph::getPointVector() const {
@@ -48,6 +66,29 @@ namespace fcn {
 
     void LineGraph::resetPointVector() {
         m_data.clear();
+        m_pyramid.clear();
+    }
+
+    void LineGraph::addPoint(const Point& point) {
+        m_data.push_back(point);
+    }
+
+    void LineGraph::setDataSource(GraphDataSource* source) {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
+        m_source = source;
+        m_sourceChanged = true;
+        m_sourceStart = 0;
+        m_sourceEnd = 0;
+        m_sourceData.clear();
+        if (m_source) {
+            m_source->addGraphDataListener(this);
+        }
+    }
+
+    GraphDataSource* LineGraph::getDataSource() const {
+        return m_source;
     }
 
     void LineGraph::setThickness(unsigned int thickness) {
@@ -58,6 +99,14 @@ namespace fcn {
         return m_thickness;
     }
 
+    void LineGraph::setDecimationEnabled(bool decimation) {
+        m_decimation = decimation;
+    }
+
+    bool LineGraph::isDecimationEnabled() const {
+        return m_decimation;
+    }
+
     void LineGraph::setOpaque(bool opaque) {
         m_opaque = opaque;
     }
@@ -88,27 +137,45 @@ namespace fcn {
             }
         }
 
-        if (m_data.empty()) {
+        // a data source is drawn from the start of its window
+        const PointVector* data = &m_data;
+        int offset = 0;
+        if (m_source) {
+            if (m_sourceChanged) {
+                m_source->updateWindowPoints(m_sourceData, m_sourceStart, m_sourceEnd);
+                m_sourceChanged = false;
+            }
+            data = &m_sourceData;
+            offset = m_sourceStart;
+        } else if (m_decimation && !m_data.empty()) {
+            // with many points per pixel column only the extremes are drawn
+            m_pyramid.update(m_data);
+            if (m_pyramid.decimate(m_data, m_decimated)) {
+                data = &m_decimated;
+            }
+        }
+        if (data->empty()) {
             return;
         }
         // draw lines
         graphics->setColor(getBaseColor());
         bool thick = m_thickness > 1;
-        PointVector::iterator pit = m_data.begin();
-        int x1 = (*pit).x;
+        PointVector::const_iterator pit = data->begin();
+        int x1 = (*pit).x - offset;
         int y1 = (*pit).y;
         ++pit;
         if (thick) {
-            for (; pit != m_data.end(); ++pit) {
-                int x2 = (*pit).x;
+            for (; pit != data->end(); ++pit) {
+                int x2 = (*pit).x - offset;
                 int y2 = (*pit).y;
                 graphics->drawLine(x1, y1, x2, y2, m_thickness);
                 x1 = x2;
                 y1 = y2;
             }
         } else {
-            for (; pit != m_data.end(); ++pit) {
-                int x2 = (*pit).x;
+            for (; pit != data->end(); ++pit) {
+
+                int x2 = (*pit).x - offset;
                 int y2 = (*pit).y;
                 graphics->drawLine(x1, y1, x2, y2);
                 x1 = x2;
@@ -117,4 +184,23 @@ namespace fcn {
         }
     }
 
+    void LineGraph::pointsAppended(GraphDataSource* source, int count) {
+        m_sourceChanged = true;
+    }
+
+    void LineGraph::pointsRemoved(GraphDataSource* source, int count) {
+        m_sourceChanged = true;
+    }
+
+    void LineGraph::windowChanged(GraphDataSource* source) {
+        m_sourceChanged = true;
+    }
+
+    void LineGraph::graphDataSourceDeleted(GraphDataSource* source) {
+        if (source == m_source) {
+            m_source = NULL;
+            m_sourceData.clear();
+        }
+    }
+
 };
\ No newline at end of file
@@ -67,6 +67,7 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "fifechan/widgets/listbox.hpp"
 
@@ -81,11 +82,17 @@ namespace fcn
 {
     ListBox::ListBox()
         : mSelected(-1),
+          mAnchor(-1),
+          mMultipleSelection(false),
           mListModel(NULL),
-          mWrappingEnabled(false)
+          mWrappingEnabled(false),
+          mVirtualized(false),
+          mAdjustedElements(-1),
+          mFirstCachedRow(0)
     {
         setWidth(100);
         setFocusable(true);
+        setRedrawRequesting(true);
 
         addMouseListener(this);
         addKeyListener(this);
@@ -93,16 +100,31 @@ namespace fcn
 
     ListBox::ListBox(ListModel *listModel)
         : mSelected(-1),
-          mWrappingEnabled(false)
+          mAnchor(-1),
+          mMultipleSelection(false),
+          mListModel(NULL),
+          mWrappingEnabled(false),
+          mVirtualized(false),
+          mAdjustedElements(-1),
+          mFirstCachedRow(0)
     {
         setWidth(100);
         setListModel(listModel);
         setFocusable(true);
+        setRedrawRequesting(true);
 
         addMouseListener(this);
         addKeyListener(this);
     }
 
+    ListBox::~ListBox()
+    {
+        if (mListModel != NULL)
+        {
+            mListModel->removeListModelListener(this);
+        }
+    }
+
     void ListBox::draw(Graphics* graphics)
     {
         graphics->setColor(getBackgroundColor());
@@ -117,43 +139,38 @@ namespace fcn
         graphics->setFont(getFont());
          
         // Check the current clip area so we don't draw unnecessary items
-        // that are not visible.
-        const ClipRectangle currentClipArea = graphics->getCurrentClipArea();
+        // that are not visible. The clip area is in screen coordinates,
+        // its offset is where the list box is on the screen.
+        const ClipRectangle& currentClipArea = graphics->getCurrentClipArea();
         int rowHeight = getRowHeight();
-        
-        // Calculate the number of rows to draw by checking the clip area.
-        // The addition of two makes covers a partial visible row at the top
-        // and a partial visible row at the bottom.
-        int numberOfRows = currentClipArea.height / rowHeight + 2;
+        int top = currentClipArea.y - currentClipArea.yOffset;
+        int bottom = top + currentClipArea.height;
+
+        int startRow = top > 0 ? top / rowHeight : 0;
+        int endRow = bottom > 0 ? bottom / rowHeight + 1 : 0;
 
-        if (numberOfRows > mListModel->getNumberOfElements())
+        if (endRow > mListModel->getNumberOfElements())
         {
-            numberOfRows = mListModel->getNumberOfElements();
+            endRow = mListModel->getNumberOfElements();
         }
 
-        // Calculate which row to start drawing. If the list box 
-        // has a negative y coordinate value we should check if
-        // we should drop rows in the begining of the list as
-        // they might not be visible. A negative y value is very
-        // common if the list box for instance resides in a scroll
-        // area and the user has scrolled the list box downwards.
-        int startRow;    	
-        if (getY() < 0)
+        if (startRow > endRow)
         {
-            startRow = -1 * (getY() / rowHeight);
+            startRow = endRow;
         }
-        else
+
+        if (mVirtualized)
         {
-            startRow = 0;
+            updateRowCache(startRow, endRow);
         }
 
         int i;
         // The y coordinate where we start to draw the text is
         // simply the y coordinate multiplied with the font height.
         int y = rowHeight * startRow;
-        for (i = startRow; i < startRow + numberOfRows; ++i)
+        for (i = startRow; i < endRow; ++i)
         {
-            if (i == mSelected)
+            if (mSelection.contains(i))
             {
                 graphics->setColor(getSelectionColor());
                 graphics->fillRectangle(0, y, getWidth(), rowHeight);
@@ -164,11 +181,11 @@ namespace fcn
             // draw the text with a center vertical alignment.
             if (rowHeight > getFont()->getHeight())
             {
-                graphics->drawText(mListModel->getElementAt(i), 1, y + rowHeight / 2 - getFont()->getHeight() / 2);
+                graphics->drawText(getRowElement(i), 1, y + rowHeight / 2 - getFont()->getHeight() / 2);
             }
             else
             {
-                graphics->drawText(mListModel->getElementAt(i), 1, y);
+                graphics->drawText(getRowElement(i), 1, y);
             }
 
             y += rowHeight;
@@ -177,7 +194,13 @@ namespace fcn
 
     void ListBox::logic()
     {
-        adjustSize();
+        // A virtualized list box is told about changes by its model, so
+        // it only has to check that the number of elements is the same.
+        if (!mVirtualized
+            || (mListModel != NULL && mListModel->getNumberOfElements() != mAdjustedElements))
+        {
+            adjustSize();
+        }
     }
 
     int ListBox::getSelected() const
@@ -187,41 +210,115 @@ namespace fcn
 
     void ListBox::setSelected(int selected)
     {
+        int index;
+
         if (mListModel == NULL)
         {
-            mSelected = -1;
+            index = -1;
         }
         else
         {
             if (selected < 0)
             {
-                mSelected = -1;
+                index = -1;
             }
             else if (selected >= mListModel->getNumberOfElements())
             {
-                mSelected = mListModel->getNumberOfElements() - 1;
+                index = mListModel->getNumberOfElements() - 1;
             }
             else
             {
-                mSelected = selected;
+                index = selected;
             }
         }
-        
-        Rectangle scroll;
 
-        if (mSelected < 0)
+        changeSelection(index, index, index >= 0 ? 1 : 0, false);
+        mAnchor = index;
+        showRow(index);
+    }
+
+    void ListBox::setMultipleSelectionEnabled(bool enabled)
+    {
+        mMultipleSelection = enabled;
+
+        // Only the lead item stays selected.
+        if (!enabled
+            && (mSelection.getSize() != (mSelected >= 0 ? 1 : 0)
+                || (mSelected >= 0 && !mSelection.contains(mSelected))))
         {
-            scroll.y = 0;
+            changeSelection(mSelected, mSelected, mSelected >= 0 ? 1 : 0, false);
+        }
+    }
+
+    bool ListBox::isMultipleSelectionEnabled() const
+    {
+        return mMultipleSelection;
+    }
+
+    bool ListBox::isSelected(int index) const
+    {
+        return mSelection.contains(index);
+    }
+
+    const RangeSet& ListBox::getSelection() const
+    {
+        return mSelection;
+    }
+
+    void ListBox::setRangeSelected(int first, int count, bool selected)
+    {
+        if (mListModel == NULL)
+        {
+            return;
+        }
+
+        int last = std::min(first + count, mListModel->getNumberOfElements());
+        first = std::max(first, 0);
+
+        if (first >= last)
+        {
+            return;
+        }
+
+        if (!mMultipleSelection)
+        {
+            if (selected)
+            {
+                setSelected(first);
+            }
+            else if (mSelected >= first && mSelected < last)
+            {
+                clearSelection();
+            }
+
+            return;
+        }
+
+        if (selected)
+        {
+            mSelection.add(first, last - first);
         }
         else
         {
-            scroll.y = getRowHeight() * mSelected;
+            mSelection.remove(first, last - first);
+            updateLead();
         }
 
-        scroll.height = getRowHeight();
-        showPart(scroll);
+        distributeValueChangedEvent(first, last - first);
+    }
+
+    void ListBox::selectAll()
+    {
+        if (mMultipleSelection && mListModel != NULL)
+        {
+            changeSelection(mSelected, 0, mListModel->getNumberOfElements(), true);
+        }
+    }
 
-        distributeValueChangedEvent();
+    void ListBox::clearSelection()
+    {
+        changeSelection(-1, 0, 0, false);
+        mAnchor = -1;
     }
 
     void ListBox::keyPressed(KeyEvent& keyEvent)
@@ -235,19 +332,21 @@ namespace fcn
         }
         else if (key.getValue() == Key::Up)
         {
-            setSelected(mSelected - 1);
-
-            if (mSelected == -1)
+            if (mSelected - 1 < 0)
             {
                 if (mWrappingEnabled)
                 {
-                    setSelected(getListModel()->getNumberOfElements() - 1);
+                    moveSelection(getListModel()->getNumberOfElements() - 1, keyEvent);
                 }
                 else
                 {
-                    setSelected(0);
+                    moveSelection(0, keyEvent);
                 }
             }
+            else
+            {
+                moveSelection(mSelected - 1, keyEvent);
+            }
             
             keyEvent.consume();
         }
@@ -256,23 +355,30 @@ namespace fcn
             if (mWrappingEnabled
                 && getSelected() == getListModel()->getNumberOfElements() - 1)
             {
-                setSelected(0);
+                moveSelection(0, keyEvent);
             }
             else
             {
-                setSelected(getSelected() + 1);
+                moveSelection(getSelected() + 1, keyEvent);
             }
             
             keyEvent.consume();
         }
         else if (key.getValue() == Key::Home)
         {
-            setSelected(0);
+            moveSelection(0, keyEvent);
             keyEvent.consume();
         }
         else if (key.getValue() == Key::End)
         {
-            setSelected(getListModel()->getNumberOfElements() - 1);
+            moveSelection(getListModel()->getNumberOfElements() - 1, keyEvent);
+            keyEvent.consume();
+        }
+        else if (mMultipleSelection
+                 && keyEvent.isControlPressed()
+                 && (key.getValue() == 'a' || key.getValue() == 'A'))
+        {
+            selectAll();
             keyEvent.consume();
         }
     }
@@ -281,7 +387,35 @@ namespace fcn
     {
         if (mouseEvent.getButton() == MouseEvent::Left)
         {
-            setSelected(mouseEvent.getY() / getRowHeight());
+            int row = mouseEvent.getY() / getRowHeight();
+
+            if (mMultipleSelection
+                && mListModel != NULL
+                && row < mListModel->getNumberOfElements()
+                && (mouseEvent.isControlPressed() || mouseEvent.isShiftPressed()))
+            {
+                if (mouseEvent.isShiftPressed() && mAnchor >= 0)
+                {
+                    // Control and shift adds the range to the selection.
+                    changeSelection(row,
+                                    std::min(mAnchor, row),
+                                    std::abs(row - mAnchor) + 1,
+                                    mouseEvent.isControlPressed());
+                }
+                else
+                {
+                    mSelection.toggle(row);
+                    mSelected = row;
+                    mAnchor = row;
+                    updateLead();
+                    distributeValueChangedEvent(row, 1);
+                }
+            }
+            else
+            {
+                setSelected(row);
+            }
+
             distributeActionEvent();
         }
     }
@@ -316,9 +450,24 @@ namespace fcn
 
     void ListBox::setListModel(ListModel *listModel)
     {
+        if (mListModel != NULL)
+        {
+            mListModel->removeListModelListener(this);
+        }
+
         mSelected = -1;
+        mAnchor = -1;
+        mSelection.clear();
         mListModel = listModel;
+        mCachedRows.clear();
+
+        if (mListModel != NULL)
+        {
+            mListModel->addListModelListener(this);
+        }
+
         adjustSize();
+        requestRedraw();
     }
 
     ListModel* ListBox::getListModel() const
@@ -334,15 +483,21 @@ namespace fcn
     {
         if (mListModel != NULL)
         {
-            // min width in case the lit contains no element
-            int w = getRowHeight();
             int elements = mListModel->getNumberOfElements();
-            for (int i = 0; i < elements; ++i) {
-                //std::string element = mListModel->getElementAt(i);
-                w = std::max(w, getFont()->getWidth(mListModel->getElementAt(i)));
+
+            // A virtualized list box keeps the width set by the user.
+            if (!mVirtualized)
+            {
+                // min width in case the lit contains no element
+                int w = getRowHeight();
+                for (int i = 0; i < elements; ++i) {
+                    w = std::max(w, getFont()->getWidth(getRowElement(i)));
+                }
+                setWidth(w);
             }
-            setWidth(w);
-            setHeight(getRowHeight() * mListModel->getNumberOfElements());
+
+            setHeight(getRowHeight() * elements);
+            mAdjustedElements = elements;
         }
     }
 
@@ -355,6 +510,19 @@ namespace fcn
     {
         mWrappingEnabled = wrappingEnabled;
     }
+
+    void ListBox::setVirtualized(bool virtualized)
+    {
+        mVirtualized = virtualized;
+        mCachedRows.clear();
+        mAdjustedElements = -1;
+        requestRedraw();
+    }
+
+    bool ListBox::isVirtualized() const
+    {
+        return mVirtualized;
+    }
         
     void ListBox::addSelectionListener(SelectionListener* selectionListener)
     {
@@ -366,13 +534,96 @@ namespace fcn
         mSelectionListeners.remove(selectionListener);
     }
 
-    void ListBox::distributeValueChangedEvent()
+    void ListBox::changeSelection(int lead, int first, int count, bool extend)
+    {
+        int changedFirst = first;
+        int changedLast = first + std::max(count, 0);
+
+        if (!extend && !mSelection.isEmpty())
+        {
+            RangeSet::const_iterator last = mSelection.end();
+            --last;
+
+            if (changedFirst >= changedLast)
+            {
+                changedFirst = mSelection.begin()->first;
+                changedLast = last->second;
+            }
+            else
+            {
+                changedFirst = std::min(changedFirst, mSelection.begin()->first);
+                changedLast = std::max(changedLast, last->second);
+            }
+
+            mSelection.clear();
+        }
+
+        mSelection.add(first, count);
+        mSelected = lead;
+
+        if (changedFirst >= changedLast)
+        {
+            distributeValueChangedEvent(0, 0);
+        }
+        else
+        {
+            distributeValueChangedEvent(changedFirst, changedLast - changedFirst);
+        }
+    }
+
+    void ListBox::moveSelection(int index, KeyEvent& keyEvent)
+    {
+        if (!mMultipleSelection
+            || !keyEvent.isShiftPressed()
+            || mAnchor < 0
+            || mListModel == NULL
+            || mListModel->getNumberOfElements() == 0)
+        {
+            setSelected(index);
+            return;
+        }
+
+        index = std::max(0, std::min(index, mListModel->getNumberOfElements() - 1));
+        changeSelection(index, std::min(mAnchor, index), std::abs(index - mAnchor) + 1, false);
+        showRow(index);
+    }
+
+    void ListBox::updateLead()
     {
+        if (mSelected >= 0 && mSelection.contains(mSelected))
+        {
+            return;
+        }
+
+        mSelected = mSelection.isEmpty() ? -1 : mSelection.begin()->first;
+    }
+
+    void ListBox::showRow(int row)
+    {
+        Rectangle scroll;
+
+        if (row < 0)
+        {
+            scroll.y = 0;
+        }
+        else
+        {
+            scroll.y = getRowHeight() * row;
+        }
+
+        scroll.height = getRowHeight();
+        showPart(scroll);
+    }
+
+    void ListBox::distributeValueChangedEvent(int first, int count)
+    {
+        requestRedraw();
+
         SelectionListenerIterator iter;
 
         for (iter = mSelectionListeners.begin(); iter != mSelectionListeners.end(); ++iter)
         {
-            SelectionEvent event(this);
+            SelectionEvent event(this, first, count);
             (*iter)->valueChanged(event);
         }
     }
@@ -381,4 +632,192 @@ namespace fcn
     {
         return getFont()->getHeight();
     }
+
+    const std::string& ListBox::getRowElement(int row)
+    {
+        const std::string* element = mListModel->getElementPointer(row);
+
+        if (element != NULL)
+        {
+            return *element;
+        }
+
+        if (mVirtualized)
+        {
+            CachedRow& cachedRow = mCachedRows[row - mFirstCachedRow];
+
+            if (!cachedRow.valid)
+            {
+                cachedRow.element = mListModel->getElementAt(row);
+                cachedRow.valid = true;
+            }
+
+            return cachedRow.element;
+        }
+
+        mRowElement = mListModel->getElementAt(row);
+        return mRowElement;
+    }
+
+    void ListBox::updateRowCache(int startRow, int endRow)
+    {
+        if (endRow <= mFirstCachedRow
+            || startRow >= mFirstCachedRow + (int)mCachedRows.size())
+        {
+            mCachedRows.clear();
+            mFirstCachedRow = startRow;
+        }
+
+        while (mFirstCachedRow < startRow)
+        {
+            mCachedRows.pop_front();
+            ++mFirstCachedRow;
+        }
+
+        while (mFirstCachedRow + (int)mCachedRows.size() > endRow)
+        {
+            mCachedRows.pop_back();
+        }
+
+        CachedRow invalidRow;
+        invalidRow.valid = false;
+
+        while (mFirstCachedRow > startRow)
+        {
+            mCachedRows.push_front(invalidRow);
+            --mFirstCachedRow;
+        }
+
+        while (mFirstCachedRow + (int)mCachedRows.size() < endRow)
+        {
+            mCachedRows.push_back(invalidRow);
+        }
+    }
+
+    void ListBox::truncateRowCache(int row)
+    {
+        if (row <= mFirstCachedRow)
+        {
+            mCachedRows.clear();
+        }
+        else if (row < mFirstCachedRow + (int)mCachedRows.size())
+        {
+            mCachedRows.resize(row - mFirstCachedRow);
+        }
+    }
+
+    void ListBox::elementsInserted(ListModel* model, int first, int count)
+    {
+        if (model != mListModel)
+        {
+            return;
+        }
+
+        // Keep the same elements selected.
+        if (mSelected >= first)
+        {
+            mSelected += count;
+        }
+
+        if (mAnchor >= first)
+        {
+            mAnchor += count;
+        }
+
+        mSelection.insertGap(first, count);
+
+        if (first <= mFirstCachedRow)
+        {
+            mFirstCachedRow += count;
+        }
+        else
+        {
+            truncateRowCache(first);
+        }
+
+        mAdjustedElements = -1;
+        requestRedraw();
+    }
+
+    void ListBox::elementsRemoved(ListModel* model, int first, int count)
+    {
+        if (model != mListModel)
+        {
+            return;
+        }
+
+        if (first + count <= mFirstCachedRow)
+        {
+            mFirstCachedRow -= count;
+        }
+        else
+        {
+            truncateRowCache(first);
+        }
+
+        mAdjustedElements = -1;
+        requestRedraw();
+
+        if (mAnchor >= first + count)
+        {
+            mAnchor -= count;
+        }
+        else if (mAnchor >= first)
+        {
+            mAnchor = -1;
+        }
+
+        if (mSelected >= first + count)
+        {
+            mSelected -= count;
+        }
+        else if (mSelected >= first)
+        {
+            mSelected = -1;
+        }
+
+        bool deselected = mSelection.intersects(first, count);
+        mSelection.removeGap(first, count);
+        updateLead();
+
+        if (deselected)
+        {
+            distributeValueChangedEvent(-1, 0);
+        }
+    }
+
+    void ListBox::elementsChanged(ListModel* model, int first, int count)
+    {
+        if (model != mListModel)
+        {
+            return;
+        }
+
+        int start = std::max(first, mFirstCachedRow);
+        int end = std::min(first + count, mFirstCachedRow + (int)mCachedRows.size());
+
+        for (int i = start; i < end; ++i)
+        {
+            mCachedRows[i - mFirstCachedRow].valid = false;
+        }
+
+        requestRedraw();
+    }
+
+    void ListBox::listModelDeleted(ListModel* model)
+    {
+        if (model != mListModel)
+        {
+            return;
+        }
+
+        mListModel = NULL;
+        mSelected = -1;
+        mAnchor = -1;
+        mSelection.clear();
+
+        mCachedRows.clear();
+        mAdjustedElements = -1;
+        requestRedraw();
+    }
 }
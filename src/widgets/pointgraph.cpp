@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 #include <fifechan/exception.hpp>
+#include <fifechan/graphdatasource.hpp>
 #include <fifechan/graphics.hpp>
 #include <fifechan/widgets/pointgraph.hpp>
 
@@ -28,18 +29,35 @@ namespace fcn {
 
     PointGraph::PointGraph():
         m_opaque(false),
+        m_decimation(true),
         m_thickness(1),
-        m_data() {
+        m_data(),
+        m_source(NULL),
+        m_sourceChanged(false),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
     }
 
     PointGraph::PointGraph(const PointVector& data):
         m_opaque(false),
+        m_decimation(true),
         m_thickness(1),
-        m_data(data) {
+        m_data(data),
+        m_source(NULL),
+        m_sourceChanged(false),
+        m_sourceStart(0),
+        m_sourceEnd(0) {
+    }
+
+    PointGraph::~PointGraph() {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
     }
 
     void PointGraph::setPointVector(const PointVector& data) {
         m_data = data;
+        m_pyramid.clear();
     }
 
     const PointVector& PointGraph::getPointVector() const {
@@ -48,6 +66,29 @@ namespace fcn {
 
     void PointGraph::resetPointVector() {
         m_data.clear();
+        m_pyramid.clear();
+    }
+
+    void PointGraph::addPoint(const Point& point) {
+        m_data.push_back(point);
+    }
+
+    void PointGraph::setDataSource(GraphDataSource* source) {
+        if (m_source) {
+            m_source->removeGraphDataListener(this);
+        }
+        m_source = source;
+        m_sourceChanged = true;
+        m_sourceStart = 0;
+        m_sourceEnd = 0;
+        m_sourceData.clear();
+        if (m_source) {
+            m_source->addGraphDataListener(this);
+        }
+    }
+
+    GraphDataSource* PointGraph::getDataSource() const {
+        return m_source;
     }
 
     void PointGraph::setThickness(unsigned int thickness) {
@@ -58,6 +99,14 @@ namespace fcn {
         return m_thickness;
     }
 
+    void PointGraph::setDecimationEnabled(bool decimation) {
+        m_decimation = decimation;
+    }
+
+    bool PointGraph::isDecimationEnabled() const {
+        return m_decimation;
+    }
+
     void PointGraph::setOpaque(bool opaque) {
         m_opaque = opaque;
     }
@@ -88,22 +137,59 @@ namespace fcn {
             }
         }
 
-        if (m_data.empty()) {
+        // a data source is drawn from the start of its window
+        const PointVector* data = &m_data;
+        int offset = 0;
+        if (m_source) {
+            if (m_sourceChanged) {
+                m_source->updateWindowPoints(m_sourceData, m_sourceStart, m_sourceEnd);
+                m_sourceChanged = false;
+            }
+            data = &m_sourceData;
+            offset = m_sourceStart;
+        } else if (m_decimation && !m_data.empty()) {
+            // with many points per pixel column only the extremes are drawn
+            m_pyramid.update(m_data);
+            if (m_pyramid.decimate(m_data, m_decimated)) {
+                data = &m_decimated;
+            }
+        }
+        if (data->empty()) {
             return;
         }
         // draw points
         graphics->setColor(getBaseColor());
         bool thick = m_thickness > 1;
-        PointVector::iterator pit = m_data.begin();
+        PointVector::const_iterator pit = data->begin();
         if (thick) {
-            for (; pit != m_data.end(); ++pit) {
-                graphics->drawFillCircle(*pit, m_thickness);
+            for (; pit != data->end(); ++pit) {
+                graphics->drawFillCircle(Point((*pit).x - offset, (*pit).y), m_thickness);
             }
         } else {
-            for (; pit != m_data.end(); ++pit) {
-                graphics->drawPoint((*pit).x, (*pit).y);
+            for (; pit != data->end(); ++pit) {
+
+                graphics->drawPoint((*pit).x - offset, (*pit).y);
             }
         }
     }
 
+    void PointGraph::pointsAppended(GraphDataSource* source, int count) {
+        m_sourceChanged = true;
+    }
+
+    void PointGraph::pointsRemoved(GraphDataSource* source, int count) {
+        m_sourceChanged = true;
+    }
+
+    void PointGraph::windowChanged(GraphDataSource* source) {
+        m_sourceChanged = true;
+    }
+
+    void PointGraph::graphDataSourceDeleted(GraphDataSource* source) {
+        if (source == m_source) {
+            m_source = NULL;
+            m_sourceData.clear();
+        }
+    }
+
 };
\ No newline at end of file
@@ -67,11 +67,13 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "fifechan/widgets/scrollarea.hpp"
 
 #include "fifechan/exception.hpp"
 #include "fifechan/graphics.hpp"
+#include "fifechan/image.hpp"
 
 namespace fcn
 {
@@ -93,6 +95,10 @@ namespace fcn
         mIsVerticalMarkerDragged = false;
         mIsHorizontalMarkerDragged =false;
         mOpaque = true;
+        mScrollBlitting = false;
+        mBuffer = NULL;
+        mBufferGraphics = NULL;
+        mBufferValid = false;
 
         addMouseListener(this);
     }
@@ -115,6 +121,10 @@ namespace fcn
         mIsVerticalMarkerDragged = false;
         mIsHorizontalMarkerDragged =false;
         mOpaque = true;
+        mScrollBlitting = false;
+        mBuffer = NULL;
+        mBufferGraphics = NULL;
+        mBufferValid = false;
 
         setContent(content);
         addMouseListener(this);
@@ -140,6 +150,10 @@ namespace fcn
         mIsVerticalMarkerDragged = false;
         mIsHorizontalMarkerDragged =false;
         mOpaque = true;
+        mScrollBlitting = false;
+        mBuffer = NULL;
+        mBufferGraphics = NULL;
+        mBufferValid = false;
 
         setContent(content);
         addMouseListener(this);
@@ -148,6 +162,7 @@ namespace fcn
     ScrollArea::~ScrollArea()
     {
         setContent(NULL);
+        delete mBuffer;
     }
 
     void ScrollArea::setContent(Widget* widget)
@@ -163,6 +178,7 @@ namespace fcn
             clear();
         }
 
+        mBufferValid = false;
         checkPolicies();
     }
 
@@ -1289,6 +1305,136 @@ namespace fcn
     {
         return mOpaque;
     }
+
+    void ScrollArea::setScrollBlittingEnabled(bool enabled)
+    {
+        mScrollBlitting = enabled;
+
+        if (!enabled)
+        {
+            delete mBuffer;
+            mBuffer = NULL;
+            mBufferGraphics = NULL;
+        }
+
+        mBufferValid = false;
+    }
+
+    bool ScrollArea::isScrollBlittingEnabled() const
+    {
+        return mScrollBlitting;
+    }
+
+    void ScrollArea::invalidateContent()
+    {
+        mBufferValid = false;
+    }
+
+    void ScrollArea::redrawChild(Widget* widget)
+    {
+        mBufferValid = false;
+        Widget::redrawChild(widget);
+    }
+
+    void ScrollArea::drawChildren(Graphics* graphics)
+    {
+        Widget* content = getContent();
+        Rectangle area = getChildrenArea();
+
+        if (!mScrollBlitting
+            || !isOpaque()
+            || getBackgroundColor().a != 255
+            || content == NULL
+            || !content->isVisible()
+            || area.isEmpty()
+            || !content->isRedrawRequesting())
+        {
+            // The content may change while it is drawn as usual.
+            mBufferValid = false;
+            Widget::drawChildren(graphics);
+            return;
+        }
+
+        if (mBuffer == NULL
+            || graphics != mBufferGraphics
+            || mBuffer->getWidth() != area.width
+            || mBuffer->getHeight() != area.height)
+        {
+            delete mBuffer;
+            mBuffer = graphics->createTarget(area.width, area.height);
+            mBufferGraphics = graphics;
+            mBufferValid = false;
+        }
+
+        if (mBuffer == NULL)
+        {
+            Widget::drawChildren(graphics);
+            return;
+        }
+
+        const Rectangle& dimension = content->getDimension();
+        int dx = dimension.x - mBufferContentDimension.x;
+        int dy = dimension.y - mBufferContentDimension.y;
+
+        graphics->pushTarget(mBuffer);
+
+        if (!mBufferValid
+            || dimension.width != mBufferContentDimension.width
+            || dimension.height != mBufferContentDimension.height
+            || getBackgroundColor() != mBufferBackgroundColor
+            || std::abs(dx) >= area.width
+            || std::abs(dy) >= area.height)
+        {
+            drawContentArea(graphics, Rectangle(0, 0, area.width, area.height));
+        }
+        else if (dx != 0 || dy != 0)
+        {
+            // Move what is still visible and draw the exposed strips
+            graphics->copyArea(Rectangle(0, 0, area.width, area.height), dx, dy);
+
+            if (dy > 0)
+            {
+                drawContentArea(graphics, Rectangle(0, 0, area.width, dy));
+            }
+            else if (dy < 0)
+            {
+                drawContentArea(graphics, Rectangle(0, area.height + dy, area.width, -dy));
+            }
+
+            if (dx > 0)
+            {
+                drawContentArea(graphics, Rectangle(0, 0, dx, area.height));
+            }
+            else if (dx < 0)
+            {
+                drawContentArea(graphics, Rectangle(area.width + dx, 0, -dx, area.height));
+            }
+        }
+
+        graphics->popTarget();
+
+        mBufferValid = true;
+        mBufferContentDimension = dimension;
+        mBufferBackgroundColor = getBackgroundColor();
+
+        graphics->pushClipArea(area);
+        graphics->drawImage(mBuffer, 0, 0);
+        graphics->popClipArea();
+    }
+
+    void ScrollArea::drawContentArea(Graphics* graphics, const Rectangle& area)
+    {
+        graphics->pushClipArea(area);
+        graphics->setColor(getBackgroundColor());
+        graphics->fillRectangle(0, 0, area.width, area.height);
+
+        // Keep the origin of the children area but clip to the part
+        graphics->pushClipArea(Rectangle(-area.x, -area.y, mBuffer->getWidth(), mBuffer->getHeight()));
+        getContent()->_draw(graphics);
+        graphics->popClipArea();
+
+        graphics->popClipArea();
+    }
 }
 
 /*
@@ -0,0 +1,743 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/widgets/table.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "fifechan/font.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/key.hpp"
+#include "fifechan/mouseinput.hpp"
+#include "fifechan/selectionlistener.hpp"
+#include "fifechan/tablemodel.hpp"
+
+namespace fcn
+{
+    Table::Table()
+        : mTableModel(NULL),
+          mSelected(-1),
+          mCellRenderer(&mDefaultCellRenderer),
+          mDefaultColumnWidth(100),
+          mRowHeight(0),
+          mVariableRowHeights(false),
+          mHeaderVisible(true),
+          mHeaderY(0),
+          mAdjustedRows(-1),
+          mRowIndexInvalid(true),
+          mIndexedRowHeight(0)
+    {
+        // Tables are meant to hold far more rows than the default maximum
+        // size allows.
+        setMaxSize(Size(std::numeric_limits<int>::max(), std::numeric_limits<int>::max()));
+        setFocusable(true);
+        setRedrawRequesting(true);
+
+        addMouseListener(this);
+        addKeyListener(this);
+    }
+
+    Table::Table(TableModel* tableModel)
+        : mTableModel(NULL),
+          mSelected(-1),
+          mCellRenderer(&mDefaultCellRenderer),
+          mDefaultColumnWidth(100),
+          mRowHeight(0),
+          mVariableRowHeights(false),
+          mHeaderVisible(true),
+          mHeaderY(0),
+          mAdjustedRows(-1),
+          mRowIndexInvalid(true),
+          mIndexedRowHeight(0)
+    {
+        setMaxSize(Size(std::numeric_limits<int>::max(), std::numeric_limits<int>::max()));
+        setTableModel(tableModel);
+        setFocusable(true);
+        setRedrawRequesting(true);
+
+        addMouseListener(this);
+        addKeyListener(this);
+    }
+
+    Table::~Table()
+    {
+        if (mTableModel != NULL)
+        {
+            mTableModel->removeTableModelListener(this);
+        }
+    }
+
+    void Table::setTableModel(TableModel* tableModel)
+    {
+        if (mTableModel != NULL)
+        {
+            mTableModel->removeTableModelListener(this);
+        }
+
+        mSelected = -1;
+        mTableModel = tableModel;
+        mRowIndexInvalid = true;
+
+        if (mTableModel != NULL)
+        {
+            mTableModel->addTableModelListener(this);
+        }
+
+        adjustSize();
+        requestRedraw();
+    }
+
+    TableModel* Table::getTableModel() const
+    {
+        return mTableModel;
+    }
+
+    int Table::getSelected() const
+    {
+        return mSelected;
+    }
+
+    void Table::setSelected(int selected)
+    {
+        if (mTableModel == NULL || selected < 0)
+        {
+            mSelected = -1;
+        }
+        else if (selected >= mTableModel->getNumberOfRows())
+        {
+            mSelected = mTableModel->getNumberOfRows() - 1;
+        }
+        else
+        {
+            mSelected = selected;
+        }
+
+        if (mSelected >= 0)
+        {
+            // Include the header, which covers the top of the visible area.
+            Rectangle scroll;
+            scroll.y = getRowPosition(mSelected);
+            scroll.height = getHeaderHeight() + getRowHeight(mSelected);
+            showPart(scroll);
+        }
+
+        distributeValueChangedEvent();
+    }
+
+    void Table::setCellRenderer(TableCellRenderer* cellRenderer)
+    {
+        mCellRenderer = cellRenderer != NULL ? cellRenderer : &mDefaultCellRenderer;
+        requestRedraw();
+    }
+
+    TableCellRenderer* Table::getCellRenderer() const
+    {
+        return mCellRenderer;
+    }
+
+    void Table::setColumnWidth(int column, int width)
+    {
+        if (column >= (int)mColumnWidths.size())
+        {
+            mColumnWidths.resize(column + 1, -1);
+        }
+
+        mColumnWidths[column] = width;
+        adjustSize();
+        requestRedraw();
+    }
+
+    int Table::getColumnWidth(int column) const
+    {
+        if (column < (int)mColumnWidths.size() && mColumnWidths[column] >= 0)
+        {
+            return mColumnWidths[column];
+        }
+
+        return mDefaultColumnWidth;
+    }
+
+    void Table::setDefaultColumnWidth(int width)
+    {
+        mDefaultColumnWidth = width;
+        adjustSize();
+        requestRedraw();
+    }
+
+    int Table::getDefaultColumnWidth() const
+    {
+        return mDefaultColumnWidth;
+    }
+
+    void Table::setRowHeight(unsigned int height)
+    {
+        mRowHeight = height;
+        adjustSize();
+        requestRedraw();
+    }
+
+    unsigned int Table::getRowHeight() const
+    {
+        if (mRowHeight > 0)
+        {
+            return mRowHeight;
+        }
+
+        return getFont()->getHeight() + 2;
+    }
+
+    void Table::setVariableRowHeightsEnabled(bool enabled)
+    {
+        mVariableRowHeights = enabled;
+        mRowIndexInvalid = true;
+        adjustSize();
+        requestRedraw();
+    }
+
+    bool Table::isVariableRowHeightsEnabled() const
+    {
+        return mVariableRowHeights;
+    }
+
+    void Table::setHeaderVisible(bool visible)
+    {
+        mHeaderVisible = visible;
+        adjustSize();
+        requestRedraw();
+    }
+
+    bool Table::isHeaderVisible() const
+    {
+        return mHeaderVisible;
+    }
+
+    int Table::getHeaderHeight() const
+    {
+        if (!mHeaderVisible)
+        {
+            return 0;
+        }
+
+        return getFont()->getHeight() + 2;
+    }
+
+    int Table::getRowPosition(int row) const
+    {
+        if (row <= 0)
+        {
+            return 0;
+        }
+
+        if (!mVariableRowHeights)
+        {
+            return row * getRowHeight();
+        }
+
+        updateRowIndex();
+
+        int sum = 0;
+        for (int node = std::min(row, (int)mRowIndex.size()); node > 0; node -= node & -node)
+        {
+            sum += mRowIndex[node - 1];
+        }
+
+        return sum;
+    }
+
+    int Table::getRowHeight(int row) const
+    {
+        if (!mVariableRowHeights)
+        {
+            return getRowHeight();
+        }
+
+        updateRowIndex();
+
+        if (row < 0 || row >= (int)mRowHeights.size())
+        {
+            return getRowHeight();
+        }
+
+        return mRowHeights[row];
+    }
+
+    int Table::getRowAt(int y) const
+    {
+        if (mTableModel == NULL || y < 0)
+        {
+            return -1;
+        }
+
+        int row;
+
+        if (!mVariableRowHeights)
+        {
+            row = y / getRowHeight();
+        }
+        else
+        {
+            updateRowIndex();
+
+            int step = 1;
+            while (step * 2 <= (int)mRowIndex.size())
+            {
+                step *= 2;
+            }
+
+            // Descend the tree to the last row starting at or before the
+            // position.
+            row = 0;
+            for (; step > 0; step /= 2)
+            {
+                if (row + step <= (int)mRowIndex.size() && mRowIndex[row + step - 1] <= y)
+                {
+                    row += step;
+                    y -= mRowIndex[row - 1];
+                }
+            }
+        }
+
+        if (row >= mTableModel->getNumberOfRows())
+        {
+            return -1;
+        }
+
+        return row;
+    }
+
+    int Table::getColumnAt(int x) const
+    {
+        if (mTableModel == NULL || x < 0)
+        {
+            return -1;
+        }
+
+        int columns = mTableModel->getNumberOfColumns();
+        int columnX = 0;
+
+        for (int column = 0; column < columns; ++column)
+        {
+            columnX += getColumnWidth(column);
+
+            if (x < columnX)
+            {
+                return column;
+            }
+        }
+
+        return -1;
+    }
+
+    void Table::addSelectionListener(SelectionListener* selectionListener)
+    {
+        mSelectionListeners.push_back(selectionListener);
+    }
+
+    void Table::removeSelectionListener(SelectionListener* selectionListener)
+    {
+        mSelectionListeners.remove(selectionListener);
+    }
+
+    void Table::resizeToContent(bool recursiv)
+    {
+        adjustSize();
+    }
+
+    void Table::adjustSize()
+    {
+        if (mTableModel == NULL)
+        {
+            return;
+        }
+
+        int width = 0;
+        int columns = mTableModel->getNumberOfColumns();
+
+        for (int column = 0; column < columns; ++column)
+        {
+            width += getColumnWidth(column);
+        }
+
+        int rows = mTableModel->getNumberOfRows();
+
+        setSize(width, getHeaderHeight() + getRowPosition(rows));
+        mAdjustedRows = rows;
+    }
+
+    void Table::draw(Graphics* graphics)
+    {
+        graphics->setColor(getBackgroundColor());
+        graphics->fillRectangle(0, 0, getWidth(), getHeight());
+
+        if (mTableModel == NULL)
+        {
+            return;
+        }
+
+        graphics->setFont(getFont());
+
+        // Only draw the cells inside the current clip area. The clip area
+        // is in screen coordinates, its offset is where the table is on
+        // the screen.
+        const ClipRectangle& clipArea = graphics->getCurrentClipArea();
+        int top = clipArea.y - clipArea.yOffset;
+        int bottom = top + clipArea.height;
+        int left = clipArea.x - clipArea.xOffset;
+        int right = left + clipArea.width;
+
+        // The header stays at the top of the visible area and covers the
+        // rows below it.
+        int headerHeight = getHeaderHeight();
+        mHeaderY = std::max(top, 0);
+
+        int rows = mTableModel->getNumberOfRows();
+        int columns = mTableModel->getNumberOfColumns();
+        int row = getRowAt(mHeaderY);
+        int y = row >= 0 ? getRowPosition(row) : 0;
+
+        for (; row >= 0 && row < rows && headerHeight + y < bottom; ++row)
+        {
+            int height = getRowHeight(row);
+            bool selected = row == mSelected;
+
+            if (selected)
+            {
+                graphics->setColor(getSelectionColor());
+                graphics->fillRectangle(0, headerHeight + y, getWidth(), height);
+            }
+
+            int x = 0;
+            for (int column = 0; column < columns && x < right; ++column)
+            {
+                int width = getColumnWidth(column);
+
+                if (x + width > left)
+                {
+                    graphics->pushClipArea(Rectangle(x, headerHeight + y, width, height));
+                    mCellRenderer->drawCell(graphics,
+                                            this,
+                                            getCellElement(row, column),
+                                            row,
+                                            column,
+                                            width,
+                                            height,
+                                            selected);
+                    graphics->popClipArea();
+                }
+
+                x += width;
+            }
+
+            y += height;
+        }
+
+        if (mHeaderVisible)
+        {
+            drawHeader(graphics, mHeaderY);
+        }
+    }
+
+    void Table::drawHeader(Graphics* graphics, int y)
+    {
+        int height = getHeaderHeight();
+        Color faceColor = getBaseColor();
+        Color shadowColor = faceColor - 0x303030;
+        shadowColor.a = faceColor.a;
+
+        graphics->setColor(faceColor);
+        graphics->fillRectangle(0, y, getWidth(), height);
+
+        int columns = mTableModel->getNumberOfColumns();
+        int x = 0;
+
+        for (int column = 0; column < columns; ++column)
+        {
+            int width = getColumnWidth(column);
+
+            graphics->pushClipArea(Rectangle(x, y, width - 1, height));
+            graphics->setColor(getForegroundColor());
+            graphics->drawText(mTableModel->getColumnName(column), 2, 1);
+            graphics->popClipArea();
+
+            x += width;
+
+            graphics->setColor(shadowColor);
+            graphics->drawLine(x - 1, y, x - 1, y + height - 1);
+        }
+
+        graphics->setColor(shadowColor);
+        graphics->drawLine(0, y + height - 1, getWidth() - 1, y + height - 1);
+    }
+
+    void Table::logic()
+    {
+        if (mTableModel != NULL && mTableModel->getNumberOfRows() != mAdjustedRows)
+        {
+            adjustSize();
+        }
+    }
+
+    void Table::keyPressed(KeyEvent& keyEvent)
+    {
+        if (mTableModel == NULL)
+        {
+            return;
+        }
+
+        Key key = keyEvent.getKey();
+
+        if (key.getValue() == Key::Enter || key.getValue() == Key::Space)
+        {
+            distributeActionEvent();
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Up)
+        {
+            setSelected(std::max(mSelected - 1, 0));
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Down)
+        {
+            setSelected(mSelected + 1);
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Home)
+        {
+            setSelected(0);
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::End)
+        {
+            setSelected(mTableModel->getNumberOfRows() - 1);
+            keyEvent.consume();
+        }
+    }
+
+    void Table::mousePressed(MouseEvent& mouseEvent)
+    {
+        if (mouseEvent.getButton() != MouseEvent::Left)
+        {
+            return;
+        }
+
+        int headerHeight = getHeaderHeight();
+
+        if (mouseEvent.getY() >= mHeaderY && mouseEvent.getY() < mHeaderY + headerHeight)
+        {
+            return;
+        }
+
+        int row = getRowAt(mouseEvent.getY() - headerHeight);
+
+        if (row >= 0)
+        {
+            setSelected(row);
+            distributeActionEvent();
+        }
+    }
+
+    void Table::mouseDragged(MouseEvent& mouseEvent)
+    {
+        mouseEvent.consume();
+    }
+
+    void Table::rowsInserted(TableModel* model, int first, int count)
+    {
+        if (model != mTableModel)
+        {
+            return;
+        }
+
+        // Keep the same row selected.
+        if (mSelected >= first)
+        {
+            mSelected += count;
+        }
+
+        mRowIndexInvalid = true;
+        mAdjustedRows = -1;
+        requestRedraw();
+    }
+
+    void Table::rowsRemoved(TableModel* model, int first, int count)
+    {
+        if (model != mTableModel)
+        {
+            return;
+        }
+
+        mRowIndexInvalid = true;
+        mAdjustedRows = -1;
+        requestRedraw();
+
+        if (mSelected >= first + count)
+        {
+            mSelected -= count;
+        }
+        else if (mSelected >= first)
+        {
+            mSelected = -1;
+            distributeValueChangedEvent();
+        }
+    }
+
+    void Table::rowsChanged(TableModel* model, int first, int count)
+    {
+        if (model != mTableModel)
+        {
+            return;
+        }
+
+        requestRedraw();
+
+        if (!mVariableRowHeights)
+        {
+            return;
+        }
+
+        // Updating a row costs as much as a logarithmic part of a rebuild,
+        // so rebuild when many rows changed.
+        if (mRowIndexInvalid || mChangedRows.size() + count > 64)
+        {
+            mRowIndexInvalid = true;
+        }
+        else
+        {
+            for (int row = first; row < first + count; ++row)
+            {
+                mChangedRows.push_back(row);
+            }
+        }
+
+        mAdjustedRows = -1;
+    }
+
+    void Table::columnsChanged(TableModel* model)
+    {
+        if (model == mTableModel)
+        {
+            mAdjustedRows = -1;
+            requestRedraw();
+        }
+    }
+
+    void Table::tableModelDeleted(TableModel* model)
+    {
+        if (model != mTableModel)
+        {
+            return;
+        }
+
+        mTableModel = NULL;
+        mSelected = -1;
+        mRowIndexInvalid = true;
+        mAdjustedRows = -1;
+        requestRedraw();
+    }
+
+    const std::string& Table::getCellElement(int row, int column)
+    {
+        const std::string* element = mTableModel->getElementPointer(row, column);
+
+        if (element != NULL)
+        {
+            return *element;
+        }
+
+        mCellElement = mTableModel->getElementAt(row, column);
+        return mCellElement;
+    }
+
+    void Table::updateRowIndex() const
+    {
+        int rowHeight = getRowHeight();
+        int rows = mTableModel != NULL ? mTableModel->getNumberOfRows() : 0;
+        int i;
+
+        if (mRowIndexInvalid || rowHeight != mIndexedRowHeight || (int)mRowHeights.size() != rows)
+        {
+            mRowHeights.resize(rows);
+            mRowIndex.resize(rows);
+
+            for (i = 0; i < rows; ++i)
+            {
+                int height = mTableModel->getRowHeight(i);
+                mRowHeights[i] = height > 0 ? height : rowHeight;
+                mRowIndex[i] = mRowHeights[i];
+            }
+
+            // Build the Fenwick tree in place, every node adds itself to
+            // its parent.
+            for (i = 1; i <= rows; ++i)
+            {
+                int parent = i + (i & -i);
+                if (parent <= rows)
+                    mRowIndex[parent - 1] += mRowIndex[i - 1];
+            }
+
+            mChangedRows.clear();
+            mRowIndexInvalid = false;
+            mIndexedRowHeight = rowHeight;
+            return;
+        }
+
+        for (i = 0; i < (int)mChangedRows.size(); ++i)
+        {
+            int row = mChangedRows[i];
+            if (row < 0 || row >= rows)
+                continue;
+
+            int height = mTableModel->getRowHeight(row);
+            if (height <= 0)
+                height = rowHeight;
+
+            int delta = height - mRowHeights[row];
+            if (delta == 0)
+                continue;
+
+            for (int node = row + 1; node <= rows; node += node & -node)
+                mRowIndex[node - 1] += delta;
+
+            mRowHeights[row] = height;
+        }
+
+        mChangedRows.clear();
+    }
+
+    void Table::distributeValueChangedEvent()
+    {
+        requestRedraw();
+
+        SelectionListenerIterator iter;
+
+        for (iter = mSelectionListeners.begin(); iter != mSelectionListeners.end(); ++iter)
+        {
+            SelectionEvent event(this);
+            (*iter)->valueChanged(event);
+        }
+    }
+}
@@ -76,17 +76,23 @@
 #include <fifechan/utf8stringeditor.hpp>
 #include <fifechan/util/utf8/utf8.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace fcn
 {
     TextBox::TextBox(const std::string& text)
         :mEditable(true),
-         mOpaque(true)
+         mOpaque(true),
+         mMaximumRows(0),
+         mLayoutPending(false),
+         mPendingWidth(0),
+         mPendingRemovedRows(0)
     {
         mText = new Text(text);
 
         setFocusable(true);
+        setRedrawRequesting(true);
 
         addMouseListener(this);
         addKeyListener(this);
@@ -104,7 +110,9 @@ namespace fcn
     void TextBox::setText(const std::string& text)
     {
         mText->setContent(text);
+        mStringEditor->invalidateIndex();
         adjustSize();
+        requestRedraw();
     }
 
     void TextBox::draw(Graphics* graphics)
@@ -115,7 +123,26 @@ namespace fcn
             graphics->fillRectangle(0, 0, getWidth(), getHeight());
         }
 
-        if (isFocused() && isEditable())
+        // Check the current clip area so we don't draw rows that are
+        // not visible, which is the case for most rows of a long text
+        // in a scroll area. The clip area is converted to the
+        // coordinates of the text box.
+        const ClipRectangle& clipArea = graphics->getCurrentClipArea();
+        int top = clipArea.y - clipArea.yOffset;
+        int bottom = top + clipArea.height;
+        int rowHeight = getFont()->getHeight();
+
+        int startRow = top > 0 ? top / rowHeight : 0;
+        int endRow = bottom > 0 ? bottom / rowHeight + 1 : 0;
+
+        if (endRow > (int)mText->getNumberOfRows())
+        {
+            endRow = mText->getNumberOfRows();
+        }
+
+        if (isFocused() && isEditable()
+            && (int)mText->getCaretRow() >= startRow
+            && (int)mText->getCaretRow() < endRow)
         {
             drawCaret(graphics, 
                       mText->getCaretX(getFont()), 
@@ -125,11 +152,13 @@ namespace fcn
         graphics->setColor(getForegroundColor());
         graphics->setFont(getFont());
 
-        unsigned int i;
-        for (i = 0; i < mText->getNumberOfRows(); i++)
+        // Read the rows through a const Text so their widths are kept.
+        const Text* text = mText;
+        int i;
+        for (i = startRow; i < endRow; i++)
         {
             // Move the text one pixel so we can have a caret before a letter.
-            graphics->drawText(mText->getRow(i), 1, i * getFont()->getHeight());
+            graphics->drawText(text->getRow(i), 1, i * rowHeight);
         }
     }
 
@@ -144,6 +173,7 @@ namespace fcn
         if (mouseEvent.getButton() == MouseEvent::Left)
         {
             mText->setCaretPosition(mouseEvent.getX(), mouseEvent.getY(), getFont());
+            requestRedraw();
             mouseEvent.consume();
         }
     }
@@ -212,6 +242,7 @@ namespace fcn
                             ,getCaretRow() + 1);
             
             mText->getRow(getCaretRow()).resize(getCaretColumn());
+            mStringEditor->invalidateIndex();
             setCaretRow(getCaretRow() + 1);
             setCaretColumn(0);
         }
@@ -221,7 +252,7 @@ namespace fcn
         {
             std::string& currRow = mText->getRow(getCaretRow());
             setCaretColumn(mStringEditor->prevChar(currRow, static_cast<int>(getCaretColumn())));
-            setCaretColumn(mStringEditor->eraseChar(currRow, static_cast<int>(getCaretColumn())));
+            setCaretColumn(mStringEditor->eraseCharIndexed(currRow, static_cast<int>(getCaretColumn())));
         }
         else if (key.getValue() == Key::Backspace
                     && getCaretColumn() == 0
@@ -236,6 +267,7 @@ namespace fcn
             //setCaretColumn(getTextRow(getCaretRow() - 1).size());
             mText->getRow(getCaretRow() - 1) += getTextRow(getCaretRow());
             mText->eraseRow(getCaretRow());
+            mStringEditor->invalidateIndex();
             setCaretRow(getCaretRow() - 1);
             setCaretColumn(newCaretColumn);
         }
@@ -243,7 +275,7 @@ namespace fcn
                     && getCaretColumn() < (int)getTextRow(getCaretRow()).size()
                     && mEditable)
         {
-            setCaretColumn(mStringEditor->eraseChar(mText->getRow(getCaretRow()), getCaretColumn()));
+            setCaretColumn(mStringEditor->eraseCharIndexed(mText->getRow(getCaretRow()), getCaretColumn()));
         }
         else if (key.getValue() == Key::Delete
                     && getCaretColumn() == (int)getTextRow(getCaretRow()).size()
@@ -252,6 +284,7 @@ namespace fcn
         {
             mText->getRow(getCaretRow()) += getTextRow((getCaretRow() + 1));
             mText->eraseRow(getCaretRow() + 1);
+            mStringEditor->invalidateIndex();
         }
         else if(key.getValue() == Key::PageUp)
         {
@@ -260,7 +293,7 @@ namespace fcn
             if (par != NULL)
             {
                 int rowsPerPage = par->getChildrenArea().height / getFont()->getHeight();
-                int chars = mStringEditor->countChars(getTextRow(getCaretRow()), getCaretColumn());
+                int chars = mStringEditor->countCharsIndexed(getCaretRowText(), getCaretColumn());
                 int newCaretRow = getCaretRow() - rowsPerPage;
                 if (newCaretRow >= 0)
                 {
@@ -270,7 +303,7 @@ namespace fcn
                 {
                     setCaretRow(0);
                 }
-                setCaretColumn(mStringEditor->getOffset(getTextRow(getCaretRow()), chars));
+                setCaretColumn(mStringEditor->getOffsetIndexed(getCaretRowText(), chars));
             }
         }
         else if(key.getValue() == Key::PageDown)
@@ -280,7 +313,7 @@ namespace fcn
             if (par != NULL)
             {
                 int rowsPerPage = par->getChildrenArea().height / getFont()->getHeight();
-                int chars = mStringEditor->countChars(getTextRow(getCaretRow()), getCaretColumn());
+                int chars = mStringEditor->countCharsIndexed(getCaretRowText(), getCaretColumn());
                 setCaretRow(getCaretRow() + rowsPerPage);
 
                 if (getCaretRow() >= (int)getNumberOfRows())
@@ -288,7 +321,7 @@ namespace fcn
                     setCaretRow(getNumberOfRows() - 1);
                 }
 
-                setCaretColumn(mStringEditor->getOffset(getTextRow(getCaretRow()), chars));
+                setCaretColumn(mStringEditor->getOffsetIndexed(getCaretRowText(), chars));
             }
         }
         else if(key.getValue() == Key::Tab
@@ -296,16 +329,18 @@ namespace fcn
         {
             // FIXME: jump X spaces, so getCaretColumn() % TAB_SIZE = 0 and X <= TAB_SIZE
             mText->getRow(getCaretRow()).insert(getCaretColumn(),std::string("    "));
+            mStringEditor->invalidateIndex();
             setCaretColumn(getCaretColumn() + 4);
         }
         else if ((key.isCharacter() || key.getValue() > 255)
                     && mEditable)
         {
-            setCaretColumn(mStringEditor->insertChar(mText->getRow(getCaretRow()), getCaretColumn(), key.getValue()));
+            setCaretColumn(mStringEditor->insertCharIndexed(mText->getRow(getCaretRow()), getCaretColumn(), key.getValue()));
         }
 
         adjustSize();
         scrollToCaret();
+        requestRedraw();
         assert(utf8::is_valid(getTextRow(getCaretRow()).begin(),getTextRow(getCaretRow()).end()) == utf8::internal::UTF8_OK);
         assert(utf8::is_valid(getTextRow(getCaretRow()).begin(),getTextRow(getCaretRow()).begin() + getCaretColumn()) == utf8::internal::UTF8_OK);
         keyEvent.consume();
@@ -324,6 +359,7 @@ namespace fcn
     void TextBox::setCaretPosition(unsigned int position)
     {
         mText->setCaretPosition(position);
+        requestRedraw();
     }
 
     unsigned int TextBox::getCaretPosition() const
@@ -335,11 +371,13 @@ namespace fcn
     {
         mText->setCaretRow(row);
         mText->setCaretColumn(column);
+        requestRedraw();
     }
 
     void TextBox::setCaretRow(int row)
     {
         mText->setCaretRow(row);
+        requestRedraw();
     }
 
     unsigned int TextBox::getCaretRow() const
@@ -350,6 +388,7 @@ namespace fcn
     void TextBox::setCaretColumn(int column)
     {
         mText->setCaretColumn(column);
+        requestRedraw();
     }
 
     unsigned int TextBox::getCaretColumn() const
@@ -359,13 +398,15 @@ namespace fcn
 
     std::string TextBox::getTextRow(int row) const
     {     
-        return mText->getRow(row);
+        return static_cast<const Text*>(mText)->getRow(row);
     }
 
     void TextBox::setTextRow(int row, const std::string& text)
     {
         mText->setRow(row, text);
+        mStringEditor->invalidateIndex();
         adjustSize();
+        requestRedraw();
     }
 
     unsigned int TextBox::getNumberOfRows() const
@@ -381,6 +422,7 @@ namespace fcn
     void TextBox::fontChanged()
     {
         adjustSize();
+        requestRedraw();
     }
 
     void TextBox::scrollToCaret()
@@ -391,6 +433,7 @@ namespace fcn
     void TextBox::setEditable(bool editable)
     {
         mEditable = editable;
+        requestRedraw();
     }
 
     bool TextBox::isEditable() const
@@ -401,7 +444,97 @@ namespace fcn
     void TextBox::addRow(const std::string &row)
     {
         mText->addRow(row);
+        mStringEditor->invalidateIndex();
+        removeExcessRows();
         adjustSize();
+        requestRedraw();
+    }
+
+    void TextBox::appendRow(const std::string& row)
+    {
+        mText->addRow(row);
+        mStringEditor->invalidateIndex();
+        mPendingRemovedRows += removeExcessRows();
+
+        // Leave room for the caret after the last character, as
+        // Text::getDimension does.
+        int width = getFont()->getWidth(row) + getFont()->getWidth(" ");
+        if (width > mPendingWidth)
+        {
+            mPendingWidth = width;
+        }
+
+        mLayoutPending = true;
+        requestRedraw();
+    }
+
+    void TextBox::setMaximumRows(unsigned int rows)
+    {
+        mMaximumRows = rows;
+
+        if (removeExcessRows() > 0)
+        {
+            adjustSize();
+            requestRedraw();
+        }
+    }
+
+    unsigned int TextBox::getMaximumRows() const
+    {
+        return mMaximumRows;
+    }
+
+    unsigned int TextBox::removeExcessRows()
+    {
+        if (mMaximumRows == 0 || mText->getNumberOfRows() <= mMaximumRows)
+        {
+            return 0;
+        }
+
+        unsigned int count = mText->getNumberOfRows() - mMaximumRows;
+        mText->eraseFirstRows(count);
+        mStringEditor->invalidateIndex();
+
+        return count;
+    }
+
+    const std::string& TextBox::getCaretRowText() const
+    {
+        return static_cast<const Text*>(mText)->getRow(mText->getCaretRow());
+    }
+
+    void TextBox::logic()
+    {
+        if (!mLayoutPending)
+        {
+            return;
+        }
+
+        Widget* parent = getParent();
+        int rowHeight = getFont()->getHeight();
+
+        // The bottom of the text box is visible if it ends within the
+        // children area of the parent, which is the case when a scroll
+        // area is scrolled all the way down.
+        bool atBottom = parent != NULL
+            && getY() + getHeight() <= parent->getChildrenArea().height;
+        int top = -getY();
+
+        setSize(std::max(getWidth(), mPendingWidth), rowHeight * mText->getNumberOfRows());
+
+        if (atBottom)
+        {
+            showPart(Rectangle(-getX(), getHeight() - rowHeight, 0, rowHeight));
+        }
+        else if (parent != NULL && mPendingRemovedRows > 0)
+        {
+            // The rows in view moved up with the removed rows, follow them.
+            showPart(Rectangle(-getX(), std::max(0, top - (int)mPendingRemovedRows * rowHeight), 0, 0));
+        }
+
+        mLayoutPending = false;
+        mPendingWidth = 0;
+        mPendingRemovedRows = 0;
     }
 
     bool TextBox::isOpaque()
@@ -412,24 +545,25 @@ namespace fcn
     void TextBox::setOpaque(bool opaque)
     {
         mOpaque = opaque;
+        requestRedraw();
     }
     
     void TextBox::setCaretColumnUTF8(int column)
     {
         // no need to clip the column, mStringEditor handles it automaticly
-        setCaretColumn(mStringEditor->getOffset(getTextRow(getCaretRow()), column));
+        setCaretColumn(mStringEditor->getOffsetIndexed(getCaretRowText(), column));
     }
 
     void TextBox::setCaretRowUTF8(int row)
     {
-        int chars = mStringEditor->countChars(getTextRow(getCaretRow()), getCaretColumn());
+        int chars = mStringEditor->countCharsIndexed(getCaretRowText(), getCaretColumn());
         if (row < 0) {
             row = 0;
         } else if (row >= getNumberOfRows()) {
             row = getNumberOfRows() - 1;
         }
         setCaretRow(row);
-        setCaretColumn(mStringEditor->getOffset(getTextRow(getCaretRow()), chars));
+        setCaretColumn(mStringEditor->getOffsetIndexed(getCaretRowText(), chars));
     }
     
     void TextBox::setCaretRowColumnUTF8(int row, int column)
@@ -159,9 +159,10 @@ namespace fcn
         graphics->setColor(getForegroundColor());
         graphics->setFont(getFont());
 
-        const Rectangle& dim = mText->getCaretDimension(getFont());
-        if (mText->getNumberOfRows() != 0)
-            graphics->drawText(mText->getRow(0), 1 - mXScroll, 1);
+        // Read the row through a const Text so its widths are kept.
+        const Text* text = mText;
+        if (text->getNumberOfRows() != 0)
+            graphics->drawText(text->getRow(0), 1 - mXScroll, 1);
 
         graphics->popClipArea();
     }
@@ -0,0 +1,661 @@
+/***************************************************************************
+ *   Copyright (C) 2019 by the fifechan team                               *
+ *   http://fifechan.github.com/fifechan                                   *
+ *   This file is part of fifechan.                                        *
+ *                                                                         *
+ *   fifechan is free software; you can redistribute it and/or             *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+/*
+ * For comments regarding functions please see the header file.
+ */
+
+#include "fifechan/widgets/treeview.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "fifechan/font.hpp"
+#include "fifechan/graphics.hpp"
+#include "fifechan/key.hpp"
+#include "fifechan/mouseinput.hpp"
+#include "fifechan/selectionlistener.hpp"
+#include "fifechan/treemodel.hpp"
+
+namespace fcn
+{
+    TreeView::TreeView()
+        : mTreeModel(NULL),
+          mSelected(-1),
+          mIndentation(12)
+    {
+        mRoot.node = NULL;
+        mRoot.parent = NULL;
+        mRoot.index = 0;
+        mRoot.level = 0;
+        mRoot.descendants = 0;
+
+        // Expanded trees are meant to hold far more rows than the default
+        // maximum size allows.
+        setMaxSize(Size(std::numeric_limits<int>::max(), std::numeric_limits<int>::max()));
+        setWidth(100);
+        setFocusable(true);
+        setRedrawRequesting(true);
+
+        addMouseListener(this);
+        addKeyListener(this);
+    }
+
+    TreeView::TreeView(TreeModel* treeModel)
+        : mTreeModel(NULL),
+          mSelected(-1),
+          mIndentation(12)
+    {
+        mRoot.node = NULL;
+        mRoot.parent = NULL;
+        mRoot.index = 0;
+        mRoot.level = 0;
+        mRoot.descendants = 0;
+
+        setMaxSize(Size(std::numeric_limits<int>::max(), std::numeric_limits<int>::max()));
+        setWidth(100);
+        setTreeModel(treeModel);
+        setFocusable(true);
+        setRedrawRequesting(true);
+
+        addMouseListener(this);
+        addKeyListener(this);
+    }
+
+    TreeView::~TreeView()
+    {
+        if (mTreeModel != NULL)
+        {
+            mTreeModel->removeTreeModelListener(this);
+        }
+
+        clearChildren(&mRoot);
+    }
+
+    void TreeView::setTreeModel(TreeModel* treeModel)
+    {
+        if (mTreeModel != NULL)
+        {
+            mTreeModel->removeTreeModelListener(this);
+        }
+
+        mTreeModel = treeModel;
+
+        if (mTreeModel != NULL)
+        {
+            mTreeModel->addTreeModelListener(this);
+        }
+
+        reset();
+    }
+
+    TreeModel* TreeView::getTreeModel() const
+    {
+        return mTreeModel;
+    }
+
+    int TreeView::getNumberOfRows() const
+    {
+        return mRoot.descendants;
+    }
+
+    void* TreeView::getNodeAt(int row) const
+    {
+        ExpandedNode* parent;
+        int index;
+
+        if (!findRow(row, parent, index))
+        {
+            return NULL;
+        }
+
+        return mTreeModel->getChild(parent->node, index);
+    }
+
+    int TreeView::getLevel(int row) const
+    {
+        ExpandedNode* parent;
+        int index;
+
+        if (!findRow(row, parent, index))
+        {
+            return -1;
+        }
+
+        return parent->level;
+    }
+
+    int TreeView::getRowAt(int y) const
+    {
+        if (y < 0)
+        {
+            return -1;
+        }
+
+        int row = y / getRowHeight();
+
+        return row < mRoot.descendants ? row : -1;
+    }
+
+    void TreeView::setExpanded(int row, bool expanded)
+    {
+        ExpandedNode* parent;
+        int index;
+
+        if (!findRow(row, parent, index))
+        {
+            return;
+        }
+
+        std::map<int, ExpandedNode*>::iterator iter = parent->children.find(index);
+
+        if (expanded && iter == parent->children.end())
+        {
+            void* handle = mTreeModel->getChild(parent->node, index);
+            int children = mTreeModel->getNumberOfChildren(handle);
+
+            if (children <= 0)
+            {
+                return;
+            }
+
+            ExpandedNode* node = new ExpandedNode;
+            node->node = handle;
+            node->parent = parent;
+            node->index = index;
+            node->level = parent->level + 1;
+            node->descendants = 0;
+
+            parent->children[index] = node;
+            mExpandedNodes[handle] = node;
+            addDescendants(node, children);
+
+            if (mSelected > row)
+            {
+                mSelected += children;
+            }
+        }
+        else if (!expanded && iter != parent->children.end())
+        {
+            ExpandedNode* node = iter->second;
+            int rows = node->descendants;
+
+            addDescendants(node, -rows);
+            clearChildren(node);
+            mExpandedNodes.erase(node->node);
+            parent->children.erase(iter);
+            delete node;
+
+            if (mSelected > row + rows)
+            {
+                mSelected -= rows;
+            }
+            else if (mSelected > row)
+            {
+                setSelected(row);
+            }
+        }
+
+        adjustSize();
+        requestRedraw();
+    }
+
+    bool TreeView::isExpanded(int row) const
+    {
+        ExpandedNode* parent;
+        int index;
+
+        if (!findRow(row, parent, index))
+        {
+            return false;
+        }
+
+        return parent->children.find(index) != parent->children.end();
+    }
+
+    int TreeView::getSelected() const
+    {
+        return mSelected;
+    }
+
+    void TreeView::setSelected(int selected)
+    {
+        if (selected < 0)
+        {
+            mSelected = -1;
+        }
+        else if (selected >= mRoot.descendants)
+        {
+            mSelected = mRoot.descendants - 1;
+        }
+        else
+        {
+            mSelected = selected;
+        }
+
+        if (mSelected >= 0)
+        {
+            Rectangle scroll;
+            scroll.y = getRowHeight() * mSelected;
+            scroll.height = getRowHeight();
+            showPart(scroll);
+        }
+
+        distributeValueChangedEvent();
+    }
+
+    void* TreeView::getSelectedNode() const
+    {
+        return getNodeAt(mSelected);
+    }
+
+    void TreeView::setIndentation(int indentation)
+    {
+        mIndentation = indentation;
+        requestRedraw();
+    }
+
+    int TreeView::getIndentation() const
+    {
+        return mIndentation;
+    }
+
+    unsigned int TreeView::getRowHeight() const
+    {
+        return getFont()->getHeight();
+    }
+
+    void TreeView::addSelectionListener(SelectionListener* selectionListener)
+    {
+        mSelectionListeners.push_back(selectionListener);
+    }
+
+    void TreeView::removeSelectionListener(SelectionListener* selectionListener)
+    {
+        mSelectionListeners.remove(selectionListener);
+    }
+
+    void TreeView::resizeToContent(bool recursiv)
+    {
+        adjustSize();
+    }
+
+    void TreeView::adjustSize()
+    {
+        setHeight(getRowHeight() * mRoot.descendants);
+    }
+
+    void TreeView::draw(Graphics* graphics)
+    {
+        graphics->setColor(getBackgroundColor());
+        graphics->fillRectangle(0, 0, getWidth(), getHeight());
+
+        if (mTreeModel == NULL)
+        {
+            return;
+        }
+
+        graphics->setFont(getFont());
+
+        // Only draw the rows inside the current clip area. The clip area
+        // is in screen coordinates, its offset is where the tree view is
+        // on the screen.
+        const ClipRectangle& clipArea = graphics->getCurrentClipArea();
+        int rowHeight = getRowHeight();
+        int top = clipArea.y - clipArea.yOffset;
+        int bottom = top + clipArea.height;
+
+        int startRow = top > 0 ? top / rowHeight : 0;
+        int endRow = bottom > 0 ? bottom / rowHeight + 1 : 0;
+
+        if (endRow > mRoot.descendants)
+        {
+            endRow = mRoot.descendants;
+        }
+
+        for (int row = startRow; row < endRow; ++row)
+        {
+            ExpandedNode* parent;
+            int index;
+
+            if (!findRow(row, parent, index))
+            {
+                break;
+            }
+
+            void* node = mTreeModel->getChild(parent->node, index);
+            int x = parent->level * mIndentation;
+            int y = row * rowHeight;
+
+            if (row == mSelected)
+            {
+                graphics->setColor(getSelectionColor());
+                graphics->fillRectangle(0, y, getWidth(), rowHeight);
+            }
+
+            if (mTreeModel->hasChildren(node))
+            {
+                drawExpander(graphics, x, y, parent->children.find(index) != parent->children.end());
+            }
+
+            graphics->setColor(getForegroundColor());
+            graphics->drawText(mTreeModel->getNodeText(node), x + mIndentation, y);
+        }
+    }
+
+    void TreeView::drawExpander(Graphics* graphics, int x, int y, bool expanded)
+    {
+        int size = std::min(mIndentation, (int)getRowHeight()) - 4;
+
+        if (size < 3)
+        {
+            return;
+        }
+
+        // Keep the box odd sized so the sign is centered.
+        size -= 1 - size % 2;
+
+        int boxX = x + (mIndentation - size) / 2;
+        int boxY = y + ((int)getRowHeight() - size) / 2;
+        int center = size / 2;
+
+        graphics->setColor(getForegroundColor());
+        graphics->drawRectangle(boxX, boxY, size, size);
+        graphics->drawLine(boxX + 2, boxY + center, boxX + size - 3, boxY + center);
+
+        if (!expanded)
+        {
+            graphics->drawLine(boxX + center, boxY + 2, boxX + center, boxY + size - 3);
+        }
+    }
+
+    void TreeView::logic()
+    {
+        adjustSize();
+    }
+
+    void TreeView::keyPressed(KeyEvent& keyEvent)
+    {
+        if (mTreeModel == NULL)
+        {
+            return;
+        }
+
+        Key key = keyEvent.getKey();
+
+        if (key.getValue() == Key::Enter || key.getValue() == Key::Space)
+        {
+            distributeActionEvent();
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Up)
+        {
+            setSelected(std::max(mSelected - 1, 0));
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Down)
+        {
+            setSelected(mSelected + 1);
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Home)
+        {
+            setSelected(0);
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::End)
+        {
+            setSelected(mRoot.descendants - 1);
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Right && mSelected >= 0)
+        {
+            // Expand the node, or move to its first child if it is
+            // already expanded.
+            if (isExpanded(mSelected))
+            {
+                setSelected(mSelected + 1);
+            }
+            else
+            {
+                setExpanded(mSelected, true);
+            }
+
+            keyEvent.consume();
+        }
+        else if (key.getValue() == Key::Left && mSelected >= 0)
+        {
+            // Collapse the node, or move to its parent if it is already
+            // collapsed.
+            if (isExpanded(mSelected))
+            {
+                setExpanded(mSelected, false);
+            }
+            else
+            {
+                ExpandedNode* parent;
+                int index;
+
+                if (findRow(mSelected, parent, index) && parent != &mRoot)
+                {
+                    setSelected(getRowOf(parent));
+                }
+            }
+
+            keyEvent.consume();
+        }
+    }
+
+    void TreeView::mousePressed(MouseEvent& mouseEvent)
+    {
+        if (mouseEvent.getButton() != MouseEvent::Left)
+        {
+            return;
+        }
+
+        int row = getRowAt(mouseEvent.getY());
+        int level = getLevel(row);
+
+        if (level < 0)
+        {
+            return;
+        }
+
+        // A click on the expander toggles the node.
+        if (mouseEvent.getX() >= level * mIndentation
+            && mouseEvent.getX() < (level + 1) * mIndentation)
+        {
+            setExpanded(row, !isExpanded(row));
+        }
+        else
+        {
+            setSelected(row);
+            distributeActionEvent();
+        }
+    }
+
+    void TreeView::mouseDragged(MouseEvent& mouseEvent)
+    {
+        mouseEvent.consume();
+    }
+
+    void TreeView::childrenChanged(TreeModel* model, void* node)
+    {
+        if (model != mTreeModel)
+        {
+            return;
+        }
+
+        ExpandedNode* expandedNode = &mRoot;
+
+        if (node != NULL)
+        {
+            std::map<void*, ExpandedNode*>::iterator iter = mExpandedNodes.find(node);
+
+            // Collapsed nodes are read when they are expanded.
+            if (iter == mExpandedNodes.end())
+            {
+                return;
+            }
+
+            expandedNode = iter->second;
+        }
+
+        int row = getRowOf(expandedNode);
+        int rows = expandedNode->descendants;
+
+        clearChildren(expandedNode);
+        addDescendants(expandedNode, mTreeModel->getNumberOfChildren(node) - rows);
+
+        if (mSelected > row + rows)
+        {
+            mSelected += expandedNode->descendants - rows;
+        }
+        else if (mSelected > row)
+        {
+            setSelected(row);
+        }
+
+        adjustSize();
+        requestRedraw();
+    }
+
+    void TreeView::treeModelDeleted(TreeModel* model)
+    {
+        if (model != mTreeModel)
+        {
+            return;
+        }
+
+        mTreeModel = NULL;
+        reset();
+    }
+
+    bool TreeView::findRow(int row, ExpandedNode*& parent, int& index) const
+    {
+        if (mTreeModel == NULL || row < 0 || row >= mRoot.descendants)
+        {
+            return false;
+        }
+
+        const ExpandedNode* node = &mRoot;
+
+        while (true)
+        {
+            // Rows taken by the descendants of expanded children before
+            // the row.
+            int skipped = 0;
+            const ExpandedNode* child = NULL;
+
+            std::map<int, ExpandedNode*>::const_iterator iter;
+            for (iter = node->children.begin(); iter != node->children.end(); ++iter)
+            {
+                int childRow = iter->first + skipped;
+
+                if (row <= childRow)
+                {
+                    break;
+                }
+
+                if (row <= childRow + iter->second->descendants)
+                {
+                    row -= childRow + 1;
+                    child = iter->second;
+                    break;
+                }
+
+                skipped += iter->second->descendants;
+            }
+
+            if (child == NULL)
+            {
+                parent = const_cast<ExpandedNode*>(node);
+                index = row - skipped;
+                return true;
+            }
+
+            node = child;
+        }
+    }
+
+    int TreeView::getRowOf(const ExpandedNode* node) const
+    {
+        if (node->parent == NULL)
+        {
+            return -1;
+        }
+
+        const ExpandedNode* parent = node->parent;
+        int row = getRowOf(parent) + 1 + node->index;
+
+        std::map<int, ExpandedNode*>::const_iterator iter;
+        for (iter = parent->children.begin(); iter->first < node->index; ++iter)
+        {
+            row += iter->second->descendants;
+        }
+
+        return row;
+    }
+
+    void TreeView::addDescendants(ExpandedNode* node, int rows)
+    {
+        for (; node != NULL; node = node->parent)
+        {
+            node->descendants += rows;
+        }
+    }
+
+    void TreeView::clearChildren(ExpandedNode* node)
+    {
+        std::map<int, ExpandedNode*>::iterator iter;
+        for (iter = node->children.begin(); iter != node->children.end(); ++iter)
+        {
+            clearChildren(iter->second);
+            mExpandedNodes.erase(iter->second->node);
+            delete iter->second;
+        }
+
+        node->children.clear();
+    }
+
+    void TreeView::reset()
+    {
+        clearChildren(&mRoot);
+        mRoot.descendants = mTreeModel != NULL ? mTreeModel->getNumberOfChildren(NULL) : 0;
+        mSelected = -1;
+        adjustSize();
+        requestRedraw();
+    }
+
+    void TreeView::distributeValueChangedEvent()
+    {
+        requestRedraw();
+
+        SelectionListenerIterator iter;
+
+        for (iter = mSelectionListeners.begin(); iter != mSelectionListeners.end(); ++iter)
+        {
+            SelectionEvent event(this);
+            (*iter)->valueChanged(event);
+        }
+    }
+}